@@ -1,6 +1,7 @@
 #include "simulator.h"
 #include "cache.h"
 #include "log.h"
+#include "config.hpp"
 
 // Cache class
 // constructors/destructors
@@ -24,11 +25,14 @@ Cache::Cache(
    m_cache_type(cache_type),
    m_fault_injector(fault_injector)
 {
+   // Flat tag arrays can be enabled for all caches (perf_model/cache/flat_tags) or per cache (<cfgname>/flat_tags)
+   bool flat_tags = Sim()->getCfg()->getBoolDefault(cfgname + "/flat_tags", Sim()->getCfg()->getBool("perf_model/cache/flat_tags"));
+
    m_set_info = CacheSet::createCacheSetInfo(name, cfgname, core_id, replacement_policy, m_associativity);
    m_sets = new CacheSet*[m_num_sets];
    for (UInt32 i = 0; i < m_num_sets; i++)
    {
-      m_sets[i] = CacheSet::createCacheSet(cfgname, core_id, replacement_policy, m_cache_type, m_associativity, m_blocksize, m_set_info);
+      m_sets[i] = CacheSet::createCacheSet(cfgname, core_id, replacement_policy, m_cache_type, m_associativity, m_blocksize, m_set_info, flat_tags);
    }
 
    #ifdef ENABLE_SET_USAGE_HIST
@@ -82,7 +86,7 @@ Cache::invalidateSingleLine(IntPtr addr)
 
 CacheBlockInfo*
 Cache::accessSingleLine(IntPtr addr, access_t access_type,
-      Byte* buff, UInt32 bytes, SubsecondTime now, bool update_replacement)
+      Byte* buff, UInt32 bytes, SubsecondTime now, bool update_replacement, CacheCntlr *cntlr)
 {
    //assert((buff == NULL) == (bytes == 0));
 
@@ -105,11 +109,11 @@ Cache::accessSingleLine(IntPtr addr, access_t access_type,
       if (m_fault_injector)
          m_fault_injector->preRead(addr, set_index * m_associativity + line_index, bytes, (Byte*)m_sets[set_index]->getDataPtr(line_index, block_offset), now);
 
-      set->read_line(line_index, block_offset, buff, bytes, update_replacement);
+      set->read_line(line_index, block_offset, buff, bytes, update_replacement, cntlr);
    }
    else
    {
-      set->write_line(line_index, block_offset, buff, bytes, update_replacement);
+      set->write_line(line_index, block_offset, buff, bytes, update_replacement, cntlr);
 
       // NOTE: assumes error occurs in memory. If we want to model bus errors, insert the error into buff instead
       if (m_fault_injector)
@@ -60,6 +60,9 @@ class CacheBase
          SRRIP,
          SRRIP_QBS,
          RANDOM,
+         DRRIP,
+         SHIP,
+         HAWKEYE,
          NUM_REPLACEMENT_POLICIES
       };
 
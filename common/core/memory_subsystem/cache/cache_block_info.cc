@@ -4,6 +4,8 @@
 #include "shared_cache_block_info.h"
 #include "log.h"
 
+#include <new>
+
 const char* CacheBlockInfo::option_names[] =
 {
    "prefetch",
@@ -52,6 +54,46 @@ CacheBlockInfo::create(CacheBase::cache_t cache_type)
    }
 }
 
+CacheBlockInfo*
+CacheBlockInfo::create(CacheBase::cache_t cache_type, void *storage)
+{
+   switch (cache_type)
+   {
+      case CacheBase::PR_L1_CACHE:
+         return new (storage) PrL1CacheBlockInfo();
+
+      case CacheBase::PR_L2_CACHE:
+         return new (storage) PrL2CacheBlockInfo();
+
+      case CacheBase::SHARED_CACHE:
+         return new (storage) SharedCacheBlockInfo();
+
+      default:
+         LOG_PRINT_ERROR("Unrecognized cache type (%u)", cache_type);
+         return NULL;
+   }
+}
+
+size_t
+CacheBlockInfo::getSize(CacheBase::cache_t cache_type)
+{
+   switch (cache_type)
+   {
+      case CacheBase::PR_L1_CACHE:
+         return sizeof(PrL1CacheBlockInfo);
+
+      case CacheBase::PR_L2_CACHE:
+         return sizeof(PrL2CacheBlockInfo);
+
+      case CacheBase::SHARED_CACHE:
+         return sizeof(SharedCacheBlockInfo);
+
+      default:
+         LOG_PRINT_ERROR("Unrecognized cache type (%u)", cache_type);
+         return 0;
+   }
+}
+
 void
 CacheBlockInfo::invalidate()
 {
@@ -36,6 +36,9 @@ class CacheBlockInfo
       virtual ~CacheBlockInfo();
 
       static CacheBlockInfo* create(CacheBase::cache_t cache_type);
+      // Construct in caller-provided storage of at least getSize(cache_type) bytes
+      static CacheBlockInfo* create(CacheBase::cache_t cache_type, void *storage);
+      static size_t getSize(CacheBase::cache_t cache_type);
 
       virtual void invalidate(void);
       virtual void clone(CacheBlockInfo* cache_block_info);
@@ -67,6 +70,8 @@ class CacheCntlr
    public:
       virtual bool isInLowerLevelCache(CacheBlockInfo *block_info) { return false; }
       virtual void incrementQBSLookupCost() {}
+      // PC of the instruction on whose behalf the current access is made, 0 if unknown (e.g. prefetches)
+      virtual IntPtr getAccessEip() { return 0; }
 };
 
 #endif /* __CACHE_BLOCK_INFO_H__ */
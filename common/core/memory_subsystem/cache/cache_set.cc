@@ -7,6 +7,9 @@
 #include "cache_set_random.h"
 #include "cache_set_round_robin.h"
 #include "cache_set_srrip.h"
+#include "cache_set_drrip.h"
+#include "cache_set_ship.h"
+#include "cache_set_hawkeye.h"
 #include "cache_base.h"
 #include "log.h"
 #include "simulator.h"
@@ -14,13 +17,28 @@
 #include "config.hpp"
 
 CacheSet::CacheSet(CacheBase::cache_t cache_type,
-      UInt32 associativity, UInt32 blocksize):
+      UInt32 associativity, UInt32 blocksize, bool flat_tags):
+      m_tags(NULL), m_block_storage(NULL),
       m_associativity(associativity), m_blocksize(blocksize)
 {
    m_cache_block_info_array = new CacheBlockInfo*[m_associativity];
-   for (UInt32 i = 0; i < m_associativity; i++)
+   if (flat_tags)
    {
-      m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type);
+      size_t block_size = CacheBlockInfo::getSize(cache_type);
+      m_tags = new IntPtr[m_associativity];
+      m_block_storage = new char[m_associativity * block_size];
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type, m_block_storage + i * block_size);
+         m_tags[i] = m_cache_block_info_array[i]->getTag();
+      }
+   }
+   else
+   {
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type);
+      }
    }
 
    if (Sim()->getFaultinjectionManager())
@@ -34,14 +52,24 @@ CacheSet::CacheSet(CacheBase::cache_t cache_type,
 
 CacheSet::~CacheSet()
 {
-   for (UInt32 i = 0; i < m_associativity; i++)
-      delete m_cache_block_info_array[i];
+   if (m_block_storage)
+   {
+      for (UInt32 i = 0; i < m_associativity; i++)
+         m_cache_block_info_array[i]->~CacheBlockInfo();
+      delete [] m_block_storage;
+      delete [] m_tags;
+   }
+   else
+   {
+      for (UInt32 i = 0; i < m_associativity; i++)
+         delete m_cache_block_info_array[i];
+   }
    delete [] m_cache_block_info_array;
    delete [] m_blocks;
 }
 
 void
-CacheSet::read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 bytes, bool update_replacement)
+CacheSet::read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 bytes, bool update_replacement, CacheCntlr *cntlr)
 {
    assert(offset + bytes <= m_blocksize);
    //assert((out_buff == NULL) == (bytes == 0));
@@ -50,11 +78,11 @@ CacheSet::read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 byt
       memcpy((void*) out_buff, &m_blocks[line_index * m_blocksize + offset], bytes);
 
    if (update_replacement)
-      updateReplacementIndex(line_index);
+      updateReplacementIndexOnAccess(line_index, cntlr);
 }
 
 void
-CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 bytes, bool update_replacement)
+CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 bytes, bool update_replacement, CacheCntlr *cntlr)
 {
    assert(offset + bytes <= m_blocksize);
    //assert((in_buff == NULL) == (bytes == 0));
@@ -63,12 +91,33 @@ CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 byt
       memcpy(&m_blocks[line_index * m_blocksize + offset], (void*) in_buff, bytes);
 
    if (update_replacement)
-      updateReplacementIndex(line_index);
+      updateReplacementIndexOnAccess(line_index, cntlr);
+}
+
+SInt32
+CacheSet::findFlat(IntPtr tag) const
+{
+   // Branch-free scan over the contiguous tag array, which the compiler can vectorize.
+   // Returns the highest matching way, like the pointer-based scan below.
+   SInt32 found = -1;
+   for (UInt32 index = 0; index < m_associativity; index++)
+      found = m_tags[index] == tag ? SInt32(index) : found;
+   return found;
 }
 
 CacheBlockInfo*
 CacheSet::find(IntPtr tag, UInt32* line_index)
 {
+   if (m_tags)
+   {
+      SInt32 index = findFlat(tag);
+      if (index < 0)
+         return NULL;
+      if (line_index != NULL)
+         *line_index = index;
+      return m_cache_block_info_array[index];
+   }
+
    for (SInt32 index = m_associativity-1; index >= 0; index--)
    {
       if (m_cache_block_info_array[index]->getTag() == tag)
@@ -84,6 +133,16 @@ CacheSet::find(IntPtr tag, UInt32* line_index)
 bool
 CacheSet::invalidate(IntPtr& tag)
 {
+   if (m_tags)
+   {
+      SInt32 index = findFlat(tag);
+      if (index < 0)
+         return false;
+      m_cache_block_info_array[index]->invalidate();
+      m_tags[index] = ~0;
+      return true;
+   }
+
    for (SInt32 index = m_associativity-1; index >= 0; index--)
    {
       if (m_cache_block_info_array[index]->getTag() == tag)
@@ -120,9 +179,13 @@ CacheSet::insert(CacheBlockInfo* cache_block_info, Byte* fill_buff, bool* evicti
 
    // FIXME: This is a hack. I dont know if this is the best way to do
    m_cache_block_info_array[index]->clone(cache_block_info);
+   if (m_tags)
+      m_tags[index] = cache_block_info->getTag();
 
    if (fill_buff != NULL && m_blocks != NULL)
       memcpy(&m_blocks[index * m_blocksize], (void*) fill_buff, m_blocksize);
+
+   updateReplacementIndexOnInsert(index, cntlr);
 }
 
 char*
@@ -135,36 +198,45 @@ CacheSet*
 CacheSet::createCacheSet(String cfgname, core_id_t core_id,
       String replacement_policy,
       CacheBase::cache_t cache_type,
-      UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info)
+      UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info, bool flat_tags)
 {
    CacheBase::ReplacementPolicy policy = parsePolicyType(replacement_policy);
    switch(policy)
    {
       case CacheBase::ROUND_ROBIN:
-         return new CacheSetRoundRobin(cache_type, associativity, blocksize);
+         return new CacheSetRoundRobin(cache_type, associativity, blocksize, flat_tags);
 
       case CacheBase::LRU:
       case CacheBase::LRU_QBS:
-         return new CacheSetLRU(cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
+         return new CacheSetLRU(cache_type, associativity, blocksize, flat_tags, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
 
       case CacheBase::NRU:
-         return new CacheSetNRU(cache_type, associativity, blocksize);
+         return new CacheSetNRU(cache_type, associativity, blocksize, flat_tags);
 
       case CacheBase::MRU:
-         return new CacheSetMRU(cache_type, associativity, blocksize);
+         return new CacheSetMRU(cache_type, associativity, blocksize, flat_tags);
 
       case CacheBase::NMRU:
-         return new CacheSetNMRU(cache_type, associativity, blocksize);
+         return new CacheSetNMRU(cache_type, associativity, blocksize, flat_tags);
 
       case CacheBase::PLRU:
-         return new CacheSetPLRU(cache_type, associativity, blocksize);
+         return new CacheSetPLRU(cache_type, associativity, blocksize, flat_tags);
 
       case CacheBase::SRRIP:
       case CacheBase::SRRIP_QBS:
-         return new CacheSetSRRIP(cfgname, core_id, cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
+         return new CacheSetSRRIP(cfgname, core_id, cache_type, associativity, blocksize, flat_tags, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
 
       case CacheBase::RANDOM:
-         return new CacheSetRandom(cache_type, associativity, blocksize);
+         return new CacheSetRandom(cache_type, associativity, blocksize, flat_tags);
+
+      case CacheBase::DRRIP:
+         return new CacheSetDRRIP(cache_type, associativity, blocksize, flat_tags, dynamic_cast<CacheSetInfoDRRIP*>(set_info));
+
+      case CacheBase::SHIP:
+         return new CacheSetSHiP(cache_type, associativity, blocksize, flat_tags, dynamic_cast<CacheSetInfoSHiP*>(set_info));
+
+      case CacheBase::HAWKEYE:
+         return new CacheSetHawkeye(cache_type, associativity, blocksize, flat_tags, dynamic_cast<CacheSetInfoHawkeye*>(set_info));
 
       default:
          LOG_PRINT_ERROR("Unrecognized Cache Replacement Policy: %i",
@@ -186,6 +258,12 @@ CacheSet::createCacheSetInfo(String name, String cfgname, core_id_t core_id, Str
       case CacheBase::SRRIP:
       case CacheBase::SRRIP_QBS:
          return new CacheSetInfoLRU(name, cfgname, core_id, associativity, getNumQBSAttempts(policy, cfgname, core_id));
+      case CacheBase::DRRIP:
+         return new CacheSetInfoDRRIP(name, cfgname, core_id);
+      case CacheBase::SHIP:
+         return new CacheSetInfoSHiP(name, cfgname, core_id);
+      case CacheBase::HAWKEYE:
+         return new CacheSetInfoHawkeye(name, cfgname, core_id, associativity);
       default:
          return NULL;
    }
@@ -227,6 +305,12 @@ CacheSet::parsePolicyType(String policy)
       return CacheBase::SRRIP_QBS;
    if (policy == "random")
       return CacheBase::RANDOM;
+   if (policy == "drrip")
+      return CacheBase::DRRIP;
+   if (policy == "ship")
+      return CacheBase::SHIP;
+   if (policy == "hawkeye")
+      return CacheBase::HAWKEYE;
 
    LOG_PRINT_ERROR("Unknown replacement policy %s", policy.c_str());
 }
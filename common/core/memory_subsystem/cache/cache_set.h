@@ -23,30 +23,38 @@ class CacheSet
 {
    public:
 
-      static CacheSet* createCacheSet(String cfgname, core_id_t core_id, String replacement_policy, CacheBase::cache_t cache_type, UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info = NULL);
+      static CacheSet* createCacheSet(String cfgname, core_id_t core_id, String replacement_policy, CacheBase::cache_t cache_type, UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info = NULL, bool flat_tags = false);
       static CacheSetInfo* createCacheSetInfo(String name, String cfgname, core_id_t core_id, String replacement_policy, UInt32 associativity);
       static CacheBase::ReplacementPolicy parsePolicyType(String policy);
       static UInt8 getNumQBSAttempts(CacheBase::ReplacementPolicy, String cfgname, core_id_t core_id);
 
    protected:
       CacheBlockInfo** m_cache_block_info_array;
+      // Flat layout: a copy of the tags of all ways in one contiguous array (~0 marks an invalid way) for lookups,
+      // block objects allocated back to back in m_block_storage. NULL otherwise.
+      // The copy is updated by insert() and invalidate(), so blocks must not be retagged or invalidated directly.
+      IntPtr* m_tags;
+      char* m_block_storage;
       char* m_blocks;
       UInt32 m_associativity;
       UInt32 m_blocksize;
       Lock m_lock;
 
+   private:
+      SInt32 findFlat(IntPtr tag) const;
+
    public:
 
       CacheSet(CacheBase::cache_t cache_type,
-            UInt32 associativity, UInt32 blocksize);
+            UInt32 associativity, UInt32 blocksize, bool flat_tags);
       virtual ~CacheSet();
 
       UInt32 getBlockSize() { return m_blocksize; }
       UInt32 getAssociativity() { return m_associativity; }
       Lock& getLock() { return m_lock; }
 
-      void read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 bytes, bool update_replacement);
-      void write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 bytes, bool update_replacement);
+      void read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 bytes, bool update_replacement, CacheCntlr *cntlr = NULL);
+      void write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 bytes, bool update_replacement, CacheCntlr *cntlr = NULL);
       CacheBlockInfo* find(IntPtr tag, UInt32* line_index = NULL);
       bool invalidate(IntPtr& tag);
       void insert(CacheBlockInfo* cache_block_info, Byte* fill_buff, bool* eviction, CacheBlockInfo* evict_block_info, Byte* evict_buff, CacheCntlr *cntlr = NULL);
@@ -58,6 +66,9 @@ class CacheSet
 
       virtual UInt32 getReplacementIndex(CacheCntlr *cntlr) = 0;
       virtual void updateReplacementIndex(UInt32) = 0;
+      // Policies that need the requesting controller (e.g. for the access PC) override these
+      virtual void updateReplacementIndexOnAccess(UInt32 accessed_index, CacheCntlr *cntlr) { updateReplacementIndex(accessed_index); }
+      virtual void updateReplacementIndexOnInsert(UInt32 inserted_index, CacheCntlr *cntlr) {}
 
       bool isValidReplacement(UInt32 index);
 };
@@ -0,0 +1,151 @@
+#include "cache_set_drrip.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+#include "stats.h"
+
+// DRRIP: Dynamic Re-reference Interval Prediction [Jaleel et al., ISCA'10]
+// Chooses between SRRIP insertion (long re-reference interval) and BRRIP insertion (distant,
+// only occasionally long) using set dueling
+
+CacheSetInfoDRRIP::CacheSetInfoDRRIP(String name, String cfgname, core_id_t core_id)
+   : m_rrip_numbits(Sim()->getCfg()->getInt("perf_model/cache/drrip/bits"))
+   // One SRRIP and one BRRIP leader set every leader_period sets
+   , m_leader_period(Sim()->getCfg()->getInt("perf_model/cache/drrip/leader_period"))
+   // BRRIP inserts with a long re-reference interval once every brrip_long_period fills
+   , m_brrip_long_period(Sim()->getCfg()->getInt("perf_model/cache/drrip/brrip_long_period"))
+   , m_psel_max((1 << Sim()->getCfg()->getInt("perf_model/cache/drrip/psel_bits")) - 1)
+   , m_psel(m_psel_max / 2)
+   , m_num_sets(0)
+   , m_brrip_fills(0)
+   , m_leader_misses_srrip(0)
+   , m_leader_misses_brrip(0)
+   , m_follower_inserts_srrip(0)
+   , m_follower_inserts_brrip(0)
+{
+   LOG_ASSERT_ERROR(m_rrip_numbits > 0 && m_rrip_numbits < 8, "perf_model/cache/drrip/bits must be between 1 and 7");
+   LOG_ASSERT_ERROR(m_leader_period >= 2, "perf_model/cache/drrip/leader_period must be >= 2");
+
+   registerStatsMetric(name, core_id, "drrip-leader-misses-srrip", &m_leader_misses_srrip);
+   registerStatsMetric(name, core_id, "drrip-leader-misses-brrip", &m_leader_misses_brrip);
+   registerStatsMetric(name, core_id, "drrip-follower-inserts-srrip", &m_follower_inserts_srrip);
+   registerStatsMetric(name, core_id, "drrip-follower-inserts-brrip", &m_follower_inserts_brrip);
+   registerStatsMetric(name, core_id, "drrip-psel", &m_psel);
+}
+
+CacheSetInfoDRRIP::set_role_t
+CacheSetInfoDRRIP::assignRole()
+{
+   UInt32 index = m_num_sets++ % m_leader_period;
+   if (index == 0)
+      return LEADER_SRRIP;
+   else if (index == m_leader_period / 2)
+      return LEADER_BRRIP;
+   else
+      return FOLLOWER;
+}
+
+bool
+CacheSetInfoDRRIP::insertDistant(set_role_t role)
+{
+   bool brrip;
+   if (role == FOLLOWER)
+   {
+      // PSEL counts up on SRRIP leader misses: past the midpoint, BRRIP is doing better
+      brrip = m_psel > m_psel_max / 2;
+      if (brrip)
+         ++m_follower_inserts_brrip;
+      else
+         ++m_follower_inserts_srrip;
+   }
+   else
+      brrip = role == LEADER_BRRIP;
+
+   if (!brrip)
+      return false;
+   return ++m_brrip_fills % m_brrip_long_period != 0;
+}
+
+void
+CacheSetInfoDRRIP::miss(set_role_t role)
+{
+   if (role == LEADER_SRRIP)
+   {
+      ++m_leader_misses_srrip;
+      if (m_psel < m_psel_max)
+         ++m_psel;
+   }
+   else if (role == LEADER_BRRIP)
+   {
+      ++m_leader_misses_brrip;
+      if (m_psel > 0)
+         --m_psel;
+   }
+}
+
+
+CacheSetDRRIP::CacheSetDRRIP(
+      CacheBase::cache_t cache_type,
+      UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoDRRIP* set_info)
+   : CacheSet(cache_type, associativity, blocksize, flat_tags)
+   , m_set_info(set_info)
+   , m_role(set_info->assignRole())
+   , m_rrip_max((1 << set_info->getNumBits()) - 1)
+   , m_replacement_pointer(0)
+{
+   m_rrip_bits = new UInt8[m_associativity];
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_rrip_bits[i] = m_rrip_max;
+}
+
+CacheSetDRRIP::~CacheSetDRRIP()
+{
+   delete [] m_rrip_bits;
+}
+
+UInt32
+CacheSetDRRIP::getReplacementIndex(CacheCntlr *cntlr)
+{
+   // A fill is a miss in this set
+   m_set_info->miss(m_role);
+   UInt8 insert = m_set_info->insertDistant(m_role) ? m_rrip_max : m_rrip_max - 1;
+
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      if (!m_cache_block_info_array[i]->isValid())
+      {
+         m_rrip_bits[i] = insert;
+         return i;
+      }
+   }
+
+   for(UInt32 j = 0; j <= m_rrip_max; ++j)
+   {
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         UInt32 index = m_replacement_pointer;
+         m_replacement_pointer = (m_replacement_pointer + 1) % m_associativity;
+         if (m_rrip_bits[index] >= m_rrip_max && isValidReplacement(index))
+         {
+            m_rrip_bits[index] = insert;
+            return index;
+         }
+      }
+
+      // Increment all RRIP counters until one hits RRIP_MAX
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         if (m_rrip_bits[i] < m_rrip_max)
+            m_rrip_bits[i]++;
+      }
+   }
+
+   LOG_PRINT_ERROR("Error finding replacement index");
+}
+
+void
+CacheSetDRRIP::updateReplacementIndex(UInt32 accessed_index)
+{
+   // Hit priority: a re-referenced line is predicted to be re-referenced again soon
+   m_rrip_bits[accessed_index] = 0;
+}
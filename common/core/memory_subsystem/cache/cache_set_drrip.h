@@ -0,0 +1,61 @@
+#ifndef CACHE_SET_DRRIP_H
+#define CACHE_SET_DRRIP_H
+
+#include "cache_set.h"
+
+// Per-cache set dueling state: a few leader sets always use SRRIP or BRRIP insertion,
+// their misses steer the policy selector (PSEL) that all follower sets use
+class CacheSetInfoDRRIP : public CacheSetInfo
+{
+   public:
+      enum set_role_t
+      {
+         FOLLOWER,
+         LEADER_SRRIP,
+         LEADER_BRRIP,
+      };
+
+      CacheSetInfoDRRIP(String name, String cfgname, core_id_t core_id);
+      virtual ~CacheSetInfoDRRIP() {}
+
+      UInt8 getNumBits() const { return m_rrip_numbits; }
+      // Sets are assigned roles in order of creation
+      set_role_t assignRole();
+      // Returns true when the new line should be inserted with a distant re-reference prediction (BRRIP)
+      bool insertDistant(set_role_t role);
+      void miss(set_role_t role);
+
+   private:
+      const UInt8 m_rrip_numbits;
+      const UInt32 m_leader_period;
+      const UInt32 m_brrip_long_period;
+      const UInt64 m_psel_max;
+      UInt64 m_psel;
+      UInt32 m_num_sets;
+      UInt32 m_brrip_fills;
+
+      UInt64 m_leader_misses_srrip;
+      UInt64 m_leader_misses_brrip;
+      UInt64 m_follower_inserts_srrip;
+      UInt64 m_follower_inserts_brrip;
+};
+
+class CacheSetDRRIP : public CacheSet
+{
+   public:
+      CacheSetDRRIP(CacheBase::cache_t cache_type,
+            UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoDRRIP* set_info);
+      ~CacheSetDRRIP();
+
+      UInt32 getReplacementIndex(CacheCntlr *cntlr);
+      void updateReplacementIndex(UInt32 accessed_index);
+
+   private:
+      CacheSetInfoDRRIP* m_set_info;
+      const CacheSetInfoDRRIP::set_role_t m_role;
+      const UInt8 m_rrip_max;
+      UInt8* m_rrip_bits;
+      UInt8  m_replacement_pointer;
+};
+
+#endif /* CACHE_SET_DRRIP_H */
@@ -0,0 +1,223 @@
+#include "cache_set_hawkeye.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+#include "stats.h"
+
+// Hawkeye: learns from Belady's optimal policy [Jain and Lin, ISCA'16]
+// OPTgen reconstructs, for the accesses to sampled sets, whether OPT would have kept each line until its
+// next use. This trains a PC-indexed predictor. Lines inserted or hit by PCs predicted cache-friendly
+// get the highest priority, lines of cache-averse PCs are evicted first.
+
+CacheSetInfoHawkeye::CacheSetInfoHawkeye(String name, String cfgname, core_id_t core_id, UInt32 associativity)
+   : m_rrip_numbits(Sim()->getCfg()->getInt("perf_model/cache/hawkeye/bits"))
+   // One set in every sample_period sets is replayed through OPTgen
+   , m_sample_period(Sim()->getCfg()->getInt("perf_model/cache/hawkeye/sample_period"))
+   // OPTgen looks back this many accesses, as a multiple of the associativity
+   , m_history_length(Sim()->getCfg()->getInt("perf_model/cache/hawkeye/history") * associativity)
+   , m_predictor_size(Sim()->getCfg()->getInt("perf_model/cache/hawkeye/predictor_size"))
+   , m_predictor_max((1 << Sim()->getCfg()->getInt("perf_model/cache/hawkeye/predictor_bits")) - 1)
+   , m_num_sets(0)
+   , m_optgen_hits(0)
+   , m_optgen_misses(0)
+   , m_predictions_correct(0)
+   , m_predictions_incorrect(0)
+   , m_friendly_evictions(0)
+{
+   LOG_ASSERT_ERROR(m_rrip_numbits > 1 && m_rrip_numbits < 8, "perf_model/cache/hawkeye/bits must be between 2 and 7");
+   LOG_ASSERT_ERROR(m_sample_period > 0, "perf_model/cache/hawkeye/sample_period must be > 0");
+   LOG_ASSERT_ERROR(m_history_length > 0, "perf_model/cache/hawkeye/history must be > 0");
+   LOG_ASSERT_ERROR(m_predictor_size > 0, "perf_model/cache/hawkeye/predictor_size must be > 0");
+
+   // Start out weakly cache-friendly
+   m_predictor = new UInt8[m_predictor_size];
+   for (UInt32 i = 0; i < m_predictor_size; i++)
+      m_predictor[i] = m_predictor_max / 2 + 1;
+
+   registerStatsMetric(name, core_id, "hawkeye-optgen-hits", &m_optgen_hits);
+   registerStatsMetric(name, core_id, "hawkeye-optgen-misses", &m_optgen_misses);
+   registerStatsMetric(name, core_id, "hawkeye-predictions-correct", &m_predictions_correct);
+   registerStatsMetric(name, core_id, "hawkeye-predictions-incorrect", &m_predictions_incorrect);
+   registerStatsMetric(name, core_id, "hawkeye-friendly-evictions", &m_friendly_evictions);
+}
+
+CacheSetInfoHawkeye::~CacheSetInfoHawkeye()
+{
+   delete [] m_predictor;
+}
+
+void
+CacheSetInfoHawkeye::train(UInt32 signature, bool opt_hit)
+{
+   if (predictFriendly(signature) == opt_hit)
+      ++m_predictions_correct;
+   else
+      ++m_predictions_incorrect;
+
+   if (opt_hit)
+   {
+      ++m_optgen_hits;
+      if (m_predictor[signature] < m_predictor_max)
+         ++m_predictor[signature];
+   }
+   else
+   {
+      ++m_optgen_misses;
+      if (m_predictor[signature] > 0)
+         --m_predictor[signature];
+   }
+}
+
+void
+CacheSetInfoHawkeye::detrain(UInt32 signature)
+{
+   ++m_friendly_evictions;
+   if (m_predictor[signature] > 0)
+      --m_predictor[signature];
+}
+
+
+CacheSetHawkeye::CacheSetHawkeye(
+      CacheBase::cache_t cache_type,
+      UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoHawkeye* set_info)
+   : CacheSet(cache_type, associativity, blocksize, flat_tags)
+   , m_set_info(set_info)
+   , m_rrip_max((1 << set_info->getNumBits()) - 1)
+   , m_optgen(NULL)
+{
+   m_rrip_bits = new UInt8[m_associativity];
+   m_signatures = new UInt32[m_associativity];
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      m_rrip_bits[i] = m_rrip_max;
+      m_signatures[i] = 0;
+   }
+
+   if (set_info->assignSampled())
+   {
+      HistoryEntry empty = { IntPtr(~0), 0, 0 };
+      m_optgen = new OptGen();
+      m_optgen->time = 0;
+      m_optgen->occupancy.resize(set_info->getHistoryLength(), 0);
+      m_optgen->history.resize(set_info->getHistoryLength(), empty);
+   }
+}
+
+CacheSetHawkeye::~CacheSetHawkeye()
+{
+   delete [] m_rrip_bits;
+   delete [] m_signatures;
+   delete m_optgen;
+}
+
+UInt32
+CacheSetHawkeye::getReplacementIndex(CacheCntlr *cntlr)
+{
+   UInt32 oldest = m_associativity;
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      if (!m_cache_block_info_array[i]->isValid())
+         return i;
+      if (!isValidReplacement(i))
+         continue;
+      // Prefer cache-averse lines
+      if (m_rrip_bits[i] == m_rrip_max)
+         return i;
+      if (oldest == m_associativity || m_rrip_bits[i] > m_rrip_bits[oldest])
+         oldest = i;
+   }
+
+   LOG_ASSERT_ERROR(oldest < m_associativity, "Error finding replacement index");
+   // No cache-averse lines: evict the oldest cache-friendly line, its PC was too optimistic
+   m_set_info->detrain(m_signatures[oldest]);
+   return oldest;
+}
+
+void
+CacheSetHawkeye::trainOptGen(IntPtr tag, UInt32 signature)
+{
+   OptGen &optgen = *m_optgen;
+   const UInt64 length = optgen.history.size();
+   const UInt64 now = optgen.time;
+
+   for (UInt64 i = 0; i < length; i++)
+   {
+      HistoryEntry &entry = optgen.history[i];
+      if (entry.tag != tag)
+         continue;
+
+      // OPT could have kept the line since its last use if the cache was never full in between
+      bool opt_hit = true;
+      for (UInt64 t = entry.time; t < now; t++)
+      {
+         if (optgen.occupancy[t % length] >= m_associativity)
+         {
+            opt_hit = false;
+            break;
+         }
+      }
+      if (opt_hit)
+      {
+         for (UInt64 t = entry.time; t < now; t++)
+            optgen.occupancy[t % length]++;
+      }
+      m_set_info->train(entry.signature, opt_hit);
+      entry.tag = ~0;
+      break;
+   }
+
+   // The oldest access falls out of the window: its line was not reused in time, so OPT would not keep it
+   HistoryEntry &slot = optgen.history[now % length];
+   if (slot.tag != IntPtr(~0))
+      m_set_info->train(slot.signature, false);
+
+   slot.tag = tag;
+   slot.time = now;
+   slot.signature = signature;
+   optgen.occupancy[now % length] = 0;
+   optgen.time++;
+}
+
+void
+CacheSetHawkeye::access(UInt32 index, CacheCntlr *cntlr, bool insert)
+{
+   UInt32 signature = m_set_info->getSignature(cntlr ? cntlr->getAccessEip() : 0);
+
+   if (m_optgen)
+      trainOptGen(m_cache_block_info_array[index]->getTag(), signature);
+
+   m_signatures[index] = signature;
+   if (m_set_info->predictFriendly(signature))
+   {
+      if (insert)
+      {
+         // Age the other cache-friendly lines, without making them cache-averse
+         for (UInt32 i = 0; i < m_associativity; i++)
+         {
+            if (i != index && m_rrip_bits[i] < m_rrip_max - 1)
+               m_rrip_bits[i]++;
+         }
+      }
+      m_rrip_bits[index] = 0;
+   }
+   else
+      m_rrip_bits[index] = m_rrip_max;
+}
+
+void
+CacheSetHawkeye::updateReplacementIndexOnInsert(UInt32 inserted_index, CacheCntlr *cntlr)
+{
+   access(inserted_index, cntlr, true);
+}
+
+void
+CacheSetHawkeye::updateReplacementIndexOnAccess(UInt32 accessed_index, CacheCntlr *cntlr)
+{
+   access(accessed_index, cntlr, false);
+}
+
+void
+CacheSetHawkeye::updateReplacementIndex(UInt32 accessed_index)
+{
+   access(accessed_index, NULL, false);
+}
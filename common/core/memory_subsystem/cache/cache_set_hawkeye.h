@@ -0,0 +1,82 @@
+#ifndef CACHE_SET_HAWKEYE_H
+#define CACHE_SET_HAWKEYE_H
+
+#include "cache_set.h"
+
+#include <vector>
+
+// Per-cache PC-indexed predictor, trained by replaying the accesses of a few sampled sets
+// through OPTgen, which computes what Belady's optimal policy would have done
+class CacheSetInfoHawkeye : public CacheSetInfo
+{
+   public:
+      CacheSetInfoHawkeye(String name, String cfgname, core_id_t core_id, UInt32 associativity);
+      virtual ~CacheSetInfoHawkeye();
+
+      UInt8 getNumBits() const { return m_rrip_numbits; }
+      UInt32 getHistoryLength() const { return m_history_length; }
+      // Sets are sampled in order of creation
+      bool assignSampled() { return m_num_sets++ % m_sample_period == 0; }
+
+      UInt32 getSignature(IntPtr eip) const { return (eip ^ (eip >> 12) ^ (eip >> 24)) % m_predictor_size; }
+      bool predictFriendly(UInt32 signature) const { return m_predictor[signature] > m_predictor_max / 2; }
+
+      // Outcome of OPT for the last access by signature: hit (cache-friendly) or miss (cache-averse)
+      void train(UInt32 signature, bool opt_hit);
+      // A cache-friendly line had to be evicted
+      void detrain(UInt32 signature);
+
+   private:
+      const UInt8 m_rrip_numbits;
+      const UInt32 m_sample_period;
+      const UInt32 m_history_length;
+      const UInt32 m_predictor_size;
+      const UInt8 m_predictor_max;
+      UInt8* m_predictor;
+      UInt32 m_num_sets;
+
+      UInt64 m_optgen_hits;
+      UInt64 m_optgen_misses;
+      UInt64 m_predictions_correct;
+      UInt64 m_predictions_incorrect;
+      UInt64 m_friendly_evictions;
+};
+
+class CacheSetHawkeye : public CacheSet
+{
+   public:
+      CacheSetHawkeye(CacheBase::cache_t cache_type,
+            UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoHawkeye* set_info);
+      ~CacheSetHawkeye();
+
+      UInt32 getReplacementIndex(CacheCntlr *cntlr);
+      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndexOnAccess(UInt32 accessed_index, CacheCntlr *cntlr);
+      void updateReplacementIndexOnInsert(UInt32 inserted_index, CacheCntlr *cntlr);
+
+   private:
+      // OPTgen state of a sampled set
+      struct HistoryEntry
+      {
+         IntPtr tag;
+         UInt64 time;
+         UInt32 signature;
+      };
+      struct OptGen
+      {
+         UInt64 time;                         // Number of accesses to this set
+         std::vector<UInt32> occupancy;       // Per time quantum in the window, number of lines OPT keeps in the cache
+         std::vector<HistoryEntry> history;   // Last access to each tag, indexed by time modulo window length
+      };
+
+      CacheSetInfoHawkeye* m_set_info;
+      const UInt8 m_rrip_max;
+      UInt8* m_rrip_bits;
+      UInt32* m_signatures;
+      OptGen* m_optgen;
+
+      void access(UInt32 index, CacheCntlr *cntlr, bool insert);
+      void trainOptGen(IntPtr tag, UInt32 signature);
+};
+
+#endif /* CACHE_SET_HAWKEYE_H */
@@ -6,8 +6,8 @@
 
 CacheSetLRU::CacheSetLRU(
       CacheBase::cache_t cache_type,
-      UInt32 associativity, UInt32 blocksize, CacheSetInfoLRU* set_info, UInt8 num_attempts)
-   : CacheSet(cache_type, associativity, blocksize)
+      UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoLRU* set_info, UInt8 num_attempts)
+   : CacheSet(cache_type, associativity, blocksize, flat_tags)
    , m_num_attempts(num_attempts)
    , m_set_info(set_info)
 {
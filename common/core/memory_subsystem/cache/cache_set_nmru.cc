@@ -5,8 +5,8 @@
 
 CacheSetNMRU::CacheSetNMRU(
       CacheBase::cache_t cache_type,
-      UInt32 associativity, UInt32 blocksize) :
-   CacheSet(cache_type, associativity, blocksize)
+      UInt32 associativity, UInt32 blocksize, bool flat_tags) :
+   CacheSet(cache_type, associativity, blocksize, flat_tags)
 {
    m_lru_bits = new UInt8[m_associativity];
    for (UInt32 i = 0; i < m_associativity; i++)
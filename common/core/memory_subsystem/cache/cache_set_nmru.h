@@ -7,7 +7,7 @@ class CacheSetNMRU : public CacheSet
 {
    public:
       CacheSetNMRU(CacheBase::cache_t cache_type,
-            UInt32 associativity, UInt32 blocksize);
+            UInt32 associativity, UInt32 blocksize, bool flat_tags);
       ~CacheSetNMRU();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
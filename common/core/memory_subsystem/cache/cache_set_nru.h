@@ -7,7 +7,7 @@ class CacheSetNRU : public CacheSet
 {
    public:
       CacheSetNRU(CacheBase::cache_t cache_type,
-            UInt32 associativity, UInt32 blocksize);
+            UInt32 associativity, UInt32 blocksize, bool flat_tags);
       ~CacheSetNRU();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
@@ -7,8 +7,8 @@
 
 CacheSetRandom::CacheSetRandom(
       CacheBase::cache_t cache_type,
-      UInt32 associativity, UInt32 blocksize) :
-   CacheSet(cache_type, associativity, blocksize)
+      UInt32 associativity, UInt32 blocksize, bool flat_tags) :
+   CacheSet(cache_type, associativity, blocksize, flat_tags)
 {
    m_rand.seed(time(NULL));
 }
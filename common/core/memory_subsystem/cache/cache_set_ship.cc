@@ -0,0 +1,157 @@
+#include "cache_set_ship.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+#include "stats.h"
+
+// SHiP-PC: Signature-based Hit Predictor [Wu et al., MICRO'11]
+// SRRIP, but lines whose inserting PC has a history of not being re-referenced are inserted
+// with a distant re-reference prediction, so they are evicted first
+
+CacheSetInfoSHiP::CacheSetInfoSHiP(String name, String cfgname, core_id_t core_id)
+   : m_rrip_numbits(Sim()->getCfg()->getInt("perf_model/cache/ship/bits"))
+   , m_shct_size(Sim()->getCfg()->getInt("perf_model/cache/ship/shct_size"))
+   , m_shct_max((1 << Sim()->getCfg()->getInt("perf_model/cache/ship/shct_bits")) - 1)
+   , m_inserts_distant(0)
+   , m_inserts_long(0)
+   , m_predictions_correct(0)
+   , m_predictions_incorrect(0)
+{
+   LOG_ASSERT_ERROR(m_rrip_numbits > 0 && m_rrip_numbits < 8, "perf_model/cache/ship/bits must be between 1 and 7");
+   LOG_ASSERT_ERROR(m_shct_size > 0, "perf_model/cache/ship/shct_size must be > 0");
+
+   // Start out weakly predicting re-reference
+   m_shct = new UInt8[m_shct_size];
+   for (UInt32 i = 0; i < m_shct_size; i++)
+      m_shct[i] = 1;
+
+   registerStatsMetric(name, core_id, "ship-inserts-distant", &m_inserts_distant);
+   registerStatsMetric(name, core_id, "ship-inserts-long", &m_inserts_long);
+   registerStatsMetric(name, core_id, "ship-predictions-correct", &m_predictions_correct);
+   registerStatsMetric(name, core_id, "ship-predictions-incorrect", &m_predictions_incorrect);
+}
+
+CacheSetInfoSHiP::~CacheSetInfoSHiP()
+{
+   delete [] m_shct;
+}
+
+void
+CacheSetInfoSHiP::insert(bool predicted_dead)
+{
+   if (predicted_dead)
+      ++m_inserts_distant;
+   else
+      ++m_inserts_long;
+}
+
+void
+CacheSetInfoSHiP::reused(UInt32 signature, bool predicted_dead)
+{
+   if (m_shct[signature] < m_shct_max)
+      ++m_shct[signature];
+   if (predicted_dead)
+      ++m_predictions_incorrect;
+   else
+      ++m_predictions_correct;
+}
+
+void
+CacheSetInfoSHiP::evictedUnused(UInt32 signature, bool predicted_dead)
+{
+   if (m_shct[signature] > 0)
+      --m_shct[signature];
+   if (predicted_dead)
+      ++m_predictions_correct;
+   else
+      ++m_predictions_incorrect;
+}
+
+
+CacheSetSHiP::CacheSetSHiP(
+      CacheBase::cache_t cache_type,
+      UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoSHiP* set_info)
+   : CacheSet(cache_type, associativity, blocksize, flat_tags)
+   , m_set_info(set_info)
+   , m_rrip_max((1 << set_info->getNumBits()) - 1)
+   , m_replacement_pointer(0)
+{
+   m_rrip_bits = new UInt8[m_associativity];
+   m_signatures = new UInt32[m_associativity];
+   m_reused = new bool[m_associativity];
+   m_predicted_dead = new bool[m_associativity];
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      m_rrip_bits[i] = m_rrip_max;
+      m_signatures[i] = 0;
+      m_reused[i] = false;
+      m_predicted_dead[i] = false;
+   }
+}
+
+CacheSetSHiP::~CacheSetSHiP()
+{
+   delete [] m_rrip_bits;
+   delete [] m_signatures;
+   delete [] m_reused;
+   delete [] m_predicted_dead;
+}
+
+UInt32
+CacheSetSHiP::getReplacementIndex(CacheCntlr *cntlr)
+{
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      if (!m_cache_block_info_array[i]->isValid())
+         return i;
+   }
+
+   for(UInt32 j = 0; j <= m_rrip_max; ++j)
+   {
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         UInt32 index = m_replacement_pointer;
+         m_replacement_pointer = (m_replacement_pointer + 1) % m_associativity;
+         if (m_rrip_bits[index] >= m_rrip_max && isValidReplacement(index))
+         {
+            if (!m_reused[index])
+               m_set_info->evictedUnused(m_signatures[index], m_predicted_dead[index]);
+            return index;
+         }
+      }
+
+      // Increment all RRIP counters until one hits RRIP_MAX
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         if (m_rrip_bits[i] < m_rrip_max)
+            m_rrip_bits[i]++;
+      }
+   }
+
+   LOG_PRINT_ERROR("Error finding replacement index");
+}
+
+void
+CacheSetSHiP::updateReplacementIndexOnInsert(UInt32 inserted_index, CacheCntlr *cntlr)
+{
+   // Prefetches and accesses without a known PC share signature 0
+   UInt32 signature = m_set_info->getSignature(cntlr ? cntlr->getAccessEip() : 0);
+   bool dead = m_set_info->predictDead(signature);
+
+   m_signatures[inserted_index] = signature;
+   m_reused[inserted_index] = false;
+   m_predicted_dead[inserted_index] = dead;
+   m_rrip_bits[inserted_index] = dead ? m_rrip_max : m_rrip_max - 1;
+   m_set_info->insert(dead);
+}
+
+void
+CacheSetSHiP::updateReplacementIndex(UInt32 accessed_index)
+{
+   if (!m_reused[accessed_index])
+   {
+      m_reused[accessed_index] = true;
+      m_set_info->reused(m_signatures[accessed_index], m_predicted_dead[accessed_index]);
+   }
+   m_rrip_bits[accessed_index] = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef CACHE_SET_SHIP_H
+#define CACHE_SET_SHIP_H
+
+#include "cache_set.h"
+
+// Per-cache Signature History Counter Table (SHCT): per PC signature, whether lines inserted
+// by that PC tend to be re-referenced before they are evicted
+class CacheSetInfoSHiP : public CacheSetInfo
+{
+   public:
+      CacheSetInfoSHiP(String name, String cfgname, core_id_t core_id);
+      virtual ~CacheSetInfoSHiP();
+
+      UInt8 getNumBits() const { return m_rrip_numbits; }
+      UInt32 getSignature(IntPtr eip) const { return (eip ^ (eip >> 12) ^ (eip >> 24)) % m_shct_size; }
+      bool predictDead(UInt32 signature) const { return m_shct[signature] == 0; }
+
+      void insert(bool predicted_dead);
+      // First hit to a line since it was inserted
+      void reused(UInt32 signature, bool predicted_dead);
+      // Line evicted without having been hit
+      void evictedUnused(UInt32 signature, bool predicted_dead);
+
+   private:
+      const UInt8 m_rrip_numbits;
+      const UInt32 m_shct_size;
+      const UInt8 m_shct_max;
+      UInt8* m_shct;
+
+      UInt64 m_inserts_distant;
+      UInt64 m_inserts_long;
+      UInt64 m_predictions_correct;
+      UInt64 m_predictions_incorrect;
+};
+
+class CacheSetSHiP : public CacheSet
+{
+   public:
+      CacheSetSHiP(CacheBase::cache_t cache_type,
+            UInt32 associativity, UInt32 blocksize, bool flat_tags, CacheSetInfoSHiP* set_info);
+      ~CacheSetSHiP();
+
+      UInt32 getReplacementIndex(CacheCntlr *cntlr);
+      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndexOnInsert(UInt32 inserted_index, CacheCntlr *cntlr);
+
+   private:
+      CacheSetInfoSHiP* m_set_info;
+      const UInt8 m_rrip_max;
+      UInt8* m_rrip_bits;
+      UInt32* m_signatures;
+      bool* m_reused;
+      bool* m_predicted_dead;
+      UInt8  m_replacement_pointer;
+};
+
+#endif /* CACHE_SET_SHIP_H */
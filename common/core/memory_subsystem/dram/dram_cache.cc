@@ -8,6 +8,7 @@
 #include "queue_model.h"
 #include "shmem_perf.h"
 #include "prefetcher.h"
+#include "thermal_insertion_policy.h"
 
 DramCache::DramCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_perf_model, AddressHomeLookup* home_lookup, UInt32 cache_block_size, DramCntlrInterface *dram_cntlr)
    : DramCntlrInterface(memory_manager, shmem_perf_model, cache_block_size)
@@ -21,6 +22,7 @@ DramCache::DramCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
    , m_queue_model(NULL)
    , m_prefetcher(NULL)
    , m_prefetch_mshr("dram-cache.prefetch-mshr", m_core_id, 16)
+   , m_thermal_policy(NULL)
    , m_reads(0)
    , m_writes(0)
    , m_read_misses(0)
@@ -53,9 +55,11 @@ DramCache::DramCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
       m_queue_model = QueueModel::create("dram-cache-queue", m_core_id, queue_model_type, m_data_array_bandwidth.getRoundedLatency(8 * m_cache_block_size)); // bytes to bits
    }
 
-   m_prefetcher = Prefetcher::createPrefetcher(Sim()->getCfg()->getString("perf_model/dram/cache/prefetcher"), "dram/cache", m_core_id, 1);
+   m_prefetcher = Prefetcher::createPrefetcher(Sim()->getCfg()->getString("perf_model/dram/cache/prefetcher"), "dram/cache", m_core_id, 1, m_cache_block_size);
    m_prefetch_on_prefetch_hit = Sim()->getCfg()->getBool("perf_model/dram/cache/prefetcher/prefetch_on_prefetch_hit");
 
+   m_thermal_policy = new ThermalInsertionPolicy("dram-cache", "dram/cache", m_core_id);
+
    registerStatsMetric("dram-cache", m_core_id, "reads", &m_reads);
    registerStatsMetric("dram-cache", m_core_id, "writes", &m_writes);
    registerStatsMetric("dram-cache", m_core_id, "read-misses", &m_read_misses);
@@ -68,6 +72,7 @@ DramCache::DramCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
 DramCache::~DramCache()
 {
    delete m_cache;
+   delete m_thermal_policy;
    if (m_queue_model)
       delete m_queue_model;
 }
@@ -130,6 +135,8 @@ DramCache::doAccess(Cache::access_t access, IntPtr address, core_id_t requester,
       latency += accessDataArray(access, requester, now + latency, perf);
       if (access == Cache::STORE)
          block_info->setCState(CacheState::MODIFIED);
+
+      m_thermal_policy->hit(address, requester);
    }
    else
    {
@@ -143,7 +150,11 @@ DramCache::doAccess(Cache::access_t access, IntPtr address, core_id_t requester,
       }
          // For STOREs, we only do complete cache lines so we don't need to read from DRAM
 
-      insertLine(access, address, requester, data_buf, now + latency);
+      if (m_thermal_policy->shouldInsert(address, requester))
+         insertLine(access, address, requester, data_buf, now + latency);
+      else if (access == Cache::STORE)
+         // Bypassed, write through to DRAM (off-line, so don't affect return latency)
+         m_dram_cntlr->putDataToDram(address, requester, data_buf, now + latency);
    }
 
    if (m_prefetcher)
@@ -203,7 +214,7 @@ void
 DramCache::callPrefetcher(IntPtr train_address, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue)
 {
    // Always train the prefetcher
-   std::vector<IntPtr> prefetchList = m_prefetcher->getNextAddress(train_address, INVALID_CORE_ID);
+   std::vector<IntPtr> prefetchList = m_prefetcher->getNextAddress(train_address, 0, cache_hit, prefetch_hit, INVALID_CORE_ID);
 
    // Only do prefetches on misses, or on hits to lines previously brought in by the prefetcher (if enabled)
    if (!cache_hit || (m_prefetch_on_prefetch_hit && prefetch_hit))
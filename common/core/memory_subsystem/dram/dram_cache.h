@@ -8,6 +8,7 @@
 
 class QueueModel;
 class Prefetcher;
+class ThermalInsertionPolicy;
 
 class DramCache : public DramCntlrInterface
 {
@@ -32,6 +33,7 @@ class DramCache : public DramCntlrInterface
       Prefetcher* m_prefetcher;
       bool m_prefetch_on_prefetch_hit;
       ContentionModel m_prefetch_mshr;
+      ThermalInsertionPolicy* m_thermal_policy;
 
       UInt64 m_reads, m_writes;
       UInt64 m_read_misses, m_write_misses;
@@ -0,0 +1,77 @@
+#include "thermal_insertion_policy.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "stats.h"
+#include "log.h"
+#include "dram_trace_collect.h" // Used to calculate the bank number from an address.
+
+#define LOW_POWER 0
+
+ThermalInsertionPolicy::ThermalInsertionPolicy(String name, String configName, core_id_t core_id)
+   : m_policy(parsePolicy(Sim()->getCfg()->getString("perf_model/" + configName + "/thermal_insertion/policy")))
+   , m_bypass_period(Sim()->getCfg()->getInt("perf_model/" + configName + "/thermal_insertion/bypass_period"))
+   , m_normal_misses(0)
+   , m_bypasses(0)
+   , m_inserts_lowpower(0)
+   , m_avoided_accesses(0)
+   , m_avoided_accesses_lowpower(0)
+{
+   LOG_ASSERT_ERROR(m_bypass_period > 0, "perf_model/%s/thermal_insertion/bypass_period must be > 0", configName.c_str());
+
+   registerStatsMetric(name, core_id, "thermal-bypasses", &m_bypasses);
+   registerStatsMetric(name, core_id, "thermal-inserts-lowpower", &m_inserts_lowpower);
+   registerStatsMetric(name, core_id, "bank-accesses-avoided", &m_avoided_accesses);
+   registerStatsMetric(name, core_id, "bank-accesses-avoided-lowpower", &m_avoided_accesses_lowpower);
+}
+
+ThermalInsertionPolicy::policy_t
+ThermalInsertionPolicy::parsePolicy(String policy)
+{
+   if (policy == "none")
+      return NONE;
+   else if (policy == "lowpower_banks")
+      return LOWPOWER_BANKS;
+   else
+      LOG_PRINT_ERROR("Unknown thermal insertion policy %s", policy.c_str());
+}
+
+bool
+ThermalInsertionPolicy::isLowPower(IntPtr address, core_id_t requester) const
+{
+   UInt32 bank = get_address_bank(address, requester);
+   return bank < MAX_NUM_OF_BANKS && Sim()->m_bank_modes[bank] == LOW_POWER;
+}
+
+bool
+ThermalInsertionPolicy::shouldInsert(IntPtr address, core_id_t requester)
+{
+   switch(m_policy)
+   {
+      case NONE:
+         return true;
+
+      case LOWPOWER_BANKS:
+         if (isLowPower(address, requester))
+         {
+            ++m_inserts_lowpower;
+            return true;
+         }
+         // Still insert some lines of normal banks, else the cache never adapts when bank modes change
+         if (++m_normal_misses >= m_bypass_period)
+         {
+            m_normal_misses = 0;
+            return true;
+         }
+         ++m_bypasses;
+         return false;
+   }
+   return true;
+}
+
+void
+ThermalInsertionPolicy::hit(IntPtr address, core_id_t requester)
+{
+   ++m_avoided_accesses;
+   if (m_policy != NONE && isLowPower(address, requester))
+      ++m_avoided_accesses_lowpower;
+}
@@ -0,0 +1,40 @@
+#ifndef __THERMAL_INSERTION_POLICY_H
+#define __THERMAL_INSERTION_POLICY_H
+
+#include "fixed_types.h"
+
+// Decides whether a cache in front of stacked DRAM (DRAM cache, NUCA) should insert a missing line or
+// bypass it, based on the power mode of the DRAM bank the line maps to (Sim()->m_bank_modes).
+// Banks are put into low-power mode by the DTM policy when they run hot. Keeping the lines of those
+// banks cached, at the expense of lines from cool banks, moves accesses away from the hot banks.
+class ThermalInsertionPolicy
+{
+   public:
+      enum policy_t
+      {
+         NONE,             // Always insert
+         LOWPOWER_BANKS,   // Always insert lines of low-power banks, insert those of normal banks only once every bypass_period misses
+      };
+
+      ThermalInsertionPolicy(String name, String configName, core_id_t core_id);
+
+      // Called on a miss: true if the line should be inserted
+      bool shouldInsert(IntPtr address, core_id_t requester);
+      // Called on a hit, counts the bank accesses avoided by having the line cached
+      void hit(IntPtr address, core_id_t requester);
+
+   private:
+      policy_t m_policy;
+      const UInt32 m_bypass_period;
+      UInt32 m_normal_misses;
+
+      UInt64 m_bypasses;
+      UInt64 m_inserts_lowpower;
+      UInt64 m_avoided_accesses;
+      UInt64 m_avoided_accesses_lowpower;
+
+      static policy_t parsePolicy(String policy);
+      bool isLowPower(IntPtr address, core_id_t requester) const;
+};
+
+#endif // __THERMAL_INSERTION_POLICY_H
@@ -48,7 +48,8 @@ class MemoryManagerBase
             Core::mem_op_t mem_op_type,
             IntPtr address, UInt32 offset,
             Byte* data_buf, UInt32 data_length,
-            Core::MemModeled modeled) = 0;
+            Core::MemModeled modeled,
+            IntPtr eip = 0) = 0;
       virtual SubsecondTime coreInitiateMemoryAccessFast(
             bool icache,
             Core::mem_op_t mem_op_type,
@@ -72,6 +73,17 @@ class MemoryManagerBase
          return latency;
       }
 
+      // Warm-state checkpoints (see CheckpointManager)
+      struct CheckpointLine
+      {
+         MemComponent::component_t mem_component;  // Cache level the line was found in
+         IntPtr address;
+         bool dirty;
+      };
+      // Cache lines held by this core's caches, ordered from the last level to the first so replaying them
+      // leaves the first levels warmest. Shared caches are only reported by their master core.
+      virtual void getCheckpointLines(std::vector<CheckpointLine> &lines) {}
+
       virtual void handleMsgFromNetwork(NetPacket& packet) = 0;
 
       // FIXME: Take this out of here
@@ -0,0 +1,104 @@
+#include "best_offset_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "utils.h"
+#include "log.h"
+
+const IntPtr PAGE_SIZE = 4096;
+const IntPtr PAGE_MASK = ~(PAGE_SIZE-1);
+
+BestOffsetPrefetcher::BestOffsetPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size)
+   : m_log_block_size(floorLog2(cache_block_size))
+   , m_score_max(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/score_max", core_id))
+   , m_round_max(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/round_max", core_id))
+   , m_bad_score(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/bad_score", core_id))
+   , m_degree(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/degree", core_id))
+   , m_stop_at_page(Sim()->getCfg()->getBoolArray("perf_model/" + configName + "/prefetcher/best_offset/stop_at_page_boundary", core_id))
+   , m_test_index(0)
+   , m_round(0)
+   , m_prefetch_offset(1)
+   , m_recent_requests(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/rr_size", core_id), SInt64(-1))
+{
+   // Candidate offsets: all numbers up to max_offset without prime factors larger than 5
+   UInt32 max_offset = Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/max_offset", core_id);
+   for(UInt32 offset = 1; offset <= max_offset; ++offset)
+   {
+      UInt32 n = offset;
+      while (n % 2 == 0) n /= 2;
+      while (n % 3 == 0) n /= 3;
+      while (n % 5 == 0) n /= 5;
+      if (n == 1)
+         m_offsets.push_back(offset);
+   }
+   m_scores.resize(m_offsets.size(), 0);
+
+   LOG_ASSERT_ERROR(m_offsets.size() > 0, "perf_model/%s/prefetcher/best_offset/max_offset must be > 0", configName.c_str());
+   LOG_ASSERT_ERROR(m_recent_requests.size() > 0, "perf_model/%s/prefetcher/best_offset/rr_size must be > 0", configName.c_str());
+}
+
+void
+BestOffsetPrefetcher::learn(SInt64 line)
+{
+   // Test one offset per access, round-robin
+   SInt64 base = line - m_offsets[m_test_index];
+   if (m_recent_requests[rrIndex(base)] == base)
+      ++m_scores[m_test_index];
+
+   bool end_phase = m_scores[m_test_index] >= m_score_max;
+   if (++m_test_index == m_offsets.size())
+   {
+      m_test_index = 0;
+      if (++m_round >= m_round_max)
+         end_phase = true;
+   }
+
+   if (end_phase)
+   {
+      UInt32 best = 0;
+      for(UInt32 i = 1; i < m_offsets.size(); ++i)
+         if (m_scores[i] > m_scores[best])
+            best = i;
+      m_prefetch_offset = m_scores[best] > m_bad_score ? m_offsets[best] : 0;
+
+      std::fill(m_scores.begin(), m_scores.end(), 0);
+      m_test_index = 0;
+      m_round = 0;
+   }
+}
+
+std::vector<IntPtr>
+BestOffsetPrefetcher::getNextAddress(IntPtr current_address, core_id_t core_id)
+{
+   return getNextAddress(current_address, 0, false, false, core_id);
+}
+
+std::vector<IntPtr>
+BestOffsetPrefetcher::getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id)
+{
+   std::vector<IntPtr> addresses;
+
+   // Only misses and hits on prefetched lines train the prefetcher and trigger prefetches
+   if (cache_hit && !prefetch_hit)
+      return addresses;
+
+   SInt64 line = current_address >> m_log_block_size;
+   learn(line);
+
+   // The original design inserts a base address when its prefetch completes, so offsets that are too short
+   // to be timely lose out. Fill times are not known here, the base address is inserted at the time of access.
+   m_recent_requests[rrIndex(line)] = line;
+
+   if (m_prefetch_offset != 0)
+   {
+      for(UInt32 i = 1; i <= m_degree; ++i)
+      {
+         IntPtr prefetch_address = (line + SInt64(i) * m_prefetch_offset) << m_log_block_size;
+         // But stay within the page if requested
+         if (m_stop_at_page && ((prefetch_address & PAGE_MASK) != (current_address & PAGE_MASK)))
+            break;
+         addresses.push_back(prefetch_address);
+      }
+   }
+
+   return addresses;
+}
@@ -0,0 +1,37 @@
+#ifndef __BEST_OFFSET_PREFETCHER_H
+#define __BEST_OFFSET_PREFETCHER_H
+
+#include "prefetcher.h"
+
+// Best-Offset prefetcher [Michaud, HPCA'16]
+// Prefetches line X+D on an access to line X. The offset D is learned in phases: each candidate offset d
+// scores a point when X-d was recently accessed, i.e., when offset d would have covered X.
+class BestOffsetPrefetcher : public Prefetcher
+{
+   public:
+      BestOffsetPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id);
+
+   private:
+      const UInt32 m_log_block_size;
+      const UInt32 m_score_max;   // A phase ends early when an offset reaches this score
+      const UInt32 m_round_max;   // or after all offsets have been tested this many times
+      const UInt32 m_bad_score;   // Prefetching is turned off when the best offset scores no higher than this
+      const UInt32 m_degree;
+      const bool m_stop_at_page;
+
+      std::vector<SInt64> m_offsets;
+      std::vector<UInt32> m_scores;
+      UInt32 m_test_index;
+      UInt32 m_round;
+      SInt64 m_prefetch_offset;   // 0 = prefetching off
+
+      // Recent requests table: direct-mapped, holds line addresses
+      std::vector<SInt64> m_recent_requests;
+
+      UInt32 rrIndex(SInt64 line) const { return (line ^ (line >> 8)) % m_recent_requests.size(); }
+      void learn(SInt64 line);
+};
+
+#endif // __BEST_OFFSET_PREFETCHER_H
@@ -115,6 +115,8 @@ CacheMasterCntlr::accessATDs(Core::mem_op_t mem_op_type, bool hit, IntPtr addres
 CacheMasterCntlr::~CacheMasterCntlr()
 {
    delete m_cache;
+   delete m_prefetcher;
+   delete m_prefetch_throttle;
    for(std::vector<ATD*>::iterator it = m_atds.begin(); it != m_atds.end(); ++it)
    {
       delete *it;
@@ -142,6 +144,9 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    m_coherent(cache_params.coherent),
    m_prefetch_on_prefetch_hit(false),
    m_l1_mshr(cache_params.outstanding_misses > 0),
+   m_optimistic_hits(Sim()->getCfg()->getBool("perf_model/cache/optimistic_hits")),
+   m_lock_stats(Sim()->getCfg()->getBool("perf_model/cache/lock_stats")),
+   m_moesi(Sim()->getCfg()->getString("caching_protocol/variant") == "moesi"),
    m_core_id(core_id),
    m_cache_block_size(cache_block_size),
    m_cache_writethrough(cache_params.writethrough),
@@ -153,7 +158,8 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    m_last_remote_hit_where(HitWhere::UNKNOWN),
    m_shmem_perf(new ShmemPerf()),
    m_shmem_perf_global(NULL),
-   m_shmem_perf_model(shmem_perf_model)
+   m_shmem_perf_model(shmem_perf_model),
+   m_access_eip(0)
 {
    m_core_id_master = m_core_id - m_core_id % m_shared_cores;
    Sim()->getStatsManager()->logTopology(name, core_id, m_core_id_master);
@@ -179,7 +185,9 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
             Sim()->getFaultinjectionManager()
                ? Sim()->getFaultinjectionManager()->getFaultInjector(m_core_id_master, mem_component)
                : NULL);
-      m_master->m_prefetcher = Prefetcher::createPrefetcher(cache_params.prefetcher, cache_params.configName, m_core_id, m_shared_cores);
+      m_master->m_prefetcher = Prefetcher::createPrefetcher(cache_params.prefetcher, cache_params.configName, m_core_id, m_shared_cores, m_cache_block_size);
+      if (m_master->m_prefetcher && Sim()->getCfg()->getBool("perf_model/cache/prefetch_throttle/enabled"))
+         m_master->m_prefetch_throttle = new PrefetchThrottle(name, m_core_id);
 
       if (Sim()->getCfg()->getBoolDefault("perf_model/" + cache_params.configName + "/atd/enabled", false))
       {
@@ -242,11 +250,25 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
          registerStatsMetric(name, core_id, String("loads-where-")+where_str, &stats.loads_where[hit_where]);
          registerStatsMetric(name, core_id, String("stores-where-")+where_str, &stats.stores_where[hit_where]);
       }
+      if (m_optimistic_hits)
+      {
+         registerStatsMetric(name, core_id, "optimistic-hits", &stats.optimistic_hits);
+         registerStatsMetric(name, core_id, "optimistic-fallbacks", &stats.optimistic_fallbacks);
+      }
+   }
+   if (m_lock_stats)
+   {
+      // Host (wall-clock) time spent waiting for the set locks, by the cache level that requested them
+      registerStatsMetric(name, core_id, "setlock-acquires", &stats.setlock_acquires);
+      registerStatsMetric(name, core_id, "setlock-contended", &stats.setlock_contended);
+      registerStatsMetric(name, core_id, "setlock-wait-ns", &stats.setlock_wait_ns);
    }
    registerStatsMetric(name, core_id, "coherency-downgrades", &stats.coherency_downgrades);
    registerStatsMetric(name, core_id, "coherency-upgrades", &stats.coherency_upgrades);
    registerStatsMetric(name, core_id, "coherency-writebacks", &stats.coherency_writebacks);
    registerStatsMetric(name, core_id, "coherency-invalidates", &stats.coherency_invalidates);
+   // Writes to EXCLUSIVE lines, which did not need an UPGRADE_REQ to the directory
+   registerStatsMetric(name, core_id, "coherency-upgrades-avoided", &stats.coherency_upgrades_avoided);
 #ifdef ENABLE_TRANSITIONS
    for(CacheState::cstate_t old_state = CacheState::CSTATE_FIRST; old_state < CacheState::NUM_CSTATE_STATES; old_state = CacheState::cstate_t(int(old_state)+1))
       for(CacheState::cstate_t new_state = CacheState::CSTATE_FIRST; new_state < CacheState::NUM_CSTATE_STATES; new_state = CacheState::cstate_t(int(new_state)+1))
@@ -320,13 +342,16 @@ CacheCntlr::processMemOpFromCore(
       IntPtr ca_address, UInt32 offset,
       Byte* data_buf, UInt32 data_length,
       bool modeled,
-      bool count)
+      bool count,
+      IntPtr eip)
 {
    HitWhere::where_t hit_where = HitWhere::MISS;
 
    // Protect against concurrent access from sibling SMT threads
    ScopedLock sl_smt(m_master->m_smt_lock);
 
+   m_access_eip = eip;
+
    LOG_PRINT("processMemOpFromCore(), lock_signal(%u), mem_op_type(%u), ca_address(0x%x)",
              lock_signal, mem_op_type, ca_address);
 MYLOG("----------------------------------------------");
@@ -334,9 +359,19 @@ MYLOG("%c%c %lx+%u..+%u", mem_op_type == Core::WRITE ? 'W' : 'R', mem_op_type ==
 LOG_ASSERT_ERROR((ca_address & (getCacheBlockSize() - 1)) == 0, "address at cache line + %x", ca_address & (getCacheBlockSize() - 1));
 LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u > %u", offset + data_length, getCacheBlockSize());
 
+   CacheBlockInfo *cache_block_info;
+   bool cache_hit = false, prefetch_hit = false, prefetch_late = false;
+
+   /* plain, timing-only loads that hit can proceed without the set lock, as long as no fill or eviction in this
+      set group (which take the lock exclusively) raced with the lookup. Anything else takes the lock below.
+      Once validated, cache_block_info may be reused by a concurrent fill: use the state read before validation. */
+   CacheState::cstate_t optimistic_cstate = CacheState::INVALID;
+   bool optimistic = m_optimistic_hits && lock_signal == Core::NONE && data_buf == NULL
+      && optimisticHit(ca_address, mem_op_type, &cache_block_info, &optimistic_cstate);
+
    #ifdef PRIVATE_L2_OPTIMIZATION
    /* if this is the second part of an atomic operation: we already have the lock, don't lock again */
-   if (lock_signal != Core::UNLOCK)
+   if (lock_signal != Core::UNLOCK && !optimistic)
       acquireLock(ca_address);
    #else
    /* if we'll need the next level (because we're a writethrough cache, and either this is a write
@@ -346,7 +381,7 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
    bool lock_all = m_cache_writethrough && ((mem_op_type == Core::WRITE) || (lock_signal != Core::NONE));
 
     /* if this is the second part of an atomic operation: we already have the lock, don't lock again */
-   if (lock_signal != Core::UNLOCK) {
+   if (lock_signal != Core::UNLOCK && !optimistic) {
       if (lock_all)
          acquireStackLock(ca_address);
       else
@@ -356,8 +391,10 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
 
    SubsecondTime t_start = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
 
-   CacheBlockInfo *cache_block_info;
-   bool cache_hit = operationPermissibleinCache(ca_address, mem_op_type, &cache_block_info), prefetch_hit = false;
+   if (optimistic)
+      cache_hit = true;
+   else
+      cache_hit = operationPermissibleinCache(ca_address, mem_op_type, &cache_block_info);
 
    if (!cache_hit && m_perfect)
    {
@@ -374,7 +411,7 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
    else if (cache_hit && m_passthrough)
    {
       cache_hit = false;
-      cache_block_info->invalidate();
+      m_master->m_cache->invalidateSingleLine(ca_address);
       cache_block_info = NULL;
    }
 
@@ -383,7 +420,7 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
       ScopedLock sl(getLock());
       // Update the Cache Counters
       getCache()->updateCounters(cache_hit);
-      updateCounters(mem_op_type, ca_address, cache_hit, getCacheState(cache_block_info), Prefetch::NONE);
+      updateCounters(mem_op_type, ca_address, cache_hit, optimistic ? optimistic_cstate : getCacheState(cache_block_info), Prefetch::NONE);
    }
 
    if (cache_hit)
@@ -392,12 +429,13 @@ MYLOG("L1 hit");
       getMemoryManager()->incrElapsedTime(m_mem_component, CachePerfModel::ACCESS_CACHE_DATA_AND_TAGS, ShmemPerfModel::_USER_THREAD);
       hit_where = (HitWhere::where_t)m_mem_component;
 
-      if (cache_block_info->hasOption(CacheBlockInfo::WARMUP) && Sim()->getInstrumentationMode() != InstMode::CACHE_ONLY)
+      // Optimistic hits were validated to have neither option set
+      if (!optimistic && cache_block_info->hasOption(CacheBlockInfo::WARMUP) && Sim()->getInstrumentationMode() != InstMode::CACHE_ONLY)
       {
          stats.hits_warmup++;
          cache_block_info->clearOption(CacheBlockInfo::WARMUP);
       }
-      if (cache_block_info->hasOption(CacheBlockInfo::PREFETCH))
+      if (!optimistic && cache_block_info->hasOption(CacheBlockInfo::PREFETCH))
       {
          // This line was fetched by the prefetcher and has proven useful
          stats.hits_prefetch++;
@@ -433,6 +471,7 @@ MYLOG("L1 hit");
             SubsecondTime latency = m_master->mshr[ca_address].t_complete - t_now;
             stats.mshr_latency += latency;
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
+            prefetch_late = prefetch_hit;
          }
       }
 
@@ -512,7 +551,7 @@ MYLOG("processMemOpFromCore l%d after next fill", m_mem_component);
 
       /* data should now be in next-level cache, go get it */
       SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-      copyDataFromNextLevel(mem_op_type, ca_address, modeled, t_now);
+      copyDataFromNextLevel(mem_op_type, ca_address, modeled, t_now, false);
 
       cache_block_info = getCacheBlockInfo(ca_address);
 
@@ -567,10 +606,10 @@ MYLOG("access done");
 
       /* if this is the first part of an atomic operation: keep the lock(s) */
       #ifdef PRIVATE_L2_OPTIMIZATION
-      if (lock_signal != Core::LOCK)
+      if (lock_signal != Core::LOCK && !optimistic)
          releaseLock(ca_address);
       #else
-      if (lock_signal != Core::LOCK) {
+      if (lock_signal != Core::LOCK && !optimistic) {
          if (lock_all)
             releaseStackLock(ca_address);
          else
@@ -587,6 +626,7 @@ MYLOG("access done");
 
    if (modeled && m_master->m_prefetcher)
    {
+      notifyPrefetchThrottle(ca_address, cache_hit, prefetch_hit, prefetch_late);
       trainPrefetcher(ca_address, cache_hit, prefetch_hit, t_start);
    }
 
@@ -619,7 +659,7 @@ CacheCntlr::updateHits(Core::mem_op_t mem_op_type, UInt64 hits)
 
 
 void
-CacheCntlr::copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_now)
+CacheCntlr::copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_now, bool is_prefetch)
 {
    // TODO: what if it's already gone? someone else may invalitate it between the time it arrived an when we get here...
    LOG_ASSERT_ERROR(m_next_cache_cntlr->operationPermissibleinCache(address, mem_op_type),
@@ -630,6 +670,9 @@ MYLOG("copyDataFromNextLevel l%d", m_mem_component);
    m_next_cache_cntlr->retrieveCacheBlock(address, data_buf, ShmemPerfModel::_USER_THREAD, false);
 
    CacheState::cstate_t cstate = m_next_cache_cntlr->getCacheState(address);
+   // Dirty data in OWNED state is tracked by the last-level cache, previous levels only keep a SHARED copy
+   if (cstate == CacheState::OWNED)
+      cstate = CacheState::SHARED;
 
    // TODO: increment time? tag access on next level, also data access if this is not an upgrade
 
@@ -652,7 +695,7 @@ MYLOG("copyDataFromNextLevel l%d", m_mem_component);
    else
    {
       // Insert the Cache Block in our own cache
-      insertCacheBlock(address, cstate, data_buf, m_core_id, ShmemPerfModel::_USER_THREAD);
+      insertCacheBlock(address, cstate, data_buf, m_core_id, ShmemPerfModel::_USER_THREAD, is_prefetch);
       MYLOG("copyDataFromNextLevel l%d done (inserted)", m_mem_component);
    }
 }
@@ -664,7 +707,9 @@ CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, S
    ScopedLock sl(getLock());
 
    // Always train the prefetcher
-   std::vector<IntPtr> prefetchList = m_master->m_prefetcher->getNextAddress(address, m_core_id);
+   std::vector<IntPtr> prefetchList = m_master->m_prefetcher->getNextAddress(address, m_access_eip, cache_hit, prefetch_hit, m_core_id);
+   if (m_master->m_prefetch_throttle)
+      m_master->m_prefetch_throttle->limit(prefetchList);
 
    // Only do prefetches on misses, or on hits to lines previously brought in by the prefetcher (if enabled)
    if (!cache_hit || (m_prefetch_on_prefetch_hit && prefetch_hit))
@@ -684,6 +729,19 @@ CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, S
    }
 }
 
+void
+CacheCntlr::notifyPrefetchThrottle(IntPtr address, bool cache_hit, bool prefetch_hit, bool prefetch_late)
+{
+   if (!m_master->m_prefetch_throttle)
+      return;
+
+   ScopedLock sl(getLock());
+   if (prefetch_hit)
+      m_master->m_prefetch_throttle->prefetchUseful(prefetch_late);
+   else if (!cache_hit)
+      m_master->m_prefetch_throttle->demandMiss(address);
+}
+
 void
 CacheCntlr::Prefetch(SubsecondTime t_now)
 {
@@ -703,6 +761,8 @@ CacheCntlr::Prefetch(SubsecondTime t_now)
             if (!operationPermissibleinCache(address, Core::READ))
             {
                address_to_prefetch = address;
+               if (m_master->m_prefetch_throttle)
+                  m_master->m_prefetch_throttle->prefetchIssued();
                // Do at most one prefetch now, save the rest for a future call
                break;
             }
@@ -725,6 +785,7 @@ void
 CacheCntlr::doPrefetch(IntPtr prefetch_address, SubsecondTime t_start)
 {
    ++stats.prefetches;
+   IntPtr access_eip = m_access_eip;
    acquireStackLock(prefetch_address);
    MYLOG("prefetching %lx", prefetch_address);
    SubsecondTime t_before = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
@@ -745,6 +806,7 @@ CacheCntlr::doPrefetch(IntPtr prefetch_address, SubsecondTime t_start)
    }
 
    getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_USER_THREAD, t_before); // Ignore changes to time made by the prefetch call
+   m_access_eip = access_eip;
    releaseStackLock(prefetch_address);
 }
 
@@ -767,7 +829,10 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
    bool have_write_lock_internal = true;
    #endif
 
-   bool cache_hit = operationPermissibleinCache(address, mem_op_type), sibling_hit = false, prefetch_hit = false;
+   // Replacement policies at this level see the PC of the demand access, prefetches have none
+   m_access_eip = isPrefetch == Prefetch::NONE ? requester->m_access_eip : 0;
+
+   bool cache_hit = operationPermissibleinCache(address, mem_op_type), sibling_hit = false, prefetch_hit = false, prefetch_late = false;
    bool first_hit = cache_hit;
    HitWhere::where_t hit_where = HitWhere::MISS;
    SharedCacheBlockInfo* cache_block_info = getCacheBlockInfo(address);
@@ -785,7 +850,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
    {
       // Passthrough == false: cache that always misses (except in the L1 fill path, detected by count==false, where it should return the data)
       cache_hit = first_hit = false;
-      cache_block_info->invalidate();
+      m_master->m_cache->invalidateSingleLine(address);
       cache_block_info = NULL;
       LOG_ASSERT_ERROR(m_next_cache_cntlr != NULL, "Cannot do passthrough on an LLC");
    }
@@ -829,6 +894,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
             SubsecondTime latency = m_master->mshr[address].t_complete - t_now;
             stats.mshr_latency += latency;
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
+            prefetch_late = prefetch_hit;
          }
          else
          {
@@ -906,9 +972,9 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
       if (modeled)
          getMemoryManager()->incrElapsedTime(m_mem_component, CachePerfModel::ACCESS_CACHE_TAGS, ShmemPerfModel::_USER_THREAD);
 
-      if (cache_block_info && (cache_block_info->getCState() == CacheState::SHARED))
+      if (cache_block_info && (cache_block_info->getCState() == CacheState::SHARED || cache_block_info->getCState() == CacheState::OWNED))
       {
-         // Data is present, but still no cache_hit => this is a write on a SHARED block. Do Upgrade
+         // Data is present, but still no cache_hit => this is a write on a SHARED or OWNED block. Do Upgrade
          SubsecondTime latency = SubsecondTime::Zero();
          for(CacheCntlrList::iterator it = m_master->m_prev_cache_cntlrs.begin(); it != m_master->m_prev_cache_cntlrs.end(); it++)
             if (*it != requester)
@@ -932,7 +998,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
             cache_hit = true;
             /* get the data for ourselves */
             SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-            copyDataFromNextLevel(mem_op_type, address, modeled, t_now);
+            copyDataFromNextLevel(mem_op_type, address, modeled, t_now, isPrefetch != Prefetch::NONE);
             if (isPrefetch != Prefetch::NONE)
                getCacheBlockInfo(address)->setOption(CacheBlockInfo::PREFETCH);
          }
@@ -956,6 +1022,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
             hit_where = HitWhere::where_t(m_mem_component);
             MYLOG("Silent upgrade from E -> M for address %lx", address);
             cache_block_info->setCState(CacheState::MODIFIED);
+            ++stats.coherency_upgrades_avoided;
          }
          else if (m_master->m_dram_cntlr)
          {
@@ -980,7 +1047,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
                getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
 
                // Insert the line. Be sure to use SHARED/MODIFIED as appropriate (upgrades are free anyway), we don't want to have to write back clean lines
-               insertCacheBlock(address, mem_op_type == Core::READ ? CacheState::SHARED : CacheState::MODIFIED, data_buf, m_core_id, ShmemPerfModel::_USER_THREAD);
+               insertCacheBlock(address, mem_op_type == Core::READ ? CacheState::SHARED : CacheState::MODIFIED, data_buf, m_core_id, ShmemPerfModel::_USER_THREAD, isPrefetch != Prefetch::NONE);
                if (isPrefetch != Prefetch::NONE)
                   getCacheBlockInfo(address)->setOption(CacheBlockInfo::PREFETCH);
 
@@ -1010,6 +1077,9 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
 
    if (modeled && m_master->m_prefetcher)
    {
+      // Only demand accesses give feedback, and whether they missed is known from before the line was brought in
+      if (isPrefetch == Prefetch::NONE && count)
+         notifyPrefetchThrottle(address, first_hit, prefetch_hit, prefetch_late);
       trainPrefetcher(address, cache_hit, prefetch_hit, t_issue);
    }
 
@@ -1152,7 +1222,7 @@ CacheCntlr::initiateDirectoryAccess(Core::mem_op_t mem_op_type, IntPtr address,
       if (exclusive)
       {
          SharedCacheBlockInfo* cache_block_info = getCacheBlockInfo(address);
-         if (cache_block_info && (cache_block_info->getCState() == CacheState::SHARED))
+         if (cache_block_info && (cache_block_info->getCState() == CacheState::SHARED || cache_block_info->getCState() == CacheState::OWNED))
          {
             processUpgradeReqToDirectory(address, m_shmem_perf, ShmemPerfModel::_USER_THREAD);
          }
@@ -1200,7 +1270,7 @@ CacheCntlr::processUpgradeReqToDirectory(IntPtr address, ShmemPerf *perf, ShmemP
    MYLOG("UPGR REQ @ %lx", address);
 
    CacheState::cstate_t cstate = getCacheState(address);
-   assert(cstate == CacheState::SHARED);
+   assert(cstate == CacheState::SHARED || cstate == CacheState::OWNED);
    setCacheState(address, CacheState::SHARED_UPGRADING);
 
    getMemoryManager()->sendMsg(PrL1PrL2DramDirectoryMSI::ShmemMsg::UPGRADE_REQ,
@@ -1265,6 +1335,37 @@ CacheCntlr::operationPermissibleinCache(
    return cache_hit;
 }
 
+bool
+CacheCntlr::optimisticHit(IntPtr address, Core::mem_op_t mem_op_type, CacheBlockInfo **cache_block_info, CacheState::cstate_t *cstate)
+{
+   // Stores, perfect and pass-through caches, and hits that update the line's state need the lock
+   if (mem_op_type != Core::READ || m_perfect || m_passthrough || Sim()->getConfig()->hasCacheEfficiencyCallbacks())
+      return false;
+
+   SetLock *setlock = lastLevelCache()->m_master->getSetLock(address);
+   UInt64 version;
+   bool hit = setlock->read_begin(version)
+      && operationPermissibleinCache(address, mem_op_type, cache_block_info)
+      && !(*cache_block_info)->hasOption(CacheBlockInfo::WARMUP)
+      && !(*cache_block_info)->hasOption(CacheBlockInfo::PREFETCH);
+   if (hit)
+   {
+      *cstate = getCacheState(*cache_block_info);
+      hit = setlock->read_validate(version);
+   }
+
+   /* The hit is ordered at the validation point: the lookup, state and options read above are consistent.
+      Only the replacement update in accessCache() happens after it, without the lock. It looks the line up
+      by tag again, so a line evicted in the meantime is skipped, but it can race with a concurrent fill's
+      replacement decision in the same set. We accept that this may perturb the set's replacement order;
+      it cannot change any line's state, data, or coherence. */
+   if (hit)
+      __sync_fetch_and_add(&stats.optimistic_hits, 1);
+   else
+      __sync_fetch_and_add(&stats.optimistic_fallbacks, 1);
+   return hit;
+}
+
 
 void
 CacheCntlr::accessCache(
@@ -1276,12 +1377,12 @@ CacheCntlr::accessCache(
       case Core::READ:
       case Core::READ_EX:
          m_master->m_cache->accessSingleLine(ca_address + offset, Cache::LOAD, data_buf, data_length,
-                                             getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD), update_replacement);
+                                             getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD), update_replacement, this);
          break;
 
       case Core::WRITE:
          m_master->m_cache->accessSingleLine(ca_address + offset, Cache::STORE, data_buf, data_length,
-                                             getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD), update_replacement);
+                                             getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD), update_replacement, this);
          // Write-through cache - Write the next level cache also
          if (m_cache_writethrough) {
             LOG_ASSERT_ERROR(m_next_cache_cntlr, "Writethrough enabled on last-level cache !?");
@@ -1350,7 +1451,7 @@ void
 CacheCntlr::retrieveCacheBlock(IntPtr address, Byte* data_buf, ShmemPerfModel::Thread_t thread_num, bool update_replacement)
 {
    __attribute__((unused)) SharedCacheBlockInfo* cache_block_info = (SharedCacheBlockInfo*) m_master->m_cache->accessSingleLine(
-      address, Cache::LOAD, data_buf, getCacheBlockSize(), getShmemPerfModel()->getElapsedTime(thread_num), update_replacement);
+      address, Cache::LOAD, data_buf, getCacheBlockSize(), getShmemPerfModel()->getElapsedTime(thread_num), update_replacement, this);
    LOG_ASSERT_ERROR(cache_block_info != NULL, "Expected block to be there but it wasn't");
 }
 
@@ -1360,7 +1461,7 @@ CacheCntlr::retrieveCacheBlock(IntPtr address, Byte* data_buf, ShmemPerfModel::T
  *****************************************************************************/
 
 SharedCacheBlockInfo*
-CacheCntlr::insertCacheBlock(IntPtr address, CacheState::cstate_t cstate, Byte* data_buf, core_id_t requester, ShmemPerfModel::Thread_t thread_num)
+CacheCntlr::insertCacheBlock(IntPtr address, CacheState::cstate_t cstate, Byte* data_buf, core_id_t requester, ShmemPerfModel::Thread_t thread_num, bool is_prefetch)
 {
 MYLOG("insertCacheBlock l%d @ %lx as %c (now %c)", m_mem_component, address, CStateString(cstate), CStateString(getCacheState(address)));
    bool eviction;
@@ -1416,6 +1517,9 @@ MYLOG("evicting @%lx", evict_address);
             ++stats.evict_prefetch;
          if (evict_block_info.hasOption(CacheBlockInfo::WARMUP))
             ++stats.evict_warmup;
+         // Remember lines pushed out by prefetches, a later miss to them counts as pollution
+         if (is_prefetch && m_master->m_prefetch_throttle)
+            m_master->m_prefetch_throttle->prefetchEviction(evict_address);
       }
 
       /* TODO: this part looks a lot like updateCacheBlock's dirty case, but with the eviction buffer
@@ -1493,7 +1597,7 @@ MYLOG("evicting @%lx", evict_address);
       {
          /* Send dirty block to directory */
          UInt32 home_node_id = getHome(evict_address);
-         if (evict_block_info.getCState() == CacheState::MODIFIED)
+         if (evict_block_info.getCState() == CacheState::MODIFIED || evict_block_info.getCState() == CacheState::OWNED)
          {
             // Send back the data also
 MYLOG("evict FLUSH %lx", evict_address);
@@ -1546,7 +1650,8 @@ CacheCntlr::updateCacheBlock(IntPtr address, CacheState::cstate_t new_cstate, Tr
    {
       for(CacheCntlrList::iterator it = m_master->m_prev_cache_cntlrs.begin(); it != m_master->m_prev_cache_cntlrs.end(); it++) {
          std::pair<SubsecondTime, bool> res = (*it)->updateCacheBlock(
-            address, new_cstate, reason == Transition::EVICT ? Transition::BACK_INVAL : reason, NULL, thread_num);
+            address, new_cstate == CacheState::OWNED ? CacheState::SHARED : new_cstate,
+            reason == Transition::EVICT ? Transition::BACK_INVAL : reason, NULL, thread_num);
          // writeback_time is for the complete stack, so only model it at the last level, ignore latencies returned by previous ones
          //latency = getMax<SubsecondTime>(latency, res.first);
          sibling_hit |= res.second;
@@ -1584,7 +1689,7 @@ CacheCntlr::updateCacheBlock(IntPtr address, CacheState::cstate_t new_cstate, Tr
          );
          if (reason == Transition::COHERENCY)
          {
-            if (new_cstate == CacheState::SHARED)
+            if (new_cstate == CacheState::SHARED || new_cstate == CacheState::OWNED)
                ++stats.coherency_downgrades;
             else if (cache_block_info->getCState() == CacheState::MODIFIED)
                ++stats.coherency_writebacks;
@@ -1646,7 +1751,7 @@ CacheCntlr::updateCacheBlock(IntPtr address, CacheState::cstate_t new_cstate, Tr
          if (m_coherent)
             invalidateCacheBlock(address);
       }
-      else if (new_cstate == CacheState::SHARED)
+      else if (new_cstate == CacheState::SHARED || new_cstate == CacheState::OWNED)
       {
          if (out_buf)
          {
@@ -1863,6 +1968,17 @@ MYLOG("woke up all");
 MYLOG("done");
 }
 
+bool
+CacheCntlr::isPrefetchFill(IntPtr address)
+{
+   // Only needed for pollution tracking, which is done by the prefetch throttle
+   if (!m_master->m_prefetch_throttle)
+      return false;
+
+   ScopedLock sl(getLock());
+   return !m_master->m_directory_waiters.empty(address) && m_master->m_directory_waiters.front(address)->isPrefetch;
+}
+
 void
 CacheCntlr::processExRepFromDramDirectory(core_id_t sender, core_id_t requester, PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg)
 {
@@ -1873,7 +1989,7 @@ MYLOG("processExRepFromDramDirectory l%d", m_mem_component);
    IntPtr address = shmem_msg->getAddress();
    Byte* data_buf = shmem_msg->getDataBuf();
 
-   insertCacheBlock(address, CacheState::EXCLUSIVE, data_buf, requester, ShmemPerfModel::_SIM_THREAD);
+   insertCacheBlock(address, CacheState::EXCLUSIVE, data_buf, requester, ShmemPerfModel::_SIM_THREAD, isPrefetchFill(address));
 MYLOG("processExRepFromDramDirectory l%d end", m_mem_component);
 }
 
@@ -1888,7 +2004,7 @@ MYLOG("processShRepFromDramDirectory l%d", m_mem_component);
    Byte* data_buf = shmem_msg->getDataBuf();
 
    // Insert Cache Block in L2 Cache
-   insertCacheBlock(address, CacheState::SHARED, data_buf, requester, ShmemPerfModel::_SIM_THREAD);
+   insertCacheBlock(address, CacheState::SHARED, data_buf, requester, ShmemPerfModel::_SIM_THREAD, isPrefetchFill(address));
 }
 
 void
@@ -1930,7 +2046,12 @@ CacheCntlr::processInvReqFromDramDirectory(core_id_t sender, PrL1PrL2DramDirecto
 MYLOG("processInvReqFromDramDirectory l%d", m_mem_component);
 
    CacheState::cstate_t cstate = getCacheState(address);
-   if (cstate != CacheState::INVALID)
+   if (cstate == CacheState::OWNED || (m_moesi && cstate == CacheState::SHARED_UPGRADING))
+   {
+      // We may hold the only up-to-date copy (an upgrading line may have been OWNED), write it back rather than dropping it
+      processFlushReqFromDramDirectory(sender, shmem_msg);
+   }
+   else if (cstate != CacheState::INVALID)
    {
       if (cstate != CacheState::SHARED)
       {
@@ -2016,14 +2137,16 @@ MYLOG("processWbReqFromDramDirectory l%d", m_mem_component);
 
       // Write-Back the line
       Byte data_buf[getCacheBlockSize()];
+      // MOESI: dirty data is not written back but kept as OWNED, we will supply it to future readers
+      bool keep_owned = m_moesi && (cstate == CacheState::MODIFIED || cstate == CacheState::OWNED);
       if (cstate != CacheState::SHARED_UPGRADING)
       {
-         updateCacheBlock(address, CacheState::SHARED, Transition::COHERENCY, data_buf, ShmemPerfModel::_SIM_THREAD);
+         updateCacheBlock(address, keep_owned ? CacheState::OWNED : CacheState::SHARED, Transition::COHERENCY, data_buf, ShmemPerfModel::_SIM_THREAD);
       }
 
       shmem_msg->getPerf()->updateTime(getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD), ShmemPerf::REMOTE_CACHE_FWD);
 
-      getMemoryManager()->sendMsg(PrL1PrL2DramDirectoryMSI::ShmemMsg::WB_REP,
+      getMemoryManager()->sendMsg(keep_owned ? PrL1PrL2DramDirectoryMSI::ShmemMsg::WB_REP_OWNED : PrL1PrL2DramDirectoryMSI::ShmemMsg::WB_REP,
             MemComponent::LAST_LEVEL_CACHE, MemComponent::TAG_DIR,
             shmem_msg->getRequester() /* requester */,
             sender /* receiver */,
@@ -2168,7 +2291,8 @@ CacheCntlr::updateUncoreStatistics(HitWhere::where_t hit_where, SubsecondTime no
    - we want to allow concurrent access for operations that only touch the first-level cache
    - we want concurrent access to different addresses as much as possible
 
-   Master last-level cache contains one shared/exclusive-lock per set (according to the first-level cache's set size)
+   Master last-level cache contains one shared/exclusive-lock per set (according to the first-level cache's set size),
+   or per group of sets when perf_model/cache/set_lock_stripes limits the number of locks
    - First-level cache transactions acquire the lock pertaining to the set they'll use in shared mode.
      Multiple first-level caches can do this simultaneously.
      Since only a single thread accesses each L1, there should be no extra per-cache lock needed
@@ -2179,6 +2303,9 @@ CacheCntlr::updateUncoreStatistics(HitWhere::where_t hit_where, SubsecondTime no
    - (On Nehalem, the L2 is private so it is only the L3 (the first level with m_sharing_cores > 1) that takes the exclusive lock).
    #endif
 
+   With perf_model/cache/optimistic_hits, first-level load hits skip the shared lock altogether: they validate their
+   lookup against the lock's version, which changes whenever the lock is held exclusively (fills, evictions, invalidations).
+
    Additionally, for per-cache objects that are not private to a cache set, each cache controller has its own (normal) lock,
    use getLock() for this. This is required for statistics updates, the directory waiters queue, etc.
 */
@@ -2189,7 +2316,14 @@ CacheCntlr::acquireLock(UInt64 address)
 MYLOG("cache lock acquire %u # %u @ %lx", m_mem_component, m_core_id, address);
    assert(isFirstLevel());
    // Lock this L1 cache for the set containing <address>.
-   lastLevelCache()->m_master->getSetLock(address)->acquire_shared(m_core_id);
+   if (m_lock_stats)
+   {
+      UInt64 wait_ns = 0;
+      lastLevelCache()->m_master->getSetLock(address)->acquire_shared(m_core_id, &wait_ns);
+      updateLockStats(wait_ns);
+   }
+   else
+      lastLevelCache()->m_master->getSetLock(address)->acquire_shared(m_core_id);
 }
 
 void
@@ -2205,12 +2339,15 @@ CacheCntlr::acquireStackLock(UInt64 address, bool this_is_locked)
 {
 MYLOG("stack lock acquire %u # %u @ %lx", m_mem_component, m_core_id, address);
    // Lock the complete stack for the set containing <address>
+   UInt64 wait_ns = 0;
    if (this_is_locked)
       // If two threads decide to upgrade at the same time, we could deadlock.
       // Upgrade therefore internally releases the cache lock!
-      lastLevelCache()->m_master->getSetLock(address)->upgrade(m_core_id);
+      lastLevelCache()->m_master->getSetLock(address)->upgrade(m_core_id, m_lock_stats ? &wait_ns : NULL);
    else
-      lastLevelCache()->m_master->getSetLock(address)->acquire_exclusive();
+      lastLevelCache()->m_master->getSetLock(address)->acquire_exclusive(m_lock_stats ? &wait_ns : NULL);
+   if (m_lock_stats)
+      updateLockStats(wait_ns);
 }
 
 void
@@ -2223,6 +2360,18 @@ MYLOG("stack lock release %u # %u @ %lx", m_mem_component, m_core_id, address);
       lastLevelCache()->m_master->getSetLock(address)->release_exclusive();
 }
 
+void
+CacheCntlr::updateLockStats(UInt64 wait_ns)
+{
+   // Set locks are taken by both the user and the network thread, don't use getLock() here as it may be held already
+   __sync_fetch_and_add(&stats.setlock_acquires, 1);
+   if (wait_ns)
+   {
+      __sync_fetch_and_add(&stats.setlock_contended, 1);
+      __sync_fetch_and_add(&stats.setlock_wait_ns, wait_ns);
+   }
+}
+
 
 CacheCntlr*
 CacheCntlr::lastLevelCache()
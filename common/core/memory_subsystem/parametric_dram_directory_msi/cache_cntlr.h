@@ -3,6 +3,7 @@
 #include "core.h"
 #include "cache.h"
 #include "prefetcher.h"
+#include "prefetch_throttle.h"
 #include "shared_cache_block_info.h"
 #include "address_home_lookup.h"
 #include "../pr_l1_pr_l2_dram_directory_msi/shmem_msg.h"
@@ -154,6 +155,7 @@ namespace ParametricDramDirectoryMSI
          Lock m_smt_lock; //< Only used in L1 cache, to protect against concurrent access from sibling SMT threads
          CacheCntlrList m_prev_cache_cntlrs;
          Prefetcher* m_prefetcher;
+         PrefetchThrottle* m_prefetch_throttle;
          DramCntlrInterface* m_dram_cntlr;
          ContentionModel* m_dram_outstanding_writebacks;
 
@@ -183,6 +185,7 @@ namespace ParametricDramDirectoryMSI
          CacheMasterCntlr(String name, core_id_t core_id, UInt32 outstanding_misses)
             : m_cache(NULL)
             , m_prefetcher(NULL)
+            , m_prefetch_throttle(NULL)
             , m_dram_cntlr(NULL)
             , m_dram_outstanding_writebacks(NULL)
             , m_l1_mshr(name + ".mshr", core_id, outstanding_misses)
@@ -214,6 +217,9 @@ namespace ParametricDramDirectoryMSI
          bool m_coherent;
          bool m_prefetch_on_prefetch_hit;
          bool m_l1_mshr;
+         bool m_optimistic_hits;
+         bool m_lock_stats;
+         bool m_moesi;
 
          struct {
            UInt64 loads, stores;
@@ -239,6 +245,9 @@ namespace ParametricDramDirectoryMSI
            SubsecondTime mshr_latency;
            UInt64 prefetches;
            UInt64 coherency_downgrades, coherency_upgrades, coherency_invalidates, coherency_writebacks;
+           UInt64 coherency_upgrades_avoided;
+           UInt64 optimistic_hits, optimistic_fallbacks;
+           UInt64 setlock_acquires, setlock_contended, setlock_wait_ns;
            #ifdef ENABLE_TRANSITIONS
            UInt64 transitions[CacheState::NUM_CSTATE_SPECIAL_STATES][CacheState::NUM_CSTATE_SPECIAL_STATES];
            UInt64 transition_reasons[Transition::NUM_REASONS][CacheState::NUM_CSTATE_SPECIAL_STATES][CacheState::NUM_CSTATE_SPECIAL_STATES];
@@ -275,6 +284,10 @@ namespace ParametricDramDirectoryMSI
 
          ShmemPerfModel* m_shmem_perf_model;
 
+         // PC of the core access this controller is handling. Every core has its own controller
+         // at each level, so requests from different cores do not overwrite each other's PC.
+         IntPtr m_access_eip;
+
          // Core-interfacing stuff
          void accessCache(
                Core::mem_op_t mem_op_type,
@@ -282,9 +295,12 @@ namespace ParametricDramDirectoryMSI
                Byte* data_buf, UInt32 data_length, bool update_replacement);
          bool operationPermissibleinCache(
                IntPtr address, Core::mem_op_t mem_op_type, CacheBlockInfo **cache_block_info = NULL);
+         bool optimisticHit(IntPtr address, Core::mem_op_t mem_op_type, CacheBlockInfo **cache_block_info, CacheState::cstate_t *cstate);
 
-         void copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_start);
+         void copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_start, bool is_prefetch);
          void trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue);
+         void notifyPrefetchThrottle(IntPtr address, bool cache_hit, bool prefetch_hit, bool prefetch_late);
+         bool isPrefetchFill(IntPtr address);
          void Prefetch(SubsecondTime t_start);
          void doPrefetch(IntPtr prefetch_address, SubsecondTime t_start);
 
@@ -299,7 +315,7 @@ namespace ParametricDramDirectoryMSI
          void retrieveCacheBlock(IntPtr address, Byte* data_buf, ShmemPerfModel::Thread_t thread_num, bool update_replacement);
 
 
-         SharedCacheBlockInfo* insertCacheBlock(IntPtr address, CacheState::cstate_t cstate, Byte* data_buf, core_id_t requester, ShmemPerfModel::Thread_t thread_num);
+         SharedCacheBlockInfo* insertCacheBlock(IntPtr address, CacheState::cstate_t cstate, Byte* data_buf, core_id_t requester, ShmemPerfModel::Thread_t thread_num, bool is_prefetch = false);
          std::pair<SubsecondTime, bool> updateCacheBlock(IntPtr address, CacheState::cstate_t cstate, Transition::reason_t reason, Byte* out_buf, ShmemPerfModel::Thread_t thread_num);
          void writeCacheBlock(IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length, ShmemPerfModel::Thread_t thread_num);
 
@@ -347,6 +363,7 @@ namespace ParametricDramDirectoryMSI
          core_id_t getHome(IntPtr address) { return m_tag_directory_home_lookup->getHome(address); }
 
          CacheCntlr* lastLevelCache(void);
+         void updateLockStats(UInt64 wait_ns);
 
       public:
 
@@ -378,7 +395,8 @@ namespace ParametricDramDirectoryMSI
                IntPtr ca_address, UInt32 offset,
                Byte* data_buf, UInt32 data_length,
                bool modeled,
-               bool count);
+               bool count,
+               IntPtr eip = 0);
          void updateHits(Core::mem_op_t mem_op_type, UInt64 hits);
 
          // Notify next level cache of so it can update its sharing set
@@ -400,6 +418,7 @@ namespace ParametricDramDirectoryMSI
 
          bool isInLowerLevelCache(CacheBlockInfo *block_info);
          void incrementQBSLookupCost();
+         IntPtr getAccessEip() { return m_access_eip; }
 
          void enable() { m_master->m_cache->enable(); }
          void disable() { m_master->m_cache->disable(); }
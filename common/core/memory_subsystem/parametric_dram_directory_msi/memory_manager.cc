@@ -14,6 +14,7 @@
 #include "topology_info.h"
 
 #include <algorithm>
+#include <cmath>
 
 #if 0
    extern Lock iolock;
@@ -57,6 +58,8 @@ MemoryManager::MemoryManager(Core* core,
    bool dram_direct_access = false;
    UInt32 dram_directory_total_entries = 0;
    UInt32 dram_directory_associativity = 0;
+   UInt32 dram_directory_region_size = 1;
+   double dram_directory_coverage = 0;
    UInt32 dram_directory_max_num_sharers = 0;
    UInt32 dram_directory_max_hw_sharers = 0;
    String dram_directory_type_str;
@@ -169,6 +172,8 @@ MemoryManager::MemoryManager(Core* core,
       // Dram Directory Cache
       dram_directory_total_entries = Sim()->getCfg()->getInt("perf_model/dram_directory/total_entries");
       dram_directory_associativity = Sim()->getCfg()->getInt("perf_model/dram_directory/associativity");
+      dram_directory_region_size = Sim()->getCfg()->getInt("perf_model/dram_directory/region_size");
+      dram_directory_coverage = Sim()->getCfg()->getFloat("perf_model/dram_directory/coverage");
       dram_directory_max_num_sharers = Sim()->getConfig()->getTotalCores();
       dram_directory_max_hw_sharers = Sim()->getCfg()->getInt("perf_model/dram_directory/max_hw_sharers");
       dram_directory_type_str = Sim()->getCfg()->getString("perf_model/dram_directory/directory_type");
@@ -220,6 +225,24 @@ MemoryManager::MemoryManager(Core* core,
    }
 
    m_tag_directory_home_lookup = new AddressHomeLookup(dram_directory_home_lookup_param, core_list_with_tag_directories, getCacheBlockSize());
+
+   // A region entry only saves directory space if all of its blocks have the same home
+   LOG_ASSERT_ERROR(core_list_with_tag_directories.size() == 1
+                    || dram_directory_region_size * getCacheBlockSize() <= (1UL << dram_directory_home_lookup_param),
+                    "perf_model/dram_directory/region_size (%u blocks) is larger than the directory interleaving granularity (home_lookup_param = %u)",
+                    dram_directory_region_size, dram_directory_home_lookup_param);
+
+   if (dram_directory_coverage > 0)
+   {
+      // Sparse directory: size each directory slice relative to the total number of lines in the last-level caches
+      // (which contain everything the directory tracks), rather than using a fixed number of entries.
+      UInt64 llc_lines = UInt64(Sim()->getConfig()->getApplicationCores()) / cache_parameters[m_last_level_cache].shared_cores
+                       * cache_parameters[m_last_level_cache].size * 1024 / getCacheBlockSize();
+      UInt64 slice_entries = UInt64(ceil(dram_directory_coverage * llc_lines / (dram_directory_region_size * core_list_with_tag_directories.size())));
+      UInt64 num_sets = (slice_entries + dram_directory_associativity - 1) / dram_directory_associativity;
+      num_sets = num_sets > 1 ? 1UL << ceilLog2(num_sets) : 1;
+      dram_directory_total_entries = num_sets * dram_directory_associativity;
+   }
    m_dram_controller_home_lookup = new AddressHomeLookup(dram_directory_home_lookup_param, core_list_with_dram_controllers, getCacheBlockSize());
 
    // if (m_core->getId() == 0)
@@ -264,6 +287,7 @@ MemoryManager::MemoryManager(Core* core,
                m_nuca_cache,
                dram_directory_total_entries,
                dram_directory_associativity,
+               dram_directory_region_size,
                getCacheBlockSize(),
                dram_directory_max_num_sharers,
                dram_directory_max_hw_sharers,
@@ -352,6 +376,16 @@ MemoryManager::MemoryManager(Core* core,
          // FIXME: We really should check all cache levels
       }
 
+      // Stripe the sets over fewer locks: each lock then covers a group of sets. Every lock holds a cache line
+      // per sharing core, so this keeps the lock array small on many-core configurations, at the cost of
+      // more conflicts between accesses to different sets.
+      UInt32 stripes = Sim()->getCfg()->getInt("perf_model/cache/set_lock_stripes");
+      if (stripes)
+      {
+         LOG_ASSERT_ERROR(stripes == (1UL << floorLog2(stripes)), "perf_model/cache/set_lock_stripes must be a power of two");
+         num_sets = std::min(num_sets, stripes);
+      }
+
       m_cache_cntlrs[(UInt32)m_last_level_cache]->createSetLocks(
          getCacheBlockSize(),
          num_sets,
@@ -421,7 +455,8 @@ MemoryManager::coreInitiateMemoryAccess(
       Core::mem_op_t mem_op_type,
       IntPtr address, UInt32 offset,
       Byte* data_buf, UInt32 data_length,
-      Core::MemModeled modeled)
+      Core::MemModeled modeled,
+      IntPtr eip)
 {
    LOG_ASSERT_ERROR(mem_component <= m_last_level_cache,
       "Error: invalid mem_component (%d) for coreInitiateMemoryAccess", mem_component);
@@ -437,7 +472,36 @@ MemoryManager::coreInitiateMemoryAccess(
          address, offset,
          data_buf, data_length,
          modeled == Core::MEM_MODELED_NONE || modeled == Core::MEM_MODELED_COUNT ? false : true,
-         modeled == Core::MEM_MODELED_NONE ? false : true);
+         modeled == Core::MEM_MODELED_NONE ? false : true,
+         eip);
+}
+
+void
+MemoryManager::getCheckpointLines(std::vector<CheckpointLine> &lines)
+{
+   for(int level = m_last_level_cache; level >= (int)MemComponent::L1_ICACHE; --level)
+   {
+      CacheCntlr *cache_cntlr = m_cache_cntlrs[(MemComponent::component_t)level];
+      if (!cache_cntlr->isMasterCache())
+         continue;
+
+      Cache *cache = cache_cntlr->getCache();
+      for(UInt32 set_index = 0; set_index < cache->getNumSets(); ++set_index)
+      {
+         for(UInt32 way = 0; way < cache->getAssociativity(); ++way)
+         {
+            CacheBlockInfo *block_info = cache->peekBlock(set_index, way);
+            if (block_info && block_info->isValid())
+            {
+               CheckpointLine line;
+               line.mem_component = (MemComponent::component_t)level;
+               line.address = cache->tagToAddress(block_info->getTag());
+               line.dirty = block_info->getCState() == CacheState::MODIFIED || block_info->getCState() == CacheState::OWNED;
+               lines.push_back(line);
+            }
+         }
+      }
+   }
 }
 
 void
@@ -88,7 +88,10 @@ namespace ParametricDramDirectoryMSI
                Core::mem_op_t mem_op_type,
                IntPtr address, UInt32 offset,
                Byte* data_buf, UInt32 data_length,
-               Core::MemModeled modeled);
+               Core::MemModeled modeled,
+               IntPtr eip = 0);
+
+         void getCheckpointLines(std::vector<CheckpointLine> &lines);
 
          void handleMsgFromNetwork(NetPacket& packet);
 
@@ -5,6 +5,7 @@
 #include "stats.h"
 #include "queue_model.h"
 #include "shmem_perf.h"
+#include "thermal_insertion_policy.h"
 
 NucaCache::NucaCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_perf_model, AddressHomeLookup* home_lookup, UInt32 cache_block_size, ParametricDramDirectoryMSI::CacheParameters& parameters)
    : m_core_id(memory_manager->getCore()->getId())
@@ -16,6 +17,7 @@ NucaCache::NucaCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
    , m_tags_access_time(parameters.tags_access_time)
    , m_data_array_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/nuca/bandwidth"))
    , m_queue_model(NULL)
+   , m_thermal_policy(NULL)
    , m_reads(0)
    , m_writes(0)
    , m_read_misses(0)
@@ -40,6 +42,8 @@ NucaCache::NucaCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
       m_queue_model = QueueModel::create("nuca-cache-queue", m_core_id, queue_model_type, m_data_array_bandwidth.getRoundedLatency(8 * m_cache_block_size)); // bytes to bits
    }
 
+   m_thermal_policy = new ThermalInsertionPolicy("nuca-cache", "nuca", m_core_id);
+
    registerStatsMetric("nuca-cache", m_core_id, "reads", &m_reads);
    registerStatsMetric("nuca-cache", m_core_id, "writes", &m_writes);
    registerStatsMetric("nuca-cache", m_core_id, "read-misses", &m_read_misses);
@@ -49,6 +53,7 @@ NucaCache::NucaCache(MemoryManagerBase* memory_manager, ShmemPerfModel* shmem_pe
 NucaCache::~NucaCache()
 {
    delete m_cache;
+   delete m_thermal_policy;
    if (m_queue_model)
       delete m_queue_model;
 }
@@ -69,6 +74,7 @@ NucaCache::read(IntPtr address, Byte* data_buf, SubsecondTime now, ShmemPerf *pe
 
       latency += accessDataArray(Cache::LOAD, now + latency, perf);
       hit_where = HitWhere::NUCA_CACHE;
+      if (count) m_thermal_policy->hit(address, m_core_id);
    }
    else
    {
@@ -94,6 +100,20 @@ NucaCache::write(IntPtr address, Byte* data_buf, bool& eviction, IntPtr& evict_a
 
       latency += accessDataArray(Cache::STORE, now + latency, &m_dummy_shmem_perf);
       hit_where = HitWhere::NUCA_CACHE;
+      if (count) m_thermal_policy->hit(address, m_core_id);
+   }
+   else if (!m_thermal_policy->shouldInsert(address, m_core_id))
+   {
+      // Bypassed: writebacks (count == true) go to DRAM through the eviction path of the caller,
+      // clean copies of lines read from DRAM are simply dropped
+      eviction = count;
+      if (eviction)
+      {
+         evict_address = address;
+         memcpy(evict_buf, data_buf, m_cache_block_size);
+      }
+
+      if (count) ++m_write_misses;
    }
    else
    {
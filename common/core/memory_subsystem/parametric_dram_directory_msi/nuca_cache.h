@@ -13,6 +13,7 @@ class ShmemPerfModel;
 class AddressHomeLookup;
 class QueueModel;
 class ShmemPerf;
+class ThermalInsertionPolicy;
 
 class NucaCache
 {
@@ -28,6 +29,7 @@ class NucaCache
 
       Cache* m_cache;
       QueueModel *m_queue_model;
+      ThermalInsertionPolicy *m_thermal_policy;
 
       UInt64 m_reads, m_writes, m_read_misses, m_write_misses;
 
@@ -0,0 +1,117 @@
+#include "prefetch_throttle.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "stats.h"
+#include "log.h"
+
+PrefetchThrottle::PrefetchThrottle(String name, core_id_t core_id)
+   : m_interval(Sim()->getCfg()->getInt("perf_model/cache/prefetch_throttle/interval"))
+   , m_max_degree(Sim()->getCfg()->getInt("perf_model/cache/prefetch_throttle/max_degree"))
+   , m_accuracy_high(Sim()->getCfg()->getFloat("perf_model/cache/prefetch_throttle/accuracy_high"))
+   , m_accuracy_low(Sim()->getCfg()->getFloat("perf_model/cache/prefetch_throttle/accuracy_low"))
+   , m_lateness_threshold(Sim()->getCfg()->getFloat("perf_model/cache/prefetch_throttle/lateness"))
+   , m_pollution_threshold(Sim()->getCfg()->getFloat("perf_model/cache/prefetch_throttle/pollution"))
+   , m_pollution_filter(Sim()->getCfg()->getInt("perf_model/cache/prefetch_throttle/pollution_filter_size"), false)
+   , m_interval_issued(0)
+   , m_issued(0), m_useful(0), m_late(0), m_pollution(0), m_misses(0)
+   , m_count_late(0)
+   , m_count_pollution(0)
+   , m_throttle_up(0)
+   , m_throttle_down(0)
+{
+   LOG_ASSERT_ERROR(m_interval > 0, "perf_model/cache/prefetch_throttle/interval must be > 0");
+   LOG_ASSERT_ERROR(m_max_degree > 0, "perf_model/cache/prefetch_throttle/max_degree must be > 0");
+   LOG_ASSERT_ERROR(m_pollution_filter.size() > 0, "perf_model/cache/prefetch_throttle/pollution_filter_size must be > 0");
+
+   // Start out in the middle, from where we can move either way
+   m_degree = (m_max_degree + 1) / 2;
+   m_count_degree = m_degree;
+
+   registerStatsMetric(name, core_id, "prefetch-late", &m_count_late);
+   registerStatsMetric(name, core_id, "prefetch-pollution", &m_count_pollution);
+   registerStatsMetric(name, core_id, "prefetch-degree", &m_count_degree);
+   registerStatsMetric(name, core_id, "prefetch-throttle-up", &m_throttle_up);
+   registerStatsMetric(name, core_id, "prefetch-throttle-down", &m_throttle_down);
+}
+
+void
+PrefetchThrottle::limit(std::vector<IntPtr> &addresses) const
+{
+   if (addresses.size() > m_degree)
+      addresses.resize(m_degree);
+}
+
+void
+PrefetchThrottle::prefetchIssued()
+{
+   ++m_issued;
+   if (++m_interval_issued >= m_interval)
+   {
+      evaluate();
+      m_interval_issued = 0;
+   }
+}
+
+void
+PrefetchThrottle::prefetchUseful(bool late)
+{
+   ++m_useful;
+   if (late)
+   {
+      ++m_late;
+      ++m_count_late;
+   }
+}
+
+void
+PrefetchThrottle::demandMiss(IntPtr address)
+{
+   ++m_misses;
+   UInt32 index = filterIndex(address);
+   if (m_pollution_filter[index])
+   {
+      // This miss would not have happened without a prefetch
+      ++m_pollution;
+      ++m_count_pollution;
+      m_pollution_filter[index] = false;
+   }
+}
+
+void
+PrefetchThrottle::prefetchEviction(IntPtr evict_address)
+{
+   m_pollution_filter[filterIndex(evict_address)] = true;
+}
+
+void
+PrefetchThrottle::evaluate()
+{
+   float accuracy = m_issued ? m_useful / m_issued : 0;
+   bool late = m_useful && m_late / m_useful > m_lateness_threshold;
+   bool polluting = m_misses && m_pollution / m_misses > m_pollution_threshold;
+
+   SInt32 delta;
+   if (accuracy >= m_accuracy_high)
+      // Accurate prefetches: get them out earlier if they are late, back off only if they hurt demand lines
+      delta = late ? 1 : polluting ? -1 : 0;
+   else if (accuracy >= m_accuracy_low)
+      delta = late && !polluting ? 1 : polluting ? -1 : 0;
+   else
+      // Mostly useless prefetches are only wasting bandwidth
+      delta = -1;
+
+   if (delta > 0 && m_degree < m_max_degree)
+   {
+      ++m_degree;
+      ++m_throttle_up;
+   }
+   else if (delta < 0 && m_degree > 1)
+   {
+      --m_degree;
+      ++m_throttle_down;
+   }
+   m_count_degree = m_degree;
+
+   // Give the previous intervals half the weight of the next one
+   m_issued /= 2; m_useful /= 2; m_late /= 2; m_pollution /= 2; m_misses /= 2;
+}
@@ -0,0 +1,53 @@
+#ifndef __PREFETCH_THROTTLE_H
+#define __PREFETCH_THROTTLE_H
+
+#include "fixed_types.h"
+
+#include <vector>
+
+// Feedback-directed prefetch throttling [Srinath et al., HPCA'07]
+// Measures prefetch accuracy, lateness and cache pollution over intervals of issued prefetches,
+// and raises or lowers the number of prefetches issued per trigger accordingly.
+// Only created when perf_model/cache/prefetch_throttle/enabled is set.
+class PrefetchThrottle
+{
+   public:
+      PrefetchThrottle(String name, core_id_t core_id);
+
+      // Drop the prefetch candidates beyond the current degree
+      void limit(std::vector<IntPtr> &addresses) const;
+
+      void prefetchIssued();
+      // A demand access hit a prefetched line, which was late if the prefetch had not completed yet
+      void prefetchUseful(bool late);
+      void demandMiss(IntPtr address);
+      // A prefetch fill evicted this line
+      void prefetchEviction(IntPtr evict_address);
+
+   private:
+      const UInt32 m_interval;
+      const UInt32 m_max_degree;
+      const float m_accuracy_high;
+      const float m_accuracy_low;
+      const float m_lateness_threshold;
+      const float m_pollution_threshold;
+
+      // Bit per (hashed) address: was this line evicted by a prefetch
+      std::vector<bool> m_pollution_filter;
+
+      UInt32 m_degree;
+      UInt32 m_interval_issued;
+      // Decayed counts of the current and previous intervals
+      float m_issued, m_useful, m_late, m_pollution, m_misses;
+
+      UInt64 m_count_late;
+      UInt64 m_count_pollution;
+      UInt64 m_count_degree;
+      UInt64 m_throttle_up;
+      UInt64 m_throttle_down;
+
+      UInt32 filterIndex(IntPtr address) const { return (address ^ (address >> 16)) % m_pollution_filter.size(); }
+      void evaluate();
+};
+
+#endif // __PREFETCH_THROTTLE_H
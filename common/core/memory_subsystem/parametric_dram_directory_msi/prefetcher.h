@@ -8,9 +8,17 @@
 class Prefetcher
 {
    public:
-      static Prefetcher* createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores);
+      static Prefetcher* createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores, UInt32 cache_block_size);
+
+      virtual ~Prefetcher() {}
 
       virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id) = 0;
+      // Train with the full context of the access: the PC of the instruction (0 if unknown), and whether it hit,
+      // on a line that was brought in by the prefetcher. Address-only prefetchers don't need to implement this.
+      virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id)
+      {
+         return getNextAddress(current_address, core_id);
+      }
 };
 
 #endif // PREFETCHER_H
@@ -0,0 +1,82 @@
+#include "sms_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "utils.h"
+#include "log.h"
+
+SmsPrefetcher::SmsPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size)
+   : m_log_block_size(floorLog2(cache_block_size))
+   , m_region_size(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/sms/region_size", core_id))
+   , m_log_region_size(floorLog2(m_region_size))
+   , m_agt(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/sms/agt_size", core_id))
+   , m_pht(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/sms/pht_size", core_id))
+   , m_time(0)
+{
+   LOG_ASSERT_ERROR(isPower2(m_region_size) && m_region_size >= cache_block_size, "perf_model/%s/prefetcher/sms/region_size must be a power of two of at least one cache line", configName.c_str());
+   // Footprints are stored as a bit per cache line
+   LOG_ASSERT_ERROR((m_region_size / cache_block_size) <= 64, "perf_model/%s/prefetcher/sms/region_size can be at most 64 cache lines", configName.c_str());
+   LOG_ASSERT_ERROR(m_agt.size() > 0 && m_pht.size() > 0, "perf_model/%s/prefetcher/sms/agt_size and pht_size must be > 0", configName.c_str());
+}
+
+void
+SmsPrefetcher::train(const Generation &generation)
+{
+   Pattern &pattern = m_pht[generation.signature % m_pht.size()];
+   pattern.valid = true;
+   pattern.signature = generation.signature;
+   pattern.footprint = generation.footprint;
+}
+
+std::vector<IntPtr>
+SmsPrefetcher::getNextAddress(IntPtr current_address, core_id_t core_id)
+{
+   return getNextAddress(current_address, 0, false, false, core_id);
+}
+
+std::vector<IntPtr>
+SmsPrefetcher::getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id)
+{
+   std::vector<IntPtr> addresses;
+   IntPtr region = current_address >> m_log_region_size;
+   UInt32 offset = (current_address & ((IntPtr(1) << m_log_region_size) - 1)) >> m_log_block_size;
+   ++m_time;
+
+   // Accesses to a region with an active generation add to its footprint
+   Generation *victim = &m_agt[0];
+   for(std::vector<Generation>::iterator it = m_agt.begin(); it != m_agt.end(); ++it)
+   {
+      if (it->valid && it->region == region)
+      {
+         it->footprint |= UInt64(1) << offset;
+         it->last_used = m_time;
+         return addresses;
+      }
+      if (victim->valid && (!it->valid || it->last_used < victim->last_used))
+         victim = &*it;
+   }
+
+   // Trigger access: start a new generation. The least recently used generation ends,
+   // as an approximation of its lines being evicted from the cache, and trains the pattern history.
+   if (victim->valid)
+      train(*victim);
+
+   UInt64 signature = (UInt64(eip) << (m_log_region_size - m_log_block_size)) | offset;
+   victim->valid = true;
+   victim->region = region;
+   victim->signature = signature;
+   victim->footprint = UInt64(1) << offset;
+   victim->last_used = m_time;
+
+   // Replay the footprint of the previous generation with the same signature
+   const Pattern &pattern = m_pht[signature % m_pht.size()];
+   if (pattern.valid && pattern.signature == signature)
+   {
+      for(UInt32 i = 0; i < (UInt32(1) << (m_log_region_size - m_log_block_size)); ++i)
+      {
+         if (i != offset && (pattern.footprint & (UInt64(1) << i)))
+            addresses.push_back((region << m_log_region_size) + (IntPtr(i) << m_log_block_size));
+      }
+   }
+
+   return addresses;
+}
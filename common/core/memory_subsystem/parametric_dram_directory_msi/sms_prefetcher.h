@@ -0,0 +1,48 @@
+#ifndef __SMS_PREFETCHER_H
+#define __SMS_PREFETCHER_H
+
+#include "prefetcher.h"
+
+// Spatial Memory Streaming [Somogyi et al., ISCA'06]
+// Records which lines of a spatial region are accessed during a generation, and stores this footprint
+// under the PC and region offset of the access that started the generation. When the same signature
+// starts a new generation, the recorded footprint is prefetched.
+class SmsPrefetcher : public Prefetcher
+{
+   public:
+      SmsPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id);
+
+   private:
+      // Active generation table entry
+      struct Generation
+      {
+         bool valid;
+         IntPtr region;
+         UInt64 signature;
+         UInt64 footprint;
+         UInt64 last_used;
+         Generation() : valid(false), region(0), signature(0), footprint(0), last_used(0) {}
+      };
+
+      // Pattern history table entry
+      struct Pattern
+      {
+         bool valid;
+         UInt64 signature;
+         UInt64 footprint;
+         Pattern() : valid(false), signature(0), footprint(0) {}
+      };
+
+      const UInt32 m_log_block_size;
+      const UInt32 m_region_size;
+      const UInt32 m_log_region_size;
+      std::vector<Generation> m_agt;
+      std::vector<Pattern> m_pht;
+      UInt64 m_time;
+
+      void train(const Generation &generation);
+};
+
+#endif // __SMS_PREFETCHER_H
@@ -0,0 +1,100 @@
+#include "stream_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "utils.h"
+#include "log.h"
+
+#include <cstdlib>
+
+const IntPtr PAGE_SIZE = 4096;
+const IntPtr PAGE_MASK = ~(PAGE_SIZE-1);
+
+StreamPrefetcher::StreamPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size)
+   : m_log_block_size(floorLog2(cache_block_size))
+   , m_window(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stream/window", core_id))
+   , m_distance(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stream/distance", core_id))
+   , m_degree(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stream/degree", core_id))
+   , m_confidence_threshold(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stream/confidence", core_id))
+   , m_confidence_max(2 * m_confidence_threshold)
+   , m_stop_at_page(Sim()->getCfg()->getBoolArray("perf_model/" + configName + "/prefetcher/stream/stop_at_page_boundary", core_id))
+   , m_streams(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stream/streams", core_id))
+   , m_time(0)
+{
+   LOG_ASSERT_ERROR(m_streams.size() > 0, "perf_model/%s/prefetcher/stream/streams must be > 0", configName.c_str());
+   LOG_ASSERT_ERROR(m_distance > 0, "perf_model/%s/prefetcher/stream/distance must be > 0", configName.c_str());
+}
+
+std::vector<IntPtr>
+StreamPrefetcher::getNextAddress(IntPtr current_address, core_id_t core_id)
+{
+   return getNextAddress(current_address, 0, false, false, core_id);
+}
+
+std::vector<IntPtr>
+StreamPrefetcher::getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id)
+{
+   std::vector<IntPtr> addresses;
+   SInt64 line = current_address >> m_log_block_size;
+   ++m_time;
+
+   // Find the stream this access belongs to, or the least recently used one to replace
+   Stream *stream = NULL, *victim = &m_streams[0];
+   for(std::vector<Stream>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+   {
+      if (it->valid && std::abs(line - it->last_line) <= SInt64(m_window))
+      {
+         stream = &*it;
+         break;
+      }
+      if (victim->valid && (!it->valid || it->last_used < victim->last_used))
+         victim = &*it;
+   }
+
+   if (stream == NULL)
+   {
+      // Start a new stream, its direction is not yet known
+      *victim = Stream();
+      victim->valid = true;
+      victim->last_line = line;
+      victim->last_used = m_time;
+      return addresses;
+   }
+
+   stream->last_used = m_time;
+   SInt64 delta = line - stream->last_line;
+   if (delta == 0)
+      return addresses;
+   stream->last_line = line;
+
+   // Confidence builds up while accesses keep moving in the same direction,
+   // the direction only flips after the confidence has been used up
+   SInt32 direction = delta > 0 ? 1 : -1;
+   if (direction == stream->direction)
+   {
+      if (stream->confidence < m_confidence_max)
+         ++stream->confidence;
+   }
+   else if (stream->confidence > 0)
+   {
+      --stream->confidence;
+   }
+   else
+   {
+      stream->direction = direction;
+      stream->confidence = 1;
+   }
+
+   if (stream->confidence >= m_confidence_threshold)
+   {
+      for(UInt32 i = 0; i < m_degree; ++i)
+      {
+         IntPtr prefetch_address = (line + stream->direction * SInt64(m_distance + i)) << m_log_block_size;
+         // But stay within the page if requested
+         if (m_stop_at_page && ((prefetch_address & PAGE_MASK) != (current_address & PAGE_MASK)))
+            break;
+         addresses.push_back(prefetch_address);
+      }
+   }
+
+   return addresses;
+}
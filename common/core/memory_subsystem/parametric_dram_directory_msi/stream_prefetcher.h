@@ -0,0 +1,37 @@
+#ifndef __STREAM_PREFETCHER_H
+#define __STREAM_PREFETCHER_H
+
+#include "prefetcher.h"
+
+// Multi-stream prefetcher: tracks a number of ascending or descending streams of cache lines,
+// and prefetches ahead of a stream once enough accesses have confirmed its direction
+class StreamPrefetcher : public Prefetcher
+{
+   public:
+      StreamPrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id);
+      std::vector<IntPtr> getNextAddress(IntPtr current_address, IntPtr eip, bool cache_hit, bool prefetch_hit, core_id_t core_id);
+
+   private:
+      struct Stream
+      {
+         bool valid;
+         SInt64 last_line;
+         SInt32 direction;
+         UInt32 confidence;
+         UInt64 last_used;
+         Stream() : valid(false), last_line(0), direction(0), confidence(0), last_used(0) {}
+      };
+
+      const UInt32 m_log_block_size;
+      const UInt32 m_window;     // Accesses within this many lines of a stream's last access belong to that stream
+      const UInt32 m_distance;   // Lines ahead of the current access where prefetching starts
+      const UInt32 m_degree;     // Lines prefetched per access
+      const UInt32 m_confidence_threshold;
+      const UInt32 m_confidence_max;
+      const bool m_stop_at_page;
+      std::vector<Stream> m_streams;
+      UInt64 m_time;
+};
+
+#endif // __STREAM_PREFETCHER_H
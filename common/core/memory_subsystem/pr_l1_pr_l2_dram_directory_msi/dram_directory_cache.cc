@@ -10,6 +10,7 @@ DramDirectoryCache::DramDirectoryCache(
       String directory_type_str,
       UInt32 total_entries,
       UInt32 associativity,
+      UInt32 region_size,
       UInt32 cache_block_size,
       UInt32 max_hw_sharers,
       UInt32 max_num_sharers,
@@ -17,24 +18,32 @@ DramDirectoryCache::DramDirectoryCache(
       ShmemPerfModel* shmem_perf_model):
    m_total_entries(total_entries),
    m_associativity(associativity),
+   m_region_size(region_size),
    m_cache_block_size(cache_block_size),
    m_dram_directory_cache_access_time(dram_directory_cache_access_time),
    m_shmem_perf_model(shmem_perf_model)
 {
+   LOG_ASSERT_ERROR(isPower2(m_region_size), "Directory region size (%u) must be a power of two", m_region_size);
+
    m_num_sets = m_total_entries / m_associativity;
 
-   // Instantiate the directory
-   m_directory = new Directory(core_id, directory_type_str, total_entries, max_hw_sharers, max_num_sharers);
+   // Instantiate the directory, with room for every block of every region
+   m_directory = new Directory(core_id, directory_type_str, total_entries * m_region_size, max_hw_sharers, max_num_sharers);
    m_replacement_ptrs = new UInt32[m_num_sets];
+   m_region_tags = new IntPtr[m_total_entries];
+   for (UInt32 i = 0; i < m_total_entries; i++)
+      m_region_tags[i] = INVALID_ADDRESS;
 
    // Logs
    m_log_num_sets = floorLog2(m_num_sets);
    m_log_cache_block_size = floorLog2(m_cache_block_size);
+   m_log_region_size = floorLog2(m_region_size);
 }
 
 DramDirectoryCache::~DramDirectoryCache()
 {
    delete m_replacement_ptrs;
+   delete [] m_region_tags;
    delete m_directory;
 }
 
@@ -49,48 +58,63 @@ DramDirectoryCache::getDirectoryEntry(IntPtr address, bool modeled)
 
    // Assume that it always hit in the Dram Directory Cache for now
    splitAddress(address, tag, set_index);
+   IntPtr region = getRegion(address);
 
    // Find the relevant directory entry
+   UInt32 region_way = m_associativity;
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      DirectoryEntry* directory_entry = m_directory->getDirectoryEntry(set_index * m_associativity + i);
-
-      if (directory_entry->getAddress() == address)
+      if (m_region_tags[set_index * m_associativity + i] == region)
       {
-         if (m_shmem_perf_model && modeled)
-            getShmemPerfModel()->incrElapsedTime(directory_entry->getLatency(), ShmemPerfModel::_SIM_THREAD);
-         // Simple check for now. Make sophisticated later
-         return directory_entry;
+         DirectoryEntry* directory_entry = m_directory->peekDirectoryEntry(getEntryIndex(set_index, i, address));
+
+         if (directory_entry && directory_entry->getAddress() == address)
+         {
+            if (m_shmem_perf_model && modeled)
+               getShmemPerfModel()->incrElapsedTime(directory_entry->getLatency(), ShmemPerfModel::_SIM_THREAD);
+            // Simple check for now. Make sophisticated later
+            return directory_entry;
+         }
+         region_way = i;
+         break;
       }
    }
 
-   // Find a free directory entry if one does not currently exist
-   for (UInt32 i = 0; i < m_associativity; i++)
+   // Check in the m_replaced_directory_entry_list. This needs to come before allocating a new block entry:
+   // with regions, a block can still be waiting to be nullified while its region was allocated again.
+   std::vector<DirectoryEntry*>::iterator it;
+   for (it = m_replaced_directory_entry_list.begin(); it != m_replaced_directory_entry_list.end(); it++)
    {
-      DirectoryEntry* directory_entry = m_directory->getDirectoryEntry(set_index * m_associativity + i);
-      if (directory_entry->getAddress() == INVALID_ADDRESS)
+      if ((*it)->getAddress() == address)
       {
-         // Simple check for now. Make sophisticated later
-         directory_entry->setAddress(address);
-         return directory_entry;
+         return (*it);
       }
    }
 
-   // Check in the m_replaced_directory_entry_list
-   std::vector<DirectoryEntry*>::iterator it;
-   for (it = m_replaced_directory_entry_list.begin(); it != m_replaced_directory_entry_list.end(); it++)
+   // Find a free directory entry if one does not currently exist: in the block's region if that is present,
+   // else in a free way
+   for (UInt32 i = 0; region_way == m_associativity && i < m_associativity; i++)
    {
-      if ((*it)->getAddress() == address)
+      if (m_region_tags[set_index * m_associativity + i] == INVALID_ADDRESS)
       {
-         return (*it);
+         m_region_tags[set_index * m_associativity + i] = region;
+         region_way = i;
       }
    }
 
+   if (region_way < m_associativity)
+   {
+      DirectoryEntry* directory_entry = m_directory->getDirectoryEntry(getEntryIndex(set_index, region_way, address));
+      // Simple check for now. Make sophisticated later
+      directory_entry->setAddress(address);
+      return directory_entry;
+   }
+
    return (DirectoryEntry*) NULL;
 }
 
 void
-DramDirectoryCache::getReplacementCandidates(IntPtr address, std::vector<DirectoryEntry*>& replacement_candidate_list)
+DramDirectoryCache::getReplacementCandidates(IntPtr address, std::vector<std::vector<DirectoryEntry*> >& replacement_candidate_list)
 {
    assert(getDirectoryEntry(address) == NULL);
 
@@ -98,15 +122,23 @@ DramDirectoryCache::getReplacementCandidates(IntPtr address, std::vector<Directo
    UInt32 set_index;
    splitAddress(address, tag, set_index);
 
+   replacement_candidate_list.resize(m_associativity);
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      replacement_candidate_list.push_back(m_directory->getDirectoryEntry(set_index * m_associativity + ((i + m_replacement_ptrs[set_index]) % m_associativity)));
+      UInt32 way = (i + m_replacement_ptrs[set_index]) % m_associativity;
+      UInt32 base = (set_index * m_associativity + way) * m_region_size;
+      for (UInt32 offset = 0; offset < m_region_size; offset++)
+      {
+         DirectoryEntry* directory_entry = m_directory->peekDirectoryEntry(base + offset);
+         if (directory_entry && directory_entry->getAddress() != INVALID_ADDRESS)
+            replacement_candidate_list[i].push_back(directory_entry);
+      }
    }
    ++m_replacement_ptrs[set_index];
 }
 
 DirectoryEntry*
-DramDirectoryCache::replaceDirectoryEntry(IntPtr replaced_address, IntPtr address, bool modeled)
+DramDirectoryCache::replaceDirectoryEntry(IntPtr replaced_address, IntPtr address, bool modeled, std::vector<DirectoryEntry*>& replaced_entry_list)
 {
    if (m_shmem_perf_model && modeled)
       getShmemPerfModel()->incrElapsedTime(m_dram_directory_cache_access_time.getLatency(), ShmemPerfModel::_SIM_THREAD);
@@ -114,17 +146,31 @@ DramDirectoryCache::replaceDirectoryEntry(IntPtr replaced_address, IntPtr addres
    IntPtr tag;
    UInt32 set_index;
    splitAddress(replaced_address, tag, set_index);
+   IntPtr replaced_region = getRegion(replaced_address);
 
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      DirectoryEntry* replaced_directory_entry = m_directory->getDirectoryEntry(set_index * m_associativity + i);
-      if (replaced_directory_entry->getAddress() == replaced_address)
+      if (m_region_tags[set_index * m_associativity + i] == replaced_region)
       {
-         m_replaced_directory_entry_list.push_back(replaced_directory_entry);
+         UInt32 base = (set_index * m_associativity + i) * m_region_size;
+         for (UInt32 offset = 0; offset < m_region_size; offset++)
+         {
+            DirectoryEntry* replaced_directory_entry = m_directory->peekDirectoryEntry(base + offset);
+            if (replaced_directory_entry && replaced_directory_entry->getAddress() != INVALID_ADDRESS)
+            {
+               m_replaced_directory_entry_list.push_back(replaced_directory_entry);
+               replaced_entry_list.push_back(replaced_directory_entry);
+            }
+            else if (replaced_directory_entry)
+               delete replaced_directory_entry;
+            m_directory->setDirectoryEntry(base + offset, NULL);
+         }
+
+         m_region_tags[set_index * m_associativity + i] = getRegion(address);
 
          DirectoryEntry* directory_entry = m_directory->createDirectoryEntry();
          directory_entry->setAddress(address);
-         m_directory->setDirectoryEntry(set_index * m_associativity + i, directory_entry);
+         m_directory->setDirectoryEntry(getEntryIndex(set_index, i, address), directory_entry);
 
          return directory_entry;
       }
@@ -156,9 +202,9 @@ DramDirectoryCache::invalidateDirectoryEntry(IntPtr address)
 void
 DramDirectoryCache::splitAddress(IntPtr address, IntPtr& tag, UInt32& set_index)
 {
-   IntPtr cache_block_address = address >> getLogCacheBlockSize();
-   tag = cache_block_address >> getLogNumSets();
-   set_index = ((UInt32) cache_block_address) & (getNumSets() - 1);
+   IntPtr region_address = getRegion(address);
+   tag = region_address >> getLogNumSets();
+   set_index = ((UInt32) region_address) & (getNumSets() - 1);
 
 }
 
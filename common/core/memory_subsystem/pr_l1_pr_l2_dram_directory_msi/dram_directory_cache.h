@@ -15,13 +15,19 @@ namespace PrL1PrL2DramDirectoryMSI
          UInt32* m_replacement_ptrs;
          std::vector<DirectoryEntry*> m_replaced_directory_entry_list;
 
+         // Each way tracks a region of m_region_size consecutive cache blocks. Its block entries live at
+         // directory indices (set * associativity + way) * m_region_size + offset, and are only allocated once used.
+         IntPtr* m_region_tags;
+
          UInt32 m_total_entries;
          UInt32 m_associativity;
+         UInt32 m_region_size;
 
          UInt32 m_num_sets;
          UInt32 m_cache_block_size;
          UInt32 m_log_num_sets;
          UInt32 m_log_cache_block_size;
+         UInt32 m_log_region_size;
 
          ComponentLatency m_dram_directory_cache_access_time;
          ShmemPerfModel* m_shmem_perf_model;
@@ -29,6 +35,9 @@ namespace PrL1PrL2DramDirectoryMSI
          ShmemPerfModel* getShmemPerfModel() { return m_shmem_perf_model; }
 
          void splitAddress(IntPtr address, IntPtr& tag, UInt32& set_index);
+         IntPtr getRegion(IntPtr address) { return address >> (getLogCacheBlockSize() + m_log_region_size); }
+         UInt32 getEntryIndex(UInt32 set_index, UInt32 way, IntPtr address)
+         { return (set_index * m_associativity + way) * m_region_size + ((address >> getLogCacheBlockSize()) & (m_region_size - 1)); }
          UInt32 getCacheBlockSize() { return m_cache_block_size; }
          UInt32 getLogCacheBlockSize() { return m_log_cache_block_size; }
          UInt32 getNumSets() { return m_num_sets; }
@@ -40,6 +49,7 @@ namespace PrL1PrL2DramDirectoryMSI
                String directory_type_str,
                UInt32 total_entries,
                UInt32 associativity,
+               UInt32 region_size,
                UInt32 cache_block_size,
                UInt32 max_hw_sharers,
                UInt32 max_num_sharers,
@@ -48,10 +58,14 @@ namespace PrL1PrL2DramDirectoryMSI
          ~DramDirectoryCache();
 
          DirectoryEntry* getDirectoryEntry(IntPtr address, bool modeled = false);
-         DirectoryEntry* replaceDirectoryEntry(IntPtr replaced_address, IntPtr address, bool modeled);
+         // Replace the way holding replaced_address (and all other blocks of its region) by the region of address.
+         // The block entries of the replaced region are returned in replaced_entry_list and need to be nullified.
+         DirectoryEntry* replaceDirectoryEntry(IntPtr replaced_address, IntPtr address, bool modeled, std::vector<DirectoryEntry*>& replaced_entry_list);
          void invalidateDirectoryEntry(IntPtr address);
-         void getReplacementCandidates(IntPtr address, std::vector<DirectoryEntry*>& replacement_candidate_list);
+         // Per way in the set of address, in replacement order, the block entries it holds
+         void getReplacementCandidates(IntPtr address, std::vector<std::vector<DirectoryEntry*> >& replacement_candidate_list);
 
          UInt32 getMaxHwSharers() const { return m_directory->getMaxHwSharers(); }
+         UInt32 getRegionSize() const { return m_region_size; }
    };
 }
@@ -37,6 +37,7 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
       NucaCache* nuca_cache,
       UInt32 dram_directory_total_entries,
       UInt32 dram_directory_associativity,
+      UInt32 dram_directory_region_size,
       UInt32 cache_block_size,
       UInt32 dram_directory_max_num_sharers,
       UInt32 dram_directory_max_hw_sharers,
@@ -50,13 +51,18 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
    m_cache_block_size(cache_block_size),
    m_shmem_perf_model(shmem_perf_model),
    forward(0),
-   forward_failed(0)
+   forward_failed(0),
+   evict_invalidations(0),
+   evict_flushes(0),
+   writebacks_avoided(0),
+   owner_forwards(0)
 {
    m_dram_directory_cache = new DramDirectoryCache(
          core_id,
          dram_directory_type_str,
          dram_directory_total_entries,
          dram_directory_associativity,
+         dram_directory_region_size,
          cache_block_size,
          dram_directory_max_hw_sharers,
          dram_directory_max_num_sharers,
@@ -73,6 +79,12 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
    }
    registerStatsMetric("directory", core_id, "forward", &forward);
    registerStatsMetric("directory", core_id, "forward-failed", &forward_failed);
+   // Invalidation and flush requests sent to the caches because their directory entry was evicted
+   registerStatsMetric("directory", core_id, "evict-invalidations", &evict_invalidations);
+   registerStatsMetric("directory", core_id, "evict-flushes", &evict_flushes);
+   // MOESI: dirty lines downgraded to OWNED instead of SHARED, and read requests served by the owner
+   registerStatsMetric("directory", core_id, "writebacks-avoided", &writebacks_avoided);
+   registerStatsMetric("directory", core_id, "owner-forwards", &owner_forwards);
 
    String protocol = Sim()->getCfg()->getString("caching_protocol/variant");
    if (protocol == "msi")
@@ -87,9 +99,13 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
    {
       m_protocol = CoherencyProtocol::MESIF;
    }
+   else if (protocol == "moesi")
+   {
+      m_protocol = CoherencyProtocol::MOESI;
+   }
    else
    {
-      LOG_PRINT_ERROR("Invalid coherency protocol %s, must be msi, mesi or mesif", protocol.c_str());
+      LOG_PRINT_ERROR("Invalid coherency protocol %s, must be msi, mesi, mesif or moesi", protocol.c_str());
    }
 }
 
@@ -166,6 +182,7 @@ DramDirectoryCntlr::handleMsgFromL2Cache(core_id_t sender, ShmemMsg* shmem_msg)
          break;
 
       case ShmemMsg::WB_REP:
+      case ShmemMsg::WB_REP_OWNED:
          MYLOG("WB REP<%u @ %lx", sender, address);
          processWbRepFromL2Cache(sender, shmem_msg);
          break;
@@ -265,44 +282,63 @@ DramDirectoryCntlr::processDirectoryEntryAllocationReq(ShmemReq* shmem_req)
 
    MYLOG("Start @ %lx", address);
 
-   std::vector<DirectoryEntry*> replacement_candidate_list;
+   // With region entries, each candidate is a way holding the entries of all used blocks in its region
+   std::vector<std::vector<DirectoryEntry*> > replacement_candidate_list;
    m_dram_directory_cache->getReplacementCandidates(address, replacement_candidate_list);
 
-   std::vector<DirectoryEntry*>::iterator it;
-   std::vector<DirectoryEntry*>::iterator replacement_candidate = replacement_candidate_list.end();
+   std::vector<std::vector<DirectoryEntry*> >::iterator it;
+   std::vector<std::vector<DirectoryEntry*> >::iterator replacement_candidate = replacement_candidate_list.end();
+   UInt32 replacement_candidate_sharers = 0;
    for (it = replacement_candidate_list.begin(); it != replacement_candidate_list.end(); it++)
    {
+      UInt32 num_sharers = 0;
+      bool has_requests = false;
+      for (std::vector<DirectoryEntry*>::iterator jt = it->begin(); jt != it->end(); jt++)
+      {
+         num_sharers += (*jt)->getNumSharers();
+         if (m_dram_directory_req_queue_list->size((*jt)->getAddress()) != 0)
+            has_requests = true;
+      }
+
       if ( ( (replacement_candidate == replacement_candidate_list.end()) ||
-             ((*replacement_candidate)->getNumSharers() > (*it)->getNumSharers())
+             (replacement_candidate_sharers > num_sharers)
            )
            &&
-           (m_dram_directory_req_queue_list->size((*it)->getAddress()) == 0)
+           !has_requests
          )
       {
          replacement_candidate = it;
+         replacement_candidate_sharers = num_sharers;
       }
    }
 
    LOG_ASSERT_ERROR(replacement_candidate != replacement_candidate_list.end(),
          "Cannot find a directory entry to be replaced with a non-zero request list (see Redmine #175)");
+   LOG_ASSERT_ERROR(!replacement_candidate->empty(), "Replacement candidate does not hold any directory entries");
 
-   DirectoryState::dstate_t curr_dstate = (*replacement_candidate)->getDirectoryBlockInfo()->getDState();
-   evict[curr_dstate]++;
-
-   IntPtr replaced_address = (*replacement_candidate)->getAddress();
+   IntPtr replaced_address = replacement_candidate->front()->getAddress();
 
    // We get the entry with the lowest number of sharers
-   DirectoryEntry* directory_entry = m_dram_directory_cache->replaceDirectoryEntry(replaced_address, address, true);
+   std::vector<DirectoryEntry*> replaced_entry_list;
+   DirectoryEntry* directory_entry = m_dram_directory_cache->replaceDirectoryEntry(replaced_address, address, true, replaced_entry_list);
 
-   ShmemMsg nullify_msg(ShmemMsg::NULLIFY_REQ, MemComponent::TAG_DIR, MemComponent::TAG_DIR, requester, replaced_address, NULL, 0, &m_dummy_shmem_perf);
+   // Every block tracked by the replaced entry loses its directory state, and needs to be removed from the caches
+   for (std::vector<DirectoryEntry*>::iterator jt = replaced_entry_list.begin(); jt != replaced_entry_list.end(); jt++)
+   {
+      replaced_address = (*jt)->getAddress();
+      DirectoryState::dstate_t curr_dstate = (*jt)->getDirectoryBlockInfo()->getDState();
+      evict[curr_dstate]++;
 
-   ShmemReq* nullify_req = new ShmemReq(&nullify_msg, msg_time);
+      ShmemMsg nullify_msg(ShmemMsg::NULLIFY_REQ, MemComponent::TAG_DIR, MemComponent::TAG_DIR, requester, replaced_address, NULL, 0, &m_dummy_shmem_perf);
 
-   m_dram_directory_req_queue_list->enqueue(replaced_address, nullify_req);
-   MYLOG("ENqueued NULLIFY request for address %lx", replaced_address );
+      ShmemReq* nullify_req = new ShmemReq(&nullify_msg, msg_time);
 
-   assert(m_dram_directory_req_queue_list->size(replaced_address) == 1);
-   processNullifyReq(nullify_req);
+      m_dram_directory_req_queue_list->enqueue(replaced_address, nullify_req);
+      MYLOG("ENqueued NULLIFY request for address %lx", replaced_address );
+
+      assert(m_dram_directory_req_queue_list->size(replaced_address) == 1);
+      processNullifyReq(nullify_req);
+   }
 
    MYLOG("End @ %lx", address);
 
@@ -329,6 +365,7 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
    {
       case DirectoryState::EXCLUSIVE:
       case DirectoryState::MODIFIED:
+         ++evict_flushes;
          getMemoryManager()->sendMsg(ShmemMsg::FLUSH_REQ,
                MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                requester /* requester */,
@@ -340,6 +377,7 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
                ShmemPerfModel::_SIM_THREAD);
          break;
 
+      case DirectoryState::OWNED:
       case DirectoryState::SHARED:
 
          {
@@ -347,7 +385,8 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
             if (sharers_list_pair.first == true)
             {
                // Broadcast Invalidation Request to all cores
-               // (irrespective of whether they are sharers or not)
+               // (irrespective of whether they are sharers or not, an owner will reply with a flush)
+               evict_invalidations += Sim()->getConfig()->getTotalCores();
                getMemoryManager()->broadcastMsg(ShmemMsg::INV_REQ,
                      MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                      requester /* requester */,
@@ -358,10 +397,15 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
             }
             else
             {
-               // Send Invalidation Request to only a specific set of sharers
+               // Send Invalidation Request to only a specific set of sharers, the owner has to flush its dirty copy
                for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
                {
-                  getMemoryManager()->sendMsg(ShmemMsg::INV_REQ,
+                  bool flush = curr_dstate == DirectoryState::OWNED && sharers_list_pair.second[i] == directory_entry->getOwner();
+                  if (flush)
+                     ++evict_flushes;
+                  else
+                     ++evict_invalidations;
+                  getMemoryManager()->sendMsg(flush ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ,
                         MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                         requester /* requester */,
                         sharers_list_pair.second[i] /* receiver */,
@@ -430,6 +474,7 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          break;
       }
 
+      case DirectoryState::OWNED:
       case DirectoryState::SHARED:
       {
          assert(cached_data_buf == NULL);
@@ -437,7 +482,7 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          if (sharers_list_pair.first == true)
          {
             // Broadcast Invalidation Request to all cores
-            // (irrespective of whether they are sharers or not)
+            // (irrespective of whether they are sharers or not, an owner will reply with a flush)
             getMemoryManager()->broadcastMsg(ShmemMsg::INV_REQ,
                   MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                   requester /* requester */,
@@ -448,11 +493,12 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          }
          else
          {
-            // Send Invalidation Request to only a specific set of sharers
+            // Send Invalidation Request to only a specific set of sharers, the owner has to flush its dirty copy
             for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
             {
-               MYLOG("Send INV_REQ>%d for %lx", sharers_list_pair.second[i], address )
-                        getMemoryManager()->sendMsg(ShmemMsg::INV_REQ,
+               bool flush = curr_dstate == DirectoryState::OWNED && sharers_list_pair.second[i] == directory_entry->getOwner();
+               MYLOG("Send %s>%d for %lx", flush ? "FLUSH_REQ" : "INV_REQ", sharers_list_pair.second[i], address )
+                        getMemoryManager()->sendMsg(flush ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ,
                               MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                               requester /* requester */,
                               sharers_list_pair.second[i] /* receiver */,
@@ -536,6 +582,43 @@ DramDirectoryCntlr::processShReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          break;
       }
 
+      case DirectoryState::OWNED:
+      {
+         if (cached_data_buf == NULL)
+         {
+            // Have the owner supply the (dirty) data, it stays in OWNED state
+            assert (requester != directory_entry->getOwner());
+            MYLOG("WB_REQ>%d for %lx", directory_entry->getOwner(), address  )
+            getMemoryManager()->sendMsg(ShmemMsg::WB_REQ,
+                  MemComponent::TAG_DIR, MemComponent::L2_CACHE,
+                  requester /* requester */,
+                  directory_entry->getOwner() /* receiver */,
+                  address,
+                  NULL, 0,
+                  HitWhere::UNKNOWN, shmem_req->getShmemMsg()->getPerf(), ShmemPerfModel::_SIM_THREAD);
+         }
+         else if (directory_entry->addSharer(requester, m_dram_directory_cache->getMaxHwSharers()))
+         {
+            MYLOG("OWNED state, send data forwarded by the owner")
+            ++owner_forwards;
+            retrieveDataAndSendToL2Cache(ShmemMsg::SH_REP, requester, address, cached_data_buf, shmem_req->getShmemMsg());
+         }
+         else
+         {
+            // Make room by invalidating another sharer, an owner will reply with a flush
+            core_id_t sharer_id = directory_entry->getOneSharer();
+            MYLOG("INV_REQ>%d for %lx because I could not add sharer", sharer_id, address  )
+            getMemoryManager()->sendMsg(ShmemMsg::INV_REQ,
+                  MemComponent::TAG_DIR, MemComponent::L2_CACHE,
+                  requester /* requester */,
+                  sharer_id /* receiver */,
+                  address,
+                  NULL, 0,
+                  HitWhere::UNKNOWN, shmem_req->getShmemMsg()->getPerf(), ShmemPerfModel::_SIM_THREAD);
+         }
+         break;
+      }
+
       case DirectoryState::SHARED:
       {
          if (directory_entry->hasSharer(requester))
@@ -804,9 +887,12 @@ DramDirectoryCntlr::processInvRepFromL2Cache(core_id_t sender, ShmemMsg* shmem_m
    assert(directory_entry);
 
    DirectoryBlockInfo* directory_block_info = directory_entry->getDirectoryBlockInfo();
-   LOG_ASSERT_ERROR(directory_block_info->getDState() == DirectoryState::SHARED || directory_block_info->getDState() == DirectoryState::EXCLUSIVE, "Ooops (%lx)", address);
-   assert(directory_block_info->getDState() == DirectoryState::SHARED || directory_block_info->getDState() == DirectoryState::EXCLUSIVE);
+   LOG_ASSERT_ERROR(directory_block_info->getDState() == DirectoryState::SHARED || directory_block_info->getDState() == DirectoryState::EXCLUSIVE
+         || directory_block_info->getDState() == DirectoryState::OWNED, "Ooops (%lx)", address);
 
+   // The owner always answers an invalidation with a flush, also while it is upgrading, so its dirty data is written back
+   LOG_ASSERT_ERROR(directory_block_info->getDState() != DirectoryState::OWNED || directory_entry->getOwner() != sender,
+         "Owner %d replied to an invalidation without its data (%lx)", sender, address);
    directory_entry->removeSharer(sender);
    if (directory_entry->getForwarder() == sender)
    {
@@ -969,6 +1055,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
 
          break;
       }
+      case DirectoryState::OWNED:
       case DirectoryState::SHARED:
       {
          if ((sharers_list_pair.second.size() == 1) && (sharers_list_pair.second[0] == requester))
@@ -1000,7 +1087,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
             if (sharers_list_pair.first == true)
             {
                // Broadcast Invalidation Request to all cores
-               // (irrespective of whether they are sharers or not)
+               // (irrespective of whether they are sharers or not, an owner will reply with a flush)
                getMemoryManager()->broadcastMsg(ShmemMsg::INV_REQ,
                      MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                      requester /* requester */,
@@ -1019,7 +1106,11 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
                   {
                      MYLOG("INV REQ (UPGR)>%u @ %lx",sharers_list_pair.second[i] , shmem_msg->getAddress());
                      // avoid having to fetch the data from DRAM, so ask at least one core to FLUSH instead of INV
-                     ShmemMsg::msg_t msg_type = (!requesterHasCopy && i==0) ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ;
+                     // (the owner of dirty data always has to)
+                     bool flush = curr_dstate == DirectoryState::OWNED
+                        ? sharers_list_pair.second[i] == directory_entry->getOwner()
+                        : !requesterHasCopy && i==0;
+                     ShmemMsg::msg_t msg_type = flush ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ;
                      //ShmemMsg::msg_t msg_type = ShmemMsg::INV_REQ;
                      getMemoryManager()->sendMsg( msg_type, //ShmemMsg::INV_REQ,
                            MemComponent::TAG_DIR, MemComponent::L2_CACHE,
@@ -1082,14 +1173,24 @@ DramDirectoryCntlr::processFlushRepFromL2Cache(core_id_t sender, ShmemMsg* shmem
    assert(directory_entry->hasSharer(sender));
    directory_entry->removeSharer(sender);
    directory_entry->setForwarder(INVALID_CORE_ID);
-   directory_entry->setOwner(INVALID_CORE_ID);
 
    // could be that this is a FLUSH to force a core with S-state to to write back clean data
    // to avoid a memory access
+   bool owner_flushed = directory_block_info->getDState() != DirectoryState::OWNED || directory_entry->getOwner() == sender;
+   if (owner_flushed)
+   {
+      directory_entry->setOwner(INVALID_CORE_ID);
+   }
    if (directory_entry->getNumSharers() == 0)
    {
       directory_block_info->setDState(DirectoryState::UNCACHED);
    }
+   else if (directory_block_info->getDState() == DirectoryState::OWNED)
+   {
+      // Remaining sharers have clean copies once the owner wrote back its data
+      if (owner_flushed)
+         directory_block_info->setDState(DirectoryState::SHARED);
+   }
    else
    {
       assert(directory_block_info->getDState() == DirectoryState::SHARED);
@@ -1109,7 +1210,16 @@ DramDirectoryCntlr::processFlushRepFromL2Cache(core_id_t sender, ShmemMsg* shmem
       // An involuntary/voluntary Flush
       if (shmem_req->getShmemMsg()->getMsgType() == ShmemMsg::EX_REQ)
       {
-         processExReqFromL2Cache(shmem_req, shmem_msg->getDataBuf());
+         if (directory_entry->getNumSharers() == 0)
+         {
+            processExReqFromL2Cache(shmem_req, shmem_msg->getDataBuf());
+         }
+         else
+         {
+            // Owner flushed while other sharers are still being invalidated, processInvRepFromL2Cache
+            // will continue the request. Write the data to DRAM so it can be retrieved from there.
+            sendDataToDram(address, shmem_msg->getRequester(), shmem_msg->getDataBuf(), now);
+         }
       }
       else if (shmem_req->getShmemMsg()->getMsgType() == ShmemMsg::SH_REQ)
       {
@@ -1134,14 +1244,21 @@ DramDirectoryCntlr::processFlushRepFromL2Cache(core_id_t sender, ShmemMsg* shmem
 
             // store the data that was FLUSHed
             shmem_req->getShmemMsg()->setDataBuf(shmem_msg->getDataBuf());
-            // Nothing else to do, there are still S copies.
+            if (directory_entry->getNumSharers() == 1 && directory_entry->hasSharer(shmem_req->getShmemMsg()->getRequester()))
+            {
+               // The owner flushed last, all other copies are gone: UPGRADE_REQ can be completed now.
+               processUpgradeReqFromL2Cache(shmem_req);
+            }
+            // Otherwise nothing else to do, there are still S copies.
          }
       }
       else // shmem_req->getShmemMsg()->getMsgType() == ShmemMsg::NULLIFY_REQ
       {
          // Write Data To Dram
          sendDataToDram(address, shmem_msg->getRequester(), shmem_msg->getDataBuf(), now);
-         processNullifyReq(shmem_req);
+         // When an owner flushed, invalidations to the other sharers may still be outstanding
+         if (directory_block_info->getDState() == DirectoryState::UNCACHED)
+            processNullifyReq(shmem_req);
       }
    }
    else
@@ -1170,8 +1287,20 @@ DramDirectoryCntlr::processWbRepFromL2Cache(core_id_t sender, ShmemMsg* shmem_ms
    //assert(directory_block_info->getDState() == DirectoryState::MODIFIED);
    assert(directory_entry->hasSharer(sender));
 
-   directory_entry->setOwner(INVALID_CORE_ID);
-   directory_block_info->setDState(DirectoryState::SHARED);
+   if (shmem_msg->getMsgType() == ShmemMsg::WB_REP_OWNED)
+   {
+      // The forwarder had dirty data and keeps it in OWNED state instead of writing it back
+      LOG_ASSERT_ERROR(m_protocol == CoherencyProtocol::MOESI, "WB_REP_OWNED without MOESI (%lx)", address);
+      if (directory_block_info->getDState() != DirectoryState::OWNED)
+         ++writebacks_avoided;
+      directory_entry->setOwner(sender);
+      directory_block_info->setDState(DirectoryState::OWNED);
+   }
+   else
+   {
+      directory_entry->setOwner(INVALID_CORE_ID);
+      directory_block_info->setDState(DirectoryState::SHARED);
+   }
 
    if (m_dram_directory_req_queue_list->size(address) != 0)
    {
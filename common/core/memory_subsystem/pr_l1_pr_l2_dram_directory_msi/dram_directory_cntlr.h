@@ -36,6 +36,8 @@ namespace PrL1PrL2DramDirectoryMSI
 
          UInt64 evict[DirectoryState::NUM_DIRECTORY_STATES];
          UInt64 forward, forward_failed;
+         UInt64 evict_invalidations, evict_flushes;
+         UInt64 writebacks_avoided, owner_forwards;
 
          UInt32 getCacheBlockSize() { return m_cache_block_size; }
          MemoryManagerBase* getMemoryManager() { return m_memory_manager; }
@@ -75,6 +77,7 @@ namespace PrL1PrL2DramDirectoryMSI
                NucaCache* nuca_cache,
                UInt32 dram_directory_total_entries,
                UInt32 dram_directory_associativity,
+               UInt32 dram_directory_region_size,
                UInt32 cache_block_size,
                UInt32 dram_directory_max_num_sharers,
                UInt32 dram_directory_max_hw_sharers,
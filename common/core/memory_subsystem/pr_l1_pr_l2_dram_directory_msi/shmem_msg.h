@@ -35,6 +35,8 @@ namespace PrL1PrL2DramDirectoryMSI
             DRAM_WRITE_REQ,
             // DRAM > tag directory
             DRAM_READ_REP,
+            // Cache > tag directory (MOESI): WB_REP from a cache that keeps the dirty line in OWNED state
+            WB_REP_OWNED,
 
             MAX_MSG_TYPE = NULLIFY_REQ,
             NUM_MSG_TYPES = MAX_MSG_TYPE - MIN_MSG_TYPE + 1
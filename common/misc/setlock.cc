@@ -1,38 +1,58 @@
 #include "setlock.h"
+#include "timer.h"
 #include <assert.h>
 
 _SetLock::_SetLock(UInt32 core_offset, UInt32 num_sharers)
    : m_locks(num_sharers)
    , m_core_offset(core_offset)
+   , m_version(0)
 {
    #ifdef TIME_LOCKS
    _timer = TotalTimer::getTimerByStacktrace("setlock@" + itostr(this));
    #endif
 }
 
+void
+_SetLock::PersetLock::acquire(UInt64 *wait_ns)
+{
+   if (wait_ns == NULL)
+   {
+      acquire();
+   }
+   // Only read the clock when we actually have to wait
+   else if (pthread_mutex_trylock(&_mutx) != 0)
+   {
+      UInt64 t_start = Timer::now();
+      acquire();
+      *wait_ns += Timer::now() - t_start;
+   }
+}
+
 // Acquire exclusive access
 void
-_SetLock::acquire_exclusive(void)
+_SetLock::acquire_exclusive(UInt64 *wait_ns)
 {
    #ifdef TIME_LOCKS
    ScopedTimer tt(*_timer);
    #endif
 
    for(std::vector<PersetLock>::iterator it = m_locks.begin(); it != m_locks.end(); ++it)
-      (*it).acquire();
+      (*it).acquire(wait_ns);
+   __atomic_add_fetch(&m_version, 1, __ATOMIC_SEQ_CST);
 }
 
 // Release exclusive access
 void
 _SetLock::release_exclusive(void)
 {
+   __atomic_add_fetch(&m_version, 1, __ATOMIC_SEQ_CST);
    for(std::vector<PersetLock>::iterator it = m_locks.begin(); it != m_locks.end(); ++it)
       (*it).release();
 }
 
 // Acquire shared access
 void
-_SetLock::acquire_shared(UInt32 core_id)
+_SetLock::acquire_shared(UInt32 core_id, UInt64 *wait_ns)
 {
    #ifdef TIME_LOCKS
    ScopedTimer tt(*_timer);
@@ -40,7 +60,7 @@ _SetLock::acquire_shared(UInt32 core_id)
 
    assert(core_id >= m_core_offset);
    assert(core_id < m_core_offset + m_locks.size());
-   m_locks.at(core_id - m_core_offset).acquire();
+   m_locks.at(core_id - m_core_offset).acquire(wait_ns);
 }
 
 // Release shared access
@@ -51,15 +71,16 @@ _SetLock::release_shared(UInt32 core_id)
 }
 
 void
-_SetLock::upgrade(UInt32 core_id)
+_SetLock::upgrade(UInt32 core_id, UInt64 *wait_ns)
 {
    release_shared(core_id);
-   acquire_exclusive();
+   acquire_exclusive(wait_ns);
 }
 
 void
 _SetLock::downgrade(UInt32 core_id)
 {
+   __atomic_add_fetch(&m_version, 1, __ATOMIC_SEQ_CST);
    for(unsigned int i = 0; i < m_locks.size(); ++i)
       if (i != (core_id - m_core_offset))
          m_locks.at(i).release();
@@ -13,19 +13,34 @@ class _SetLock
 {
    public:
       _SetLock(UInt32 core_offset, UInt32 num_sharers);
-      void acquire_exclusive(void);
+      // When wait_ns is not NULL, the time spent blocked on other holders is added to it
+      void acquire_exclusive(UInt64 *wait_ns = NULL);
       void release_exclusive(void);
-      void acquire_shared(UInt32 core_id);
+      void acquire_shared(UInt32 core_id, UInt64 *wait_ns = NULL);
       void release_shared(UInt32 core_id);
-      void upgrade(UInt32 core_id);
+      void upgrade(UInt32 core_id, UInt64 *wait_ns = NULL);
       void downgrade(UInt32 core_id);
 
+      // Optimistic (lock-free) readers: read_begin() returns false while an exclusive holder is active,
+      // read_validate() returns false if an exclusive holder was active at any time since read_begin()
+      bool read_begin(UInt64 &version) const
+      {
+         version = __atomic_load_n(&m_version, __ATOMIC_ACQUIRE);
+         return (version & 1) == 0;
+      }
+      bool read_validate(UInt64 version) const
+      {
+         __atomic_thread_fence(__ATOMIC_ACQUIRE);
+         return __atomic_load_n(&m_version, __ATOMIC_RELAXED) == version;
+      }
+
    private:
       class PersetLock
       {
          public:
             PersetLock() { pthread_mutex_init(&_mutx, NULL); }
             void acquire() { pthread_mutex_lock(&_mutx); }
+            void acquire(UInt64 *wait_ns);
             void release() { pthread_mutex_unlock(&_mutx); }
          private:
             pthread_mutex_t _mutx;
@@ -33,6 +48,8 @@ class _SetLock
 
       std::vector<PersetLock> m_locks;
       UInt32 m_core_offset;
+      // Odd while held exclusively, incremented on every exclusive acquire and release
+      UInt64 m_version;
       #ifdef TIME_LOCKS
       TotalTimer* _timer;
       #endif
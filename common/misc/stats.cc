@@ -1,6 +1,7 @@
 #include "stats.h"
 #include "simulator.h"
 #include "hooks_manager.h"
+#include "config.hpp"
 #include "utils.h"
 #include "itostr.h"
 
@@ -8,6 +9,7 @@
 #include <stdio.h>
 #include <sstream>
 #include <unordered_set>
+#include <algorithm>
 #include <string>
 #include <cstring>
 #include <zlib.h>
@@ -43,19 +45,27 @@ UInt64 getWallclockTimeCallback(String objectName, UInt32 index, String metricNa
 StatsManager::StatsManager()
    : m_keyid(0)
    , m_prefixnum(0)
+   , m_columnar_file(NULL)
+   , m_columnar_compress(false)
+   , m_columns_written(0)
    , m_db(NULL)
 {
    init();
+   initColumnar();
 
    registerMetric(new StatsMetricCallback("time", 0, "walltime", getWallclockTimeCallback, 0));
 }
 
 StatsManager::~StatsManager()
 {
-   for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
-      for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
-         for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
-            delete it3->second;
+   for(std::vector<StatsMetricBase *>::iterator it = m_metrics.begin(); it != m_metrics.end(); ++it)
+      delete *it;
+
+   if (m_columnar_file)
+   {
+      writeColumnarIndex();
+      fclose(m_columnar_file);
+   }
 
    if (m_db)
    {
@@ -101,6 +111,95 @@ StatsManager::init()
    sqlite3_exec(m_db, "END TRANSACTION", NULL, NULL, NULL);
 }
 
+void
+StatsManager::initColumnar()
+{
+   String format = Sim()->getCfg()->getString("stats/format");
+   if (format == "sqlite")
+      return;
+   LOG_ASSERT_ERROR(format == "columnar", "Invalid stats/format %s, expected sqlite or columnar", format.c_str());
+
+   String compression = Sim()->getCfg()->getString("stats/columnar/compression");
+   LOG_ASSERT_ERROR(compression == "none" || compression == "zlib", "Invalid stats/columnar/compression %s, expected none or zlib", compression.c_str());
+   m_columnar_compress = (compression == "zlib");
+
+   String filename = Sim()->getConfig()->formatOutputFileName("sim.stats.columnar");
+   m_columnar_file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(m_columnar_file, "Cannot create %s", filename.c_str());
+
+   // Header: magic, compression (0 = none, 1 = zlib). All following fields are native-endian UInt64.
+   const char magic[8] = { 'S', 'N', 'S', 'T', 'C', 'O', 'L', '1' };
+   UInt64 header = m_columnar_compress ? 1 : 0;
+   fwrite(magic, sizeof(magic), 1, m_columnar_file);
+   fwrite(&header, sizeof(header), 1, m_columnar_file);
+}
+
+void
+StatsManager::recordStatsColumnar(UInt64 prefixid)
+{
+   // Columns registered since the last snapshot: COLUMNS, first column, count, count x (nameid, index)
+   if (m_columns_written < m_metrics.size())
+   {
+      std::vector<UInt64> record;
+      record.push_back(COLUMNAR_RECORD_COLUMNS);
+      record.push_back(m_columns_written);
+      record.push_back(m_metrics.size() - m_columns_written);
+      for(UInt64 column = m_columns_written; column < m_metrics.size(); ++column)
+      {
+         record.push_back(m_metric_keyids[column]);
+         record.push_back(m_metrics[column]->index);
+      }
+      fwrite(record.data(), sizeof(UInt64), record.size(), m_columnar_file);
+      m_columns_written = m_metrics.size();
+   }
+
+   recordMetrics(m_snapshot_values);
+
+   // SNAPSHOT, prefixid, number of columns, payload size in bytes, payload
+   const Byte *payload = (const Byte *)m_snapshot_values.data();
+   uLongf payload_size = m_snapshot_values.size() * sizeof(UInt64);
+   if (m_columnar_compress)
+   {
+      uLongf compressed_size = compressBound(payload_size);
+      m_snapshot_compressed.resize(compressed_size);
+      int res = compress2(m_snapshot_compressed.data(), &compressed_size, payload, payload_size, Z_BEST_SPEED);
+      LOG_ASSERT_ERROR(res == Z_OK, "Error compressing statistics snapshot");
+      payload = m_snapshot_compressed.data();
+      payload_size = compressed_size;
+   }
+   UInt64 record[4] = { COLUMNAR_RECORD_SNAPSHOT, prefixid, m_snapshot_values.size(), payload_size };
+   fwrite(record, sizeof(UInt64), 4, m_columnar_file);
+   m_columnar_snapshots.push_back(prefixid);
+   m_columnar_snapshots.push_back(ftell(m_columnar_file));
+   m_columnar_snapshots.push_back(m_snapshot_values.size());
+   m_columnar_snapshots.push_back(payload_size);
+   fwrite(payload, 1, payload_size, m_columnar_file);
+   fflush(m_columnar_file);
+}
+
+void
+StatsManager::writeColumnarIndex()
+{
+   // INDEX, number of columns, count x (nameid, index), number of snapshots, count x (prefixid, offset, columns, size),
+   // followed by a trailer with the offset of the INDEX record and a magic, so readers can find it from the end of the file
+   UInt64 offset = ftell(m_columnar_file);
+   std::vector<UInt64> record;
+   record.push_back(COLUMNAR_RECORD_INDEX);
+   record.push_back(m_columns_written);
+   for(UInt64 column = 0; column < m_columns_written; ++column)
+   {
+      record.push_back(m_metric_keyids[column]);
+      record.push_back(m_metrics[column]->index);
+   }
+   record.push_back(m_columnar_snapshots.size() / 4);
+   record.insert(record.end(), m_columnar_snapshots.begin(), m_columnar_snapshots.end());
+   record.push_back(offset);
+   fwrite(record.data(), sizeof(UInt64), record.size(), m_columnar_file);
+
+   const char magic[8] = { 'S', 'N', 'S', 'T', 'I', 'D', 'X', '1' };
+   fwrite(magic, sizeof(magic), 1, m_columnar_file);
+}
+
 int
 StatsManager::busy_handler(int count)
 {
@@ -145,60 +244,111 @@ StatsManager::recordStats(String prefix)
    res = sqlite3_step(m_stmt_insert_prefix);
    LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
 
-   for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
+   if (m_columnar_file)
    {
-      for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+      res = sqlite3_exec(m_db, "END TRANSACTION", NULL, NULL, NULL);
+      LOG_ASSERT_ERROR(res == SQLITE_OK, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
+      recordStatsColumnar(prefixid);
+      return;
+   }
+
+   for(handle_t handle = 0; handle < m_metrics.size(); ++handle)
+   {
+      StatsMetricBase *metric = m_metrics[handle];
+      if (!metric->isDefault())
       {
-         for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
-         {
-            if (!it3->second->isDefault())
-            {
-               sqlite3_reset(m_stmt_insert_value);
-               sqlite3_bind_int(m_stmt_insert_value, 1, prefixid);
-               sqlite3_bind_int(m_stmt_insert_value, 2, it2->second.first);   // Metric ID
-               sqlite3_bind_int(m_stmt_insert_value, 3, it3->second->index);  // Core ID
-               sqlite3_bind_int64(m_stmt_insert_value, 4, it3->second->recordMetric());
-               res = sqlite3_step(m_stmt_insert_value);
-               LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
-            }
-         }
+         sqlite3_reset(m_stmt_insert_value);
+         sqlite3_bind_int(m_stmt_insert_value, 1, prefixid);
+         sqlite3_bind_int(m_stmt_insert_value, 2, m_metric_keyids[handle]);  // Metric ID
+         sqlite3_bind_int(m_stmt_insert_value, 3, metric->index);            // Core ID
+         sqlite3_bind_int64(m_stmt_insert_value, 4, metric->recordMetric());
+         res = sqlite3_step(m_stmt_insert_value);
+         LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
       }
    }
    res = sqlite3_exec(m_db, "END TRANSACTION", NULL, NULL, NULL);
    LOG_ASSERT_ERROR(res == SQLITE_OK, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
 }
 
-void
+StatsManager::handle_t
 StatsManager::registerMetric(StatsMetricBase *metric)
 {
    std::string _objectName(metric->objectName.c_str()), _metricName(metric->metricName.c_str());
 
-   LOG_ASSERT_ERROR(m_objects[_objectName][_metricName].second.count(metric->index) == 0,
+   StatsMetricWithKey &entry = m_objects[_objectName][_metricName];
+   LOG_ASSERT_ERROR(entry.second.count(metric->index) == 0,
       "Duplicate statistic %s.%s[%d]", _objectName.c_str(), _metricName.c_str(), metric->index);
-   m_objects[_objectName][_metricName].second[metric->index] = metric;
+   LOG_ASSERT_ERROR(m_metrics.size() < INVALID_HANDLE, "Too many statistics");
 
-   if (m_objects[_objectName][_metricName].first == 0)
+   handle_t handle = m_metrics.size();
+   entry.second[metric->index] = handle;
+
+   if (entry.first == 0)
    {
-      m_objects[_objectName][_metricName].first = ++m_keyid;
+      entry.first = ++m_keyid;
       if (m_db)
       {
          // Metrics name record was already written, but a new metric was registered afterwards: write a new record
          recordMetricName(m_keyid, _objectName, _metricName);
       }
    }
+
+   m_metrics.push_back(metric);
+   m_metric_keyids.push_back(entry.first);
+
+   return handle;
+}
+
+StatsManager::handle_t
+StatsManager::getMetricHandle(String objectName, UInt32 index, String metricName)
+{
+   StatsObjectList::iterator it1 = m_objects.find(std::string(objectName.c_str()));
+   if (it1 == m_objects.end())
+      return INVALID_HANDLE;
+   StatsMetricList::iterator it2 = it1->second.find(std::string(metricName.c_str()));
+   if (it2 == it1->second.end())
+      return INVALID_HANDLE;
+   StatsIndexList::iterator it3 = it2->second.second.find(index);
+   if (it3 == it2->second.second.end())
+      return INVALID_HANDLE;
+   return it3->second;
 }
 
 StatsMetricBase *
 StatsManager::getMetricObject(String objectName, UInt32 index, String metricName)
 {
-   std::string _objectName(objectName.c_str()), _metricName(metricName.c_str());
-   if (m_objects.count(_objectName) == 0)
-      return NULL;
-   if (m_objects[_objectName].count(_metricName) == 0)
+   handle_t handle = getMetricHandle(objectName, index, metricName);
+   if (handle == INVALID_HANDLE)
       return NULL;
-   if (m_objects[_objectName][_metricName].second.count(index) == 0)
-      return NULL;
-   return m_objects[_objectName][_metricName].second[index];
+   return m_metrics[handle];
+}
+
+std::vector<StatsManager::handle_t>
+StatsManager::getMetricHandles(String objectName, String metricName)
+{
+   std::vector<std::pair<UInt32, handle_t> > indices;
+   StatsObjectList::iterator it1 = m_objects.find(std::string(objectName.c_str()));
+   if (it1 != m_objects.end())
+   {
+      StatsMetricList::iterator it2 = it1->second.find(std::string(metricName.c_str()));
+      if (it2 != it1->second.end())
+         for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
+            indices.push_back(std::make_pair(it3->first, it3->second));
+   }
+   std::sort(indices.begin(), indices.end());
+
+   std::vector<handle_t> handles;
+   for(std::vector<std::pair<UInt32, handle_t> >::iterator it = indices.begin(); it != indices.end(); ++it)
+      handles.push_back(it->second);
+   return handles;
+}
+
+void
+StatsManager::recordMetrics(std::vector<UInt64> &values)
+{
+   values.resize(m_metrics.size());
+   for(handle_t handle = 0; handle < m_metrics.size(); ++handle)
+      values[handle] = m_metrics[handle]->recordMetric();
 }
 
 void
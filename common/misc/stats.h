@@ -58,6 +58,10 @@ class StatsMetricCallback : public StatsMetricBase
 class StatsManager
 {
    public:
+      // Stable handle of a registered metric: its position in the flat metric array
+      typedef UInt32 handle_t;
+      static const handle_t INVALID_HANDLE = UINT32_MAX;
+
       // Event type                 core              thread            arg0           arg1              description
       typedef enum {
          EVENT_MARKER = 1,       // calling core      calling thread    magic arg0     magic arg1        str (SimMarker/SimNamedMarker)
@@ -72,8 +76,16 @@ class StatsManager
       ~StatsManager();
       void init();
       void recordStats(String prefix);
-      void registerMetric(StatsMetricBase *metric);
+      handle_t registerMetric(StatsMetricBase *metric);
+      handle_t getMetricHandle(String objectName, UInt32 index, String metricName);
       StatsMetricBase *getMetricObject(String objectName, UInt32 index, String metricName);
+      StatsMetricBase *getMetricObject(handle_t handle) { return m_metrics[handle]; }
+      UInt64 getMetricValue(handle_t handle) { return m_metrics[handle]->recordMetric(); }
+      // Handles of all indices of one metric, ordered on index
+      std::vector<handle_t> getMetricHandles(String objectName, String metricName);
+      // Current value of all metrics, indexed by handle
+      void recordMetrics(std::vector<UInt64> &values);
+      handle_t getNumMetrics() const { return m_metrics.size(); }
       void logTopology(String component, core_id_t core_id, core_id_t master_id);
       void logMarker(SubsecondTime time, core_id_t core_id, thread_id_t thread_id, UInt64 value0, UInt64 value1, const char * description)
       { logEvent(EVENT_MARKER, time, core_id, thread_id, value0, value1, description); }
@@ -83,13 +95,36 @@ class StatsManager
       UInt64 m_keyid;
       UInt64 m_prefixnum;
 
+      // All registered metrics, indexed by handle. Metrics are never unregistered, so handles stay valid.
+      std::vector<StatsMetricBase *> m_metrics;
+      std::vector<UInt64> m_metric_keyids;
+
+      // Columnar snapshot file: the column of a metric is its handle,
+      // each snapshot is written as one contiguous vector of all metric values.
+      // On close, an index of all columns and snapshots is appended so readers need not scan the file.
+      enum columnar_record_t {
+         COLUMNAR_RECORD_COLUMNS = 1,
+         COLUMNAR_RECORD_SNAPSHOT = 2,
+         COLUMNAR_RECORD_INDEX = 3,
+      };
+      FILE *m_columnar_file;
+      bool m_columnar_compress;
+      UInt64 m_columns_written;
+      std::vector<UInt64> m_columnar_snapshots; // prefixid, payload offset, number of columns, payload size
+      std::vector<UInt64> m_snapshot_values;
+      std::vector<Byte> m_snapshot_compressed;
+
+      void initColumnar();
+      void recordStatsColumnar(UInt64 prefixid);
+      void writeColumnarIndex();
+
       sqlite3 *m_db;
       sqlite3_stmt *m_stmt_insert_name;
       sqlite3_stmt *m_stmt_insert_prefix;
       sqlite3_stmt *m_stmt_insert_value;
 
       // Use std::string here because String (__versa_string) does not provide a hash function for STL containers with gcc < 4.6
-      typedef std::unordered_map<UInt64, StatsMetricBase *> StatsIndexList;
+      typedef std::unordered_map<UInt64, handle_t> StatsIndexList;
       typedef std::pair<UInt64, StatsIndexList> StatsMetricWithKey;
       typedef std::unordered_map<std::string, StatsMetricWithKey> StatsMetricList;
       typedef std::unordered_map<std::string, StatsMetricList> StatsObjectList;
@@ -101,9 +136,9 @@ class StatsManager
       void recordMetricName(UInt64 keyId, std::string objectName, std::string metricName);
 };
 
-template <class T> void registerStatsMetric(String objectName, UInt32 index, String metricName, T *metric)
+template <class T> StatsManager::handle_t registerStatsMetric(String objectName, UInt32 index, String metricName, T *metric)
 {
-   Sim()->getStatsManager()->registerMetric(new StatsMetric<T>(objectName, index, metricName, metric));
+   return Sim()->getStatsManager()->registerMetric(new StatsMetric<T>(objectName, index, metricName, metric));
 }
 
 
@@ -78,7 +78,9 @@ void Network::netPullFromTransport()
    {
       LOG_PRINT("Entering netPullFromTransport");
 
-      NetPacket packet(_transport->recv());
+      // The payload is used in place until the buffer is released
+      Byte *buffer = _transport->recv();
+      NetPacket packet(buffer, false);
 
       LOG_PRINT("Pull packet : type %i, from %i, time %s", (SInt32)packet.type, packet.sender, itostr(packet.time).c_str());
       assert(0 <= packet.sender && packet.sender < _numMod);
@@ -95,8 +97,7 @@ void Network::netPullFromTransport()
          // if this isn't a broadcast message, then we shouldn't process it further
          if (packet.receiver != NetPacket::BROADCAST)
          {
-            if (packet.length > 0)
-               delete [] (Byte*) packet.data;
+            _transport->release(buffer);
             continue;
          }
       }
@@ -116,9 +117,6 @@ void Network::netPullFromTransport()
          assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
 
          callback(_callbackObjs[packet.type], packet);
-
-         if (packet.length > 0)
-            delete [] (Byte*) packet.data;
       }
 
       // synchronous I/O support
@@ -126,11 +124,22 @@ void Network::netPullFromTransport()
       {
          LOG_PRINT("Enqueuing packet : type %i, from %i, to %i, core_id %i, time %s.",
                (SInt32)packet.type, packet.sender, packet.receiver, _core->getId(), itostr(packet.time).c_str());
+
+         // netRecv() callers own the payload of queued packets
+         if (packet.length > 0)
+         {
+            Byte *data = new Byte[packet.length];
+            memcpy(data, packet.data, packet.length);
+            packet.data = data;
+         }
+
          _netQueueLock.acquire();
          _netQueue.push_back(packet);
          _netQueueLock.release();
          _netQueueCond.broadcast();
       }
+
+      _transport->release(buffer);
    }
    while (_transport->query());
 }
@@ -158,8 +167,11 @@ SInt32 Network::netSend(NetPacket& packet)
    std::vector<NetworkModel::Hop> hopVec;
    model->routePacket(packet, hopVec);
 
-   Byte *buffer = packet.makeBuffer();
+   UInt32 size = packet.bufferSize();
    SubsecondTime start_time = packet.time;
+   // The shortcut below lets the remote models add their queue delays to packet,
+   // each hop's buffer carries the queue delay as routed locally
+   SubsecondTime queue_delay = packet.queue_delay;
 
    for (UInt32 i = 0; i < hopVec.size(); i++)
    {
@@ -188,6 +200,9 @@ SInt32 Network::netSend(NetPacket& packet)
          }
       }
 
+      // Serialize the packet straight into the transport's buffer
+      Byte *buffer = _transport->reserve(hopVec[i].next_dest, size);
+      packet.writeBuffer(buffer);
       NetPacket* buff_pkt = (NetPacket*) buffer;
 
       if (_core->getId() == buff_pkt->sender)
@@ -195,14 +210,13 @@ SInt32 Network::netSend(NetPacket& packet)
 
       buff_pkt->time = hopVec[i].time;
       buff_pkt->receiver = hopVec[i].final_dest;
+      buff_pkt->queue_delay = queue_delay;
 
-      _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
+      _transport->commit(hopVec[i].next_dest, buffer, size);
 
       LOG_PRINT("Sent packet");
    }
 
-   delete [] buffer;
-
    return packet.length;
 }
 
@@ -505,19 +519,21 @@ NetPacket::NetPacket(SubsecondTime t, PacketType ty, SInt32 s,
 }
 
 
-NetPacket::NetPacket(Byte *buffer)
+NetPacket::NetPacket(Byte *buffer, bool copy_data)
 {
    memcpy(this, buffer, sizeof(*this));
 
    // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
-   if (length > 0)
+   if (length > 0 && !copy_data)
+   {
+      data = buffer + sizeof(*this);
+   }
+   else if (length > 0)
    {
       Byte* data_buffer = new Byte[length];
       memcpy(data_buffer, buffer + sizeof(*this), length);
       data = data_buffer;
    }
-
-   delete [] buffer;
 }
 
 // This implementation is slightly wasteful because there is no need
@@ -534,9 +550,13 @@ Byte* NetPacket::makeBuffer() const
    assert(size >= sizeof(NetPacket));
 
    Byte *buffer = new Byte[size];
+   writeBuffer(buffer);
 
+   return buffer;
+}
+
+void NetPacket::writeBuffer(Byte *buffer) const
+{
    memcpy(buffer, this, sizeof(*this));
    memcpy(buffer + sizeof(*this), data, length);
-
-   return buffer;
 }
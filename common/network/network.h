@@ -33,12 +33,14 @@ public:
    const void *data;
 
    NetPacket();
-   explicit NetPacket(Byte*);
+   // With copy_data = false, data points into the buffer, which must outlive the packet
+   explicit NetPacket(Byte*, bool copy_data = true);
    NetPacket(SubsecondTime time, PacketType type, SInt32 sender,
              SInt32 receiver, UInt32 length, const void *data);
 
    UInt32 bufferSize() const;
    Byte *makeBuffer() const;
+   void writeBuffer(Byte *buffer) const;
 
    static const SInt32 BROADCAST = 0xDEADBABE;
 };
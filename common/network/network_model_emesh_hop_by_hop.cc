@@ -14,7 +14,7 @@
 #include <stdlib.h>
 
 const char* output_direction_names[] = {
-   "up", "down", "left", "right", "---", "self", "peer", "destination"
+   "up", "down", "left", "right", "above", "below", "---", "self", "peer", "destination"
 };
 static_assert(NetworkModelEMeshHopByHop::MAX_OUTPUT_DIRECTIONS == sizeof(output_direction_names) / sizeof(output_direction_names[0]),
               "Not enough values in output_direction_names");
@@ -34,19 +34,28 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    m_total_packets_received(0),
    m_total_contention_delay(SubsecondTime::Zero()),
    m_total_packet_latency(SubsecondTime::Zero()),
+   m_router_flits(0),
+   m_tsv_flits(0),
    m_fake_node(false),
    m_core_id(getNetwork()->getCore()->getId()),
    // Placeholders.  These values will be overwritten in a derived class.
    m_link_bandwidth(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0),
-   m_hop_latency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0)
+   m_hop_latency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0),
+   m_tsv_link_bandwidth(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0),
+   m_tsv_hop_latency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0)
 {
    // Get the Link Bandwidth, Hop Latency and if it has broadcast tree mechanism
    try
    {
       // Link Bandwidth is specified in bits/clock_cycle
-      m_link_bandwidth = ComponentBandwidthPerCycle(Sim()->getDvfsManager()->getCoreDomain(m_core_id), Sim()->getCfg()->getInt("network/emesh_hop_by_hop/link_bandwidth"));
+      m_link_width = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/link_bandwidth");
+      m_link_bandwidth = ComponentBandwidthPerCycle(Sim()->getDvfsManager()->getCoreDomain(m_core_id), m_link_width);
       // Hop Latency is specified in cycles
       m_hop_latency = ComponentLatency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), Sim()->getCfg()->getInt("network/emesh_hop_by_hop/hop_latency"));
+      // Same for the vertical links between layers
+      m_tsv_link_width = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/tsv_link_bandwidth");
+      m_tsv_link_bandwidth = ComponentBandwidthPerCycle(Sim()->getDvfsManager()->getCoreDomain(m_core_id), m_tsv_link_width);
+      m_tsv_hop_latency = ComponentLatency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), Sim()->getCfg()->getInt("network/emesh_hop_by_hop/tsv_hop_latency"));
 
       UInt32 smt_cores = Sim()->getCfg()->getInt("perf_model/core/logical_cpus");
       m_concentration = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/concentration") * smt_cores;
@@ -63,6 +72,7 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    {
       LOG_PRINT_ERROR("Could not read parameters from the configuration file");
    }
+   LOG_ASSERT_ERROR(m_link_width > 0 && m_tsv_link_width > 0, "network/emesh_hop_by_hop link bandwidths must be > 0");
 
    String name = String("network.")+EStaticNetworkStrings[net_type]+".mesh";
    registerStatsMetric(name, m_core_id, "bytes-out", &m_total_bytes_sent);
@@ -71,10 +81,13 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    registerStatsMetric(name, m_core_id, "packets-in", &m_total_packets_received);
    registerStatsMetric(name, m_core_id, "contention-delay", &m_total_contention_delay);
    registerStatsMetric(name, m_core_id, "total-delay", &m_total_packet_latency);
+   registerStatsMetric(name, m_core_id, "router-flits", &m_router_flits);
+   registerStatsMetric(name, m_core_id, "tsv-flits", &m_tsv_flits);
 
-   computeMeshDimensions(m_mesh_width, m_mesh_height);
+   computeMeshDimensions(m_mesh_width, m_mesh_height, m_mesh_depth);
+   LOG_ASSERT_ERROR(m_mesh_depth == 1 || !m_broadcast_tree_enabled, "The broadcast tree is not supported on a mesh with multiple layers");
 
-   if (m_core_id % m_concentration != 0 || m_core_id >= m_concentration * m_mesh_width * m_mesh_height)
+   if (m_core_id % m_concentration != 0 || m_core_id >= m_concentration * m_mesh_width * m_mesh_height * m_mesh_depth)
    {
       m_fake_node = true;
       return;
@@ -103,11 +116,23 @@ NetworkModelEMeshHopByHop::createQueueModels(String name)
 {
    SubsecondTime min_processing_time = m_link_bandwidth.getPeriod();
 
-   // Initialize the queue models for all the '4' output directions
+   // Initialize the queue models for the '4' output directions within the layer
    m_queue_models[DOWN] = QueueModel::create(name+".link-down", m_core_id, m_queue_model_type, min_processing_time);
    m_queue_models[LEFT] = QueueModel::create(name+".link-left", m_core_id, m_queue_model_type, min_processing_time);
    m_queue_models[UP] = QueueModel::create(name+".link-up", m_core_id, m_queue_model_type, min_processing_time);
    m_queue_models[RIGHT] = QueueModel::create(name+".link-right", m_core_id, m_queue_model_type, min_processing_time);
+   // Vertical links only exist on a mesh with multiple layers
+   if (m_mesh_depth > 1)
+   {
+      SubsecondTime min_processing_time_tsv = m_tsv_link_bandwidth.getPeriod();
+      m_queue_models[ABOVE] = QueueModel::create(name+".link-above", m_core_id, m_queue_model_type, min_processing_time_tsv);
+      m_queue_models[BELOW] = QueueModel::create(name+".link-below", m_core_id, m_queue_model_type, min_processing_time_tsv);
+   }
+   else
+   {
+      m_queue_models[ABOVE] = NULL;
+      m_queue_models[BELOW] = NULL;
+   }
 
    m_injection_port_queue_model = QueueModel::create(name+".link-in", m_core_id, m_queue_model_type, min_processing_time);
    m_ejection_port_queue_model = QueueModel::create(name+".link-out", m_core_id, m_queue_model_type, min_processing_time);
@@ -116,8 +141,6 @@ NetworkModelEMeshHopByHop::createQueueModels(String name)
 void
 NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &nextHops)
 {
-   ScopedLock sl(m_lock);
-
    core_id_t requester = INVALID_CORE_ID;
 
    if (pkt.type == SHARED_MEM_1)
@@ -134,8 +157,8 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
 
    if (pkt.sender == m_core_id)
    {
-      m_total_packets_sent ++;
-      m_total_bytes_sent += pkt_length;
+      __sync_fetch_and_add(&m_total_packets_sent, 1);
+      __sync_fetch_and_add(&m_total_bytes_sent, pkt_length);
    }
 
    if (pkt.receiver == NetPacket::BROADCAST)
@@ -157,21 +180,21 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
 
          // Broadcast tree is enabled
          // Build the broadcast tree
-         SInt32 sx, sy, cx, cy;
+         SInt32 sx, sy, sz, cx, cy, cz;
 
-         computePosition(pkt.sender, sx, sy);
-         computePosition(m_core_id, cx, cy);
+         computePosition(pkt.sender, sx, sy, sz);
+         computePosition(m_core_id, cx, cy, cz);
 
          if (cy >= sy)
-            addHop(UP, NetPacket::BROADCAST, computeCoreId(cx,cy+1), curr_time, pkt_length, nextHops, requester);
+            addHop(UP, NetPacket::BROADCAST, computeCoreId(cx,cy+1,cz), curr_time, pkt_length, nextHops, requester);
          if (cy <= sy)
-            addHop(DOWN, NetPacket::BROADCAST, computeCoreId(cx,cy-1), curr_time, pkt_length, nextHops, requester);
+            addHop(DOWN, NetPacket::BROADCAST, computeCoreId(cx,cy-1,cz), curr_time, pkt_length, nextHops, requester);
          if (cy == sy)
          {
             if (cx >= sx)
-               addHop(RIGHT, NetPacket::BROADCAST, computeCoreId(cx+1,cy), curr_time, pkt_length, nextHops, requester);
+               addHop(RIGHT, NetPacket::BROADCAST, computeCoreId(cx+1,cy,cz), curr_time, pkt_length, nextHops, requester);
             if (cx <= sx)
-               addHop(LEFT, NetPacket::BROADCAST, computeCoreId(cx-1,cy), curr_time, pkt_length, nextHops, requester);
+               addHop(LEFT, NetPacket::BROADCAST, computeCoreId(cx-1,cy,cz), curr_time, pkt_length, nextHops, requester);
             if (cx == sx)
                addHop(SELF, m_core_id, m_core_id, curr_time, pkt_length, nextHops, requester);
          }
@@ -224,8 +247,6 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
 void
 NetworkModelEMeshHopByHop::processReceivedPacket(NetPacket& pkt)
 {
-   ScopedLock sl(m_lock);
-
    UInt32 pkt_length = getNetwork()->getModeledLength(pkt);
 
    core_id_t requester = INVALID_CORE_ID;
@@ -243,7 +264,7 @@ NetworkModelEMeshHopByHop::processReceivedPacket(NetPacket& pkt)
       return;
 
    SubsecondTime packet_latency = pkt.time - pkt.start_time;
-   SubsecondTime contention_delay = packet_latency - (computeDistance(pkt.sender, m_core_id) * m_hop_latency.getLatency());
+   SubsecondTime contention_delay = packet_latency - computeDistanceLatency(pkt.sender, m_core_id);
 
    if (pkt.sender != m_core_id && !m_fake_node)
    {
@@ -256,10 +277,10 @@ NetworkModelEMeshHopByHop::processReceivedPacket(NetPacket& pkt)
       pkt.queue_delay += ejection_port_queue_delay;
    }
 
-   m_total_packets_received ++;
-   m_total_bytes_received += pkt_length;
-   m_total_packet_latency += packet_latency;
-   m_total_contention_delay += contention_delay;
+   __sync_fetch_and_add(&m_total_packets_received, 1);
+   __sync_fetch_and_add(&m_total_bytes_received, pkt_length);
+   atomic_add_subsecondtime(m_total_packet_latency, packet_latency);
+   atomic_add_subsecondtime(m_total_contention_delay, contention_delay);
 }
 
 void
@@ -281,34 +302,40 @@ NetworkModelEMeshHopByHop::addHop(OutputDirection direction,
    nextHops.push_back(h);
 }
 
-SInt32
-NetworkModelEMeshHopByHop::computeDistance(core_id_t sender, core_id_t receiver)
+SubsecondTime
+NetworkModelEMeshHopByHop::computeDistanceLatency(core_id_t sender, core_id_t receiver)
 {
-   SInt32 sx, sy, dx, dy;
+   SInt32 sx, sy, sz, dx, dy, dz;
 
-   computePosition(sender, sx, sy);
-   computePosition(receiver, dx, dy);
+   computePosition(sender, sx, sy, sz);
+   computePosition(receiver, dx, dy, dz);
 
+   SInt32 distance;
    if (m_wrap_around)
-      return std::min(abs(sx - dx), m_mesh_width - abs(sx - dx))
-           + std::min(abs(sy - dy), m_mesh_height - abs(sy - dy));
+      distance = std::min(abs(sx - dx), m_mesh_width - abs(sx - dx))
+               + std::min(abs(sy - dy), m_mesh_height - abs(sy - dy));
    else
-      return abs(sx - dx) + abs(sy - dy);
+      distance = abs(sx - dx) + abs(sy - dy);
+
+   // Layers never wrap around
+   return distance * m_hop_latency.getLatency() + abs(sz - dz) * m_tsv_hop_latency.getLatency();
 }
 
 void
-NetworkModelEMeshHopByHop::computePosition(core_id_t core_id, SInt32 &x, SInt32 &y)
+NetworkModelEMeshHopByHop::computePosition(core_id_t core_id, SInt32 &x, SInt32 &y, SInt32 &z)
 {
-   x = (core_id / m_concentration) % m_mesh_width;
-   y = (core_id / m_concentration) / m_mesh_width;
+   SInt32 node = core_id / m_concentration;
+   x = node % m_mesh_width;
+   y = (node / m_mesh_width) % m_mesh_height;
+   z = node / (m_mesh_width * m_mesh_height);
 }
 
 core_id_t
-NetworkModelEMeshHopByHop::computeCoreId(SInt32 x, SInt32 y)
+NetworkModelEMeshHopByHop::computeCoreId(SInt32 x, SInt32 y, SInt32 z)
 {
    x = (x + m_mesh_width) % m_mesh_width;
    y = (y + m_mesh_height) % m_mesh_height;
-   return (y * m_mesh_width + x) * m_concentration;
+   return ((z * m_mesh_height + y) * m_mesh_width + x) * m_concentration;
 }
 
 SubsecondTime
@@ -322,18 +349,30 @@ NetworkModelEMeshHopByHop::computeLatency(OutputDirection direction, SubsecondTi
    if ( (!m_enabled) || (requester >= (core_id_t) Config::getSingleton()->getApplicationCores()) )
       return SubsecondTime::Zero();
 
-   SubsecondTime processing_time = computeProcessingTime(pkt_length);
+   bool vertical = direction == ABOVE || direction == BELOW;
+   SubsecondTime processing_time = computeProcessingTime(pkt_length, vertical);
+
+   // One flit is what the link transfers in one cycle
+   UInt32 link_width = vertical ? m_tsv_link_width : m_link_width;
+   UInt64 flits = (pkt_length * 8 + link_width - 1) / link_width;
+   __sync_fetch_and_add(&m_router_flits, flits);
+   if (vertical)
+      __sync_fetch_and_add(&m_tsv_flits, flits);
 
    SubsecondTime queue_delay = SubsecondTime::Zero();
    if (m_queue_model_enabled)
    {
-      queue_delay = m_queue_models[direction]->computeQueueDelay(pkt_time, processing_time);
+      {
+         ScopedLock sl(m_link_locks[direction]);
+         queue_delay = m_queue_models[direction]->computeQueueDelay(pkt_time, processing_time);
+      }
       if (queue_delay_stats)
          *queue_delay_stats += queue_delay;
    }
 
-   LOG_PRINT("Queue Delay(%s), Hop Latency(%s)", itostr(queue_delay).c_str(), itostr(m_hop_latency.getLatency()).c_str());
-   SubsecondTime packet_latency = m_hop_latency.getLatency() + queue_delay;
+   const ComponentLatency &hop_latency = vertical ? m_tsv_hop_latency : m_hop_latency;
+   LOG_PRINT("Queue Delay(%s), Hop Latency(%s)", itostr(queue_delay).c_str(), itostr(hop_latency.getLatency()).c_str());
+   SubsecondTime packet_latency = hop_latency.getLatency() + queue_delay;
 
    return packet_latency;
 }
@@ -350,6 +389,7 @@ NetworkModelEMeshHopByHop::computeInjectionPortQueueDelay(core_id_t pkt_receiver
       return SubsecondTime::Zero();
 
    SubsecondTime processing_time = computeProcessingTime(pkt_length);
+   ScopedLock sl(m_injection_port_lock);
    return m_injection_port_queue_model->computeQueueDelay(pkt_time, processing_time);
 }
 
@@ -362,24 +402,25 @@ NetworkModelEMeshHopByHop::computeEjectionPortQueueDelay(SubsecondTime pkt_time,
       return SubsecondTime::Zero();
 
    SubsecondTime processing_time = computeProcessingTime(pkt_length);
+   ScopedLock sl(m_ejection_port_lock);
    return m_ejection_port_queue_model->computeQueueDelay(pkt_time, processing_time);
 }
 
 SubsecondTime
-NetworkModelEMeshHopByHop::computeProcessingTime(UInt32 pkt_length)
+NetworkModelEMeshHopByHop::computeProcessingTime(UInt32 pkt_length, bool vertical)
 {
    LOG_ASSERT_ERROR(!m_fake_node, "Cannot computeProcessingTime on a fake network node");
 
    // Send: (pkt_length * 8) bits
-   // Bandwidth: (m_link_bandwidth) bits/cycle
+   // Bandwidth: (m_link_bandwidth or m_tsv_link_bandwidth) bits/cycle
    UInt32 num_bits = pkt_length * 8;
-   return m_link_bandwidth.getRoundedLatency(num_bits);
+   return (vertical ? m_tsv_link_bandwidth : m_link_bandwidth).getRoundedLatency(num_bits);
 }
 
 SInt32
 NetworkModelEMeshHopByHop::getNextDest(SInt32 final_dest, OutputDirection& direction)
 {
-   // Do dimension-order routing
+   // Do dimension-order routing: X, then Y within the layer, then Z across the layers
    // Curently, do store-and-forward routing
    // FIXME: Should change this to wormhole routing eventually
 
@@ -402,30 +443,40 @@ NetworkModelEMeshHopByHop::getNextDest(SInt32 final_dest, OutputDirection& direc
       return m_core_id - m_core_id % m_concentration;
    }
 
-   SInt32 sx, sy, dx, dy;
+   SInt32 sx, sy, sz, dx, dy, dz;
 
-   computePosition(m_core_id, sx, sy);
-   computePosition(final_dest, dx, dy);
+   computePosition(m_core_id, sx, sy, sz);
+   computePosition(final_dest, dx, dy, dz);
 
    if ((sx > dx) ^ (m_wrap_around && abs(sx - dx) > (m_mesh_width+1) / 2))
    {
       direction = LEFT;
-      return computeCoreId(sx-1,sy);
+      return computeCoreId(sx-1,sy,sz);
    }
    else if (sx != dx)
    {
       direction = RIGHT;
-      return computeCoreId(sx+1,sy);
+      return computeCoreId(sx+1,sy,sz);
    }
    else if ((sy > dy) ^ (m_wrap_around && abs(sy - dy) > (m_mesh_height+1) / 2))
    {
       direction = DOWN;
-      return computeCoreId(sx,sy-1);
+      return computeCoreId(sx,sy-1,sz);
    }
    else if (sy != dy)
    {
       direction = UP;
-      return computeCoreId(sx,sy+1);
+      return computeCoreId(sx,sy+1,sz);
+   }
+   else if (sz > dz)
+   {
+      direction = BELOW;
+      return computeCoreId(sx,sy,sz-1);
+   }
+   else if (sz < dz)
+   {
+      direction = ABOVE;
+      return computeCoreId(sx,sy,sz+1);
    }
    else
    {
@@ -454,7 +505,7 @@ NetworkModelEMeshHopByHop::isEnabled()
 }
 
 void
-NetworkModelEMeshHopByHop::computeMeshDimensions(SInt32 &mesh_width, SInt32 &mesh_height)
+NetworkModelEMeshHopByHop::computeMeshDimensions(SInt32 &mesh_width, SInt32 &mesh_height, SInt32 &mesh_depth)
 {
    SInt32 core_count = Config::getSingleton()->getApplicationCores();
    UInt32 smt_cores = Sim()->getCfg()->getInt("perf_model/core/logical_cpus");
@@ -462,23 +513,28 @@ NetworkModelEMeshHopByHop::computeMeshDimensions(SInt32 &mesh_width, SInt32 &mes
    SInt32 dimensions = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/dimensions");
    String size = Sim()->getCfg()->getString("network/emesh_hop_by_hop/size");
 
+   mesh_depth = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/layers");
+   LOG_ASSERT_ERROR(mesh_depth > 0, "network/emesh_hop_by_hop/layers must be > 0");
+
    if (size == "")
    {
+      // The cores are distributed evenly over the layers
+      SInt32 nodes_per_layer = core_count / concentration / mesh_depth;
       switch(dimensions)
       {
          case 1: // line / ring
-            mesh_width = core_count / concentration;
+            mesh_width = nodes_per_layer;
             mesh_height = 1;
             break;
          case 2: // 2-d mesh / torus
-            mesh_width = (SInt32) floor (sqrt(core_count / concentration));
-            mesh_height = (SInt32) ceil (1.0 * core_count / concentration / mesh_width);
+            mesh_width = (SInt32) floor (sqrt(nodes_per_layer));
+            mesh_height = (SInt32) ceil (1.0 * nodes_per_layer / mesh_width);
             break;
          default:
             LOG_PRINT_ERROR("Invalid value %d for dimensions, only 1 (line/ring) and 2 (mesh/torus) are currently supported", dimensions);
       }
 
-      LOG_ASSERT_ERROR(core_count == (concentration * mesh_height * mesh_width), "Cannot build a mesh with %d cores (concentration %d), increase NumApplicationCores to %d for a %d x %d mesh or configure network/emesh_hop_by_hop/size=WIDTH:HEIGHT to manually specify mesh dimensions", core_count, concentration, concentration * mesh_width * mesh_height, mesh_width, mesh_height);
+      LOG_ASSERT_ERROR(core_count == (concentration * mesh_height * mesh_width * mesh_depth), "Cannot build a mesh with %d cores (concentration %d) on %d layers, increase NumApplicationCores to %d for a %d x %d x %d mesh or configure network/emesh_hop_by_hop/size=WIDTH:HEIGHT to manually specify mesh dimensions", core_count, concentration, mesh_depth, concentration * mesh_width * mesh_height * mesh_depth, mesh_width, mesh_height, mesh_depth);
    }
    else
    {
@@ -486,21 +542,21 @@ NetworkModelEMeshHopByHop::computeMeshDimensions(SInt32 &mesh_width, SInt32 &mes
       int res = sscanf(size.c_str(), "%d:%d", &mesh_width, &mesh_height);
       LOG_ASSERT_ERROR(res == 2, "Invalid mesh size \"%s\", expected \"width:height\"", size.c_str());
 
-      LOG_ASSERT_ERROR(core_count == (concentration * mesh_height * mesh_width), "Invalid mesh size %s for %d cores (concentration %d): %d x %d (x %d) == %d != %d", size.c_str(), core_count, concentration, mesh_width, mesh_height, concentration, concentration * mesh_width * mesh_height, core_count);
+      LOG_ASSERT_ERROR(core_count == (concentration * mesh_height * mesh_width * mesh_depth), "Invalid mesh size %s on %d layers for %d cores (concentration %d): %d x %d x %d (x %d) == %d != %d", size.c_str(), mesh_depth, core_count, concentration, mesh_width, mesh_height, mesh_depth, concentration, concentration * mesh_width * mesh_height * mesh_depth, core_count);
    }
 }
 
 std::pair<bool,SInt32>
 NetworkModelEMeshHopByHop::computeCoreCountConstraints(SInt32 core_count)
 {
-   SInt32 mesh_width, mesh_height;
-   computeMeshDimensions(mesh_width, mesh_height);
+   SInt32 mesh_width, mesh_height, mesh_depth;
+   computeMeshDimensions(mesh_width, mesh_height, mesh_depth);
 
-   assert(core_count <= mesh_width * mesh_height);
-   assert(core_count > (mesh_width - 1) * mesh_height);
-   assert(core_count > mesh_width * (mesh_height - 1));
+   assert(core_count <= mesh_width * mesh_height * mesh_depth);
+   assert(core_count > (mesh_width - 1) * mesh_height * mesh_depth);
+   assert(core_count > mesh_width * (mesh_height - 1) * mesh_depth);
 
-   return std::make_pair(true,mesh_height * mesh_width);
+   return std::make_pair(true,mesh_height * mesh_width * mesh_depth);
 }
 
 std::pair<bool, std::vector<core_id_t> >
@@ -509,27 +565,33 @@ NetworkModelEMeshHopByHop::computeMemoryControllerPositions(SInt32 num_memory_co
    UInt32 smt_cores = Sim()->getCfg()->getInt("perf_model/core/logical_cpus");
    SInt32 concentration = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/concentration") * smt_cores;
    SInt32 dimensions = Sim()->getCfg()->getInt("network/emesh_hop_by_hop/dimensions");
-   SInt32 mesh_width, mesh_height;
-   computeMeshDimensions(mesh_width, mesh_height);
+   SInt32 mesh_width, mesh_height, mesh_depth;
+   computeMeshDimensions(mesh_width, mesh_height, mesh_depth);
 
-   // core_id_list_along_perimeter : list of cores along the perimeter of the chip in clockwise order starting from (0,0)
+   // core_id_list_along_perimeter : list of cores along the perimeter of the chip in clockwise order starting from (0,0),
+   // on each layer in turn
    std::vector<core_id_t> core_id_list_along_perimeter;
 
-   for (SInt32 i = 0; i < mesh_width; i++)
-      core_id_list_along_perimeter.push_back(i);
-
-   if (dimensions > 1 && mesh_height > 1)
+   for (SInt32 z = 0; z < mesh_depth; z++)
    {
-      for (SInt32 i = 1; i < (mesh_height-1); i++)
-         core_id_list_along_perimeter.push_back((i * mesh_width) + mesh_width-1);
+      SInt32 layer = z * mesh_width * mesh_height;
+
+      for (SInt32 i = 0; i < mesh_width; i++)
+         core_id_list_along_perimeter.push_back(layer + i);
 
-      for (SInt32 i = mesh_width-1; i >= 0; i--)
-         core_id_list_along_perimeter.push_back(((mesh_height-1) * mesh_width) + i);
+      if (dimensions > 1 && mesh_height > 1)
+      {
+         for (SInt32 i = 1; i < (mesh_height-1); i++)
+            core_id_list_along_perimeter.push_back(layer + (i * mesh_width) + mesh_width-1);
+
+         for (SInt32 i = mesh_width-1; i >= 0; i--)
+            core_id_list_along_perimeter.push_back(layer + ((mesh_height-1) * mesh_width) + i);
 
-      for (SInt32 i = mesh_height-2; i >= 1; i--)
-         core_id_list_along_perimeter.push_back(i * mesh_width);
+         for (SInt32 i = mesh_height-2; i >= 1; i--)
+            core_id_list_along_perimeter.push_back(layer + i * mesh_width);
 
-      assert(core_id_list_along_perimeter.size() == (UInt32) (2 * (mesh_width + mesh_height - 2)));
+         assert(core_id_list_along_perimeter.size() == (UInt32) ((z + 1) * 2 * (mesh_width + mesh_height - 2)));
+      }
    }
 
    LOG_ASSERT_ERROR(core_id_list_along_perimeter.size() >= (UInt32) num_memory_controllers,
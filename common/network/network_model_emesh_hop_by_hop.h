@@ -8,6 +8,9 @@
 #include "lock.h"
 #include "subsecond_time.h"
 
+// Mesh / torus with store-and-forward routing, one queue model per output link of each router.
+// With more than one layer, the 2-D mesh is stacked for 3-D chips: routers at the same position on
+// adjacent layers are connected by vertical (TSV) links, and packets are routed in X, then Y, then Z order.
 class NetworkModelEMeshHopByHop : public NetworkModel
 {
    public:
@@ -17,6 +20,8 @@ class NetworkModelEMeshHopByHop : public NetworkModel
          DOWN,
          LEFT,
          RIGHT,
+         ABOVE,   // Next layer (+z), over a TSV link
+         BELOW,   // Previous layer (-z), over a TSV link
          NUM_OUTPUT_DIRECTIONS,
          // Directions below are fake and do not have a corresponding queue
          SELF,
@@ -29,6 +34,7 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       // Fields
       SInt32 m_mesh_width;
       SInt32 m_mesh_height;
+      SInt32 m_mesh_depth; // Number of layers
 
       QueueModel* m_queue_models[NUM_OUTPUT_DIRECTIONS];
       QueueModel* m_injection_port_queue_model;
@@ -36,25 +42,30 @@ class NetworkModelEMeshHopByHop : public NetworkModel
 
       bool m_enabled;
 
-      // Lock
-      Lock m_lock;
+      // Locks, one per queue model: packets on different links of this router don't serialize
+      Lock m_link_locks[NUM_OUTPUT_DIRECTIONS];
+      Lock m_injection_port_lock;
+      Lock m_ejection_port_lock;
 
-      // Counters
+      // Counters, updated atomically
       UInt64 m_total_bytes_sent;
       UInt64 m_total_packets_sent;
       UInt64 m_total_bytes_received;
       UInt64 m_total_packets_received;
       SubsecondTime m_total_contention_delay;
       SubsecondTime m_total_packet_latency;
+      // Router activity, used to attribute NoC power to this router's floorplan block
+      UInt64 m_router_flits; // Flits sent out over any link of this router
+      UInt64 m_tsv_flits;    // Flits sent out over the vertical links of this router
 
       // Functions
-      void computePosition(core_id_t core, SInt32 &x, SInt32 &y);
-      core_id_t computeCoreId(SInt32 x, SInt32 y);
-      SInt32 computeDistance(core_id_t sender, core_id_t receiver);
+      void computePosition(core_id_t core, SInt32 &x, SInt32 &y, SInt32 &z);
+      core_id_t computeCoreId(SInt32 x, SInt32 y, SInt32 z);
+      SubsecondTime computeDistanceLatency(core_id_t sender, core_id_t receiver);
 
       void addHop(OutputDirection direction, core_id_t final_dest, core_id_t next_dest, SubsecondTime pkt_time, UInt32 pkt_length, std::vector<Hop>& nextHops, core_id_t requester, subsecond_time_t *queue_delay_stats = NULL);
       SubsecondTime computeLatency(OutputDirection direction, SubsecondTime pkt_time, UInt32 pkt_length, core_id_t requester, subsecond_time_t *queue_delay_stats);
-      SubsecondTime computeProcessingTime(UInt32 pkt_length);
+      SubsecondTime computeProcessingTime(UInt32 pkt_length, bool vertical = false);
       core_id_t getNextDest(core_id_t final_dest, OutputDirection& direction);
 
       // Injection & Ejection Port Queue Models
@@ -68,8 +79,12 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       SInt32 m_dimensions; // 1 for line/ring, 2 for mesh/torus
       bool m_wrap_around; // false for line/mesh, true for ring/torus
 
+      UInt32 m_link_width; // In bits, also the flit size
+      UInt32 m_tsv_link_width;
       ComponentBandwidthPerCycle m_link_bandwidth;
       ComponentLatency m_hop_latency;
+      ComponentBandwidthPerCycle m_tsv_link_bandwidth;
+      ComponentLatency m_tsv_hop_latency;
       bool m_broadcast_tree_enabled;
 
       bool m_queue_model_enabled;
@@ -83,7 +98,7 @@ class NetworkModelEMeshHopByHop : public NetworkModel
 
       void routePacket(const NetPacket &pkt, std::vector<Hop> &nextHops);
       void processReceivedPacket(NetPacket &pkt);
-      static void computeMeshDimensions(SInt32 &mesh_width, SInt32 &mesh_height);
+      static void computeMeshDimensions(SInt32 &mesh_width, SInt32 &mesh_height, SInt32 &mesh_depth);
       static std::pair<bool,std::vector<core_id_t> > computeMemoryControllerPositions(SInt32 num_memory_controllers, SInt32 core_count);
       static std::pair<bool,SInt32> computeCoreCountConstraints(SInt32 core_count);
 
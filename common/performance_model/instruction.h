@@ -222,6 +222,7 @@ class DelayInstruction : public PseudoInstruction
 public:
    enum delay_type_t {
       DVFS_TRANSITION,
+      POLICY_OVERHEAD,
       NUM_TYPES
    };
    DelayInstruction(SubsecondTime cost, delay_type_t delay_type)
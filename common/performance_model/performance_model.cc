@@ -87,6 +87,7 @@ PerformanceModel::PerformanceModel(Core *core)
    registerStatsMetric("performance_model", core->getId(), "cpiSyncSyscall", &m_cpiSyncSyscall);
    registerStatsMetric("performance_model", core->getId(), "cpiSyncUnscheduled", &m_cpiSyncUnscheduled);
    registerStatsMetric("performance_model", core->getId(), "cpiSyncDvfsTransition", &m_cpiSyncDvfsTransition);
+   registerStatsMetric("performance_model", core->getId(), "cpiSyncPolicyOverhead", &m_cpiSyncPolicyOverhead);
 
    registerStatsMetric("performance_model", core->getId(), "cpiRecv", &m_cpiRecv);
 }
@@ -268,6 +269,9 @@ void PerformanceModel::handleIdleInstruction(PseudoInstruction *instruction)
       case(DelayInstruction::DVFS_TRANSITION):
          m_cpiSyncDvfsTransition += insn_cost;
          break;
+      case(DelayInstruction::POLICY_OVERHEAD):
+         m_cpiSyncPolicyOverhead += insn_cost;
+         break;
       default:
          LOG_ASSERT_ERROR(false, "Unexpected DelayInstruction::type_t enum type. (%d)", delay_insn->getDelayType());
       }
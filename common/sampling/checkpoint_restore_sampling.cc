@@ -0,0 +1,72 @@
+#include "checkpoint_restore_sampling.h"
+#include "sampling_manager.h"
+#include "checkpoint_manager.h"
+#include "simulator.h"
+#include "core_manager.h"
+#include "performance_model.h"
+#include "fastforward_performance_model.h"
+#include "config.hpp"
+
+CheckpointRestoreSampling::CheckpointRestoreSampling(SamplingManager *sampling_manager)
+   : SamplingAlgorithm(sampling_manager)
+   , m_restore_time(Sim()->getCheckpointManager()->getRestoreTime())
+   // Time between core synchronizations in fast-forward mode
+   , m_fastforward_sync_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("checkpoint/fastforward_sync_interval")))
+   , m_started(false)
+   , m_restored(false)
+{
+   LOG_ASSERT_ERROR(m_fastforward_sync_interval > SubsecondTime::Zero(), "checkpoint/fastforward_sync_interval must be > 0");
+}
+
+void
+CheckpointRestoreSampling::callbackDetailed(SubsecondTime time)
+{
+   if (m_started)
+      return;
+   m_started = true;
+
+   if (time >= m_restore_time)
+   {
+      // Nothing to fast-forward
+      m_sampling_manager->resetCoreHistoricCPIs();
+      Sim()->getCheckpointManager()->restore();
+      m_restored = true;
+      return;
+   }
+
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      SubsecondTime cpi = Sim()->getCheckpointManager()->getRestoreCPI(core_id);
+      // Cores that were idle up to the checkpoint: assume one-ipc, they will not be executing instructions anyway
+      if (cpi == SubsecondTime::Zero())
+         cpi = core->getDvfsDomain()->getPeriod();
+      core->getPerformanceModel()->getFastforwardPerformanceModel()->setCurrentCPI(cpi);
+   }
+
+   stepFastForward(time);
+}
+
+void
+CheckpointRestoreSampling::callbackFastForward(SubsecondTime time, bool in_warmup)
+{
+   if (m_restored)
+      return;
+
+   if (time >= m_restore_time)
+   {
+      m_sampling_manager->disableFastForward();
+      m_sampling_manager->resetCoreHistoricCPIs();
+      Sim()->getCheckpointManager()->restore();
+      m_restored = true;
+   }
+   else
+      stepFastForward(time);
+}
+
+void
+CheckpointRestoreSampling::stepFastForward(SubsecondTime time)
+{
+   SubsecondTime until = std::min(time + m_fastforward_sync_interval, m_restore_time);
+   m_sampling_manager->enableFastForward(until, false, true /* detailed_sync */);
+}
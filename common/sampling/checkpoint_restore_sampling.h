@@ -0,0 +1,27 @@
+#ifndef __CHECKPOINT_RESTORE_SAMPLING
+#define __CHECKPOINT_RESTORE_SAMPLING
+
+#include "fixed_types.h"
+#include "sampling_algorithm.h"
+
+// Fast-forward to the time of the checkpoint being restored, at the per-core CPI of the checkpointed prefix,
+// then restore the checkpoint (CheckpointManager::restore) and simulate the rest in detail
+
+class CheckpointRestoreSampling : public SamplingAlgorithm
+{
+   private:
+      SubsecondTime m_restore_time;
+      SubsecondTime m_fastforward_sync_interval;
+      bool m_started;
+      bool m_restored;
+
+      void stepFastForward(SubsecondTime time);
+
+   public:
+      CheckpointRestoreSampling(SamplingManager *sampling_manager);
+
+      virtual void callbackDetailed(SubsecondTime now);
+      virtual void callbackFastForward(SubsecondTime now, bool in_warmup);
+};
+
+#endif /* __CHECKPOINT_RESTORE_SAMPLING */
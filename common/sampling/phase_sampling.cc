@@ -0,0 +1,226 @@
+#include "phase_sampling.h"
+#include "sampling_manager.h"
+#include "simulator.h"
+#include "core_manager.h"
+#include "performance_model.h"
+#include "fastforward_performance_model.h"
+#include "config.hpp"
+#include "stats.h"
+
+#include <cmath>
+
+PhaseSampling::PhaseSampling(SamplingManager *sampling_manager)
+   : SamplingAlgorithm(sampling_manager)
+   // Length of an interval, the unit of phase classification
+   , m_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/phase/interval")))
+   // Time between core synchronizations in fast-forward mode
+   , m_fastforward_sync_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/phase/fastforward_sync_interval")))
+   // Start of a detailed interval that is not used for the CPI of its phase
+   , m_detailed_warmup_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/phase/detailed_warmup_interval")))
+   // Maximum distance between an interval and the centroid of its phase
+   , m_threshold(Sim()->getCfg()->getFloat("sampling/phase/threshold"))
+   , m_max_phases(Sim()->getCfg()->getInt("sampling/phase/max_phases"))
+   // Number of detailed intervals per phase before it is fast-forwarded
+   , m_detailed_per_phase(Sim()->getCfg()->getInt("sampling/phase/detailed_per_phase"))
+   , m_detailed_sync(Sim()->getCfg()->getBool("sampling/phase/detailed_sync"))
+   , m_dispatch_width(Sim()->getCfg()->getInt("perf_model/core/interval_timer/dispatch_width"))
+   , m_signature(Sim()->getConfig()->getApplicationCores() * BbvCount::NUM_BBV, 0.)
+   , m_bbv_last(Sim()->getConfig()->getApplicationCores() * (1 + BbvCount::NUM_BBV), 0)
+   , m_interval_start(SubsecondTime::Zero())
+   , m_last_callback(SubsecondTime::Zero())
+   , m_detailed_warmup(false)
+   , m_phase_current(0)
+   , m_num_phases(0)
+   , m_detailed_intervals(0)
+   , m_fastforward_intervals(0)
+   , m_fastforward_time(SubsecondTime::Zero())
+{
+   LOG_ASSERT_ERROR(m_interval > SubsecondTime::Zero(), "sampling/phase/interval must be > 0");
+   LOG_ASSERT_ERROR(m_fastforward_sync_interval > SubsecondTime::Zero() && m_fastforward_sync_interval <= m_interval, "fastforward_sync_interval must be between 0 and interval");
+   LOG_ASSERT_ERROR(m_max_phases > 0, "sampling/phase/max_phases must be >= 1");
+
+   // Phase classification needs BBVs, also while fast-forwarding
+   Sim()->getConfig()->setBBVsEnabled(true);
+
+   registerStatsMetric("sampling", 0, "phase", &m_phase_current);
+   registerStatsMetric("sampling", 0, "phases", &m_num_phases);
+   registerStatsMetric("sampling", 0, "detailed-intervals", &m_detailed_intervals);
+   registerStatsMetric("sampling", 0, "fastforward-intervals", &m_fastforward_intervals);
+   registerStatsMetric("sampling", 0, "fastforward-time", &m_fastforward_time);
+}
+
+void
+PhaseSampling::callbackDetailed(SubsecondTime time)
+{
+   m_last_callback = time;
+
+   if (m_detailed_warmup && time > m_interval_start + m_detailed_warmup_interval)
+   {
+      m_sampling_manager->resetCoreHistoricCPIs();
+      m_detailed_warmup = false;
+   }
+
+   if (time >= m_interval_start + m_interval)
+      endInterval(time, true);
+}
+
+void
+PhaseSampling::callbackFastForward(SubsecondTime time, bool in_warmup)
+{
+   if (time > m_last_callback)
+      m_fastforward_time += time - m_last_callback;
+   m_last_callback = time;
+
+   if (time >= m_interval_start + m_interval)
+      endInterval(time, false);
+   else
+      stepFastForward(time);
+}
+
+void
+PhaseSampling::computeSignature()
+{
+   // Per core, the BBV of the last interval normalized to its instruction count.
+   // The random projection weights are 16-bit, so each dimension ends up in [0, 1).
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      BbvCount *bbv = Sim()->getCoreManager()->getCoreFromID(core_id)->getBbvCount();
+      UInt64 *last = &m_bbv_last[core_id * (1 + BbvCount::NUM_BBV)];
+
+      UInt64 icount = bbv->getInstructionCount();
+      // BbvCount::reset() may have restarted the counts, in which case they all belong to this interval
+      bool restarted = icount < last[0];
+      UInt64 d_icount = restarted ? icount : icount - last[0];
+      last[0] = icount;
+
+      for(int i = 0; i < BbvCount::NUM_BBV; ++i)
+      {
+         UInt64 dim = bbv->getDimension(i);
+         UInt64 d_dim = restarted ? dim : dim - last[1 + i];
+         last[1 + i] = dim;
+         m_signature[core_id * BbvCount::NUM_BBV + i] = d_icount ? double(d_dim) / (double(d_icount) * 65536.) : 0.;
+      }
+   }
+}
+
+UInt32
+PhaseSampling::classify()
+{
+   UInt32 best = 0;
+   double best_distance = INFINITY;
+   for(UInt32 phase_id = 0; phase_id < m_phases.size(); ++phase_id)
+   {
+      double distance = 0;
+      for(UInt32 i = 0; i < m_signature.size(); ++i)
+         distance += fabs(m_signature[i] - m_phases[phase_id].centroid[i]);
+      distance /= m_signature.size();
+      if (distance < best_distance)
+      {
+         best = phase_id;
+         best_distance = distance;
+      }
+   }
+
+   if (best_distance > m_threshold && m_phases.size() < m_max_phases)
+   {
+      // Leader-follower clustering: an interval that is far from all phases starts a new one
+      Phase phase;
+      phase.centroid = m_signature;
+      phase.num_intervals = 0;
+      phase.num_detailed = 0;
+      phase.cpi.resize(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero());
+      m_phases.push_back(phase);
+      best = m_phases.size() - 1;
+      m_num_phases = m_phases.size();
+   }
+
+   Phase &phase = m_phases[best];
+   ++phase.num_intervals;
+   for(UInt32 i = 0; i < m_signature.size(); ++i)
+      phase.centroid[i] += (m_signature[i] - phase.centroid[i]) / phase.num_intervals;
+
+   return best;
+}
+
+void
+PhaseSampling::recordCPI(Phase &phase)
+{
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      SubsecondTime cpi = m_sampling_manager->getCoreHistoricCPI(core, m_detailed_sync, (m_interval - m_detailed_warmup_interval) / 5);
+      // Only use intervals in which the core executed instructions for at least 20% of the time
+      if (cpi == SubsecondTime::Zero() || cpi == SubsecondTime::MaxTime())
+         continue;
+      if (phase.cpi[core_id] == SubsecondTime::Zero())
+         phase.cpi[core_id] = cpi;
+      else
+         phase.cpi[core_id] = (phase.cpi[core_id] * phase.num_detailed + cpi) / (phase.num_detailed + 1);
+   }
+}
+
+void
+PhaseSampling::setFastForwardCPI(const Phase &phase)
+{
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      SubsecondTime period = core->getDvfsDomain()->getPeriod();
+      SubsecondTime cpi = phase.cpi[core_id];
+
+      if (cpi == SubsecondTime::Zero())
+         cpi = period; // No detailed measurement for this core, assume one-ipc
+      SubsecondTime min_cpi = period / m_dispatch_width;
+      if (cpi < min_cpi)
+         cpi = min_cpi; // max. m_dispatch_width IPC
+      else if (cpi > period * 100)
+         cpi = period * 100; // min. .01 IPC
+
+      core->getPerformanceModel()->getFastforwardPerformanceModel()->setCurrentCPI(cpi);
+   }
+}
+
+void
+PhaseSampling::endInterval(SubsecondTime time, bool detailed)
+{
+   computeSignature();
+   UInt32 phase_id = classify();
+   Phase &phase = m_phases[phase_id];
+
+   if (detailed)
+   {
+      // Intervals that ended before their detailed warmup completed do not provide a CPI
+      if (!m_detailed_warmup)
+      {
+         recordCPI(phase);
+         ++phase.num_detailed;
+      }
+      ++m_detailed_intervals;
+   }
+   else
+      ++m_fastforward_intervals;
+
+   m_phase_current = phase_id;
+   m_interval_start = time;
+
+   // Predict that the next interval is in the same phase as the last one
+   if (phase.num_detailed < m_detailed_per_phase)
+   {
+      if (!detailed)
+         m_sampling_manager->disableFastForward();
+      m_sampling_manager->resetCoreHistoricCPIs();
+      m_detailed_warmup = m_detailed_warmup_interval > SubsecondTime::Zero();
+   }
+   else
+   {
+      setFastForwardCPI(phase);
+      stepFastForward(time);
+   }
+}
+
+void
+PhaseSampling::stepFastForward(SubsecondTime time)
+{
+   SubsecondTime until = std::min(time + m_fastforward_sync_interval, m_interval_start + m_interval);
+   m_sampling_manager->enableFastForward(until, false, m_detailed_sync);
+}
@@ -0,0 +1,66 @@
+#ifndef __PHASE_SAMPLING
+#define __PHASE_SAMPLING
+
+#include "fixed_types.h"
+#include "sampling_algorithm.h"
+#include "bbv_count.h"
+
+#include <vector>
+
+// Phase-based sampling: execution is cut into fixed-length intervals, the BBV of each interval is
+// clustered online into phases (leader-follower clustering). The next interval is predicted to be in
+// the same phase as the last one. Phases that have not yet been simulated in detail often enough are
+// simulated in detail, all others are fast-forwarded using the CPI measured for that phase.
+// The current phase and fast-forwarded time are exported as statistics (sampling.*), so power and
+// thermal models can extrapolate per-phase power through fast-forwarded intervals (memTherm_core.py).
+
+class PhaseSampling : public SamplingAlgorithm
+{
+   private:
+      struct Phase
+      {
+         std::vector<double> centroid;       // Average signature of all intervals in this phase
+         UInt64 num_intervals;
+         UInt64 num_detailed;
+         std::vector<SubsecondTime> cpi;     // Per core, average over the detailed intervals
+      };
+
+      SubsecondTime m_interval;
+      SubsecondTime m_fastforward_sync_interval;
+      SubsecondTime m_detailed_warmup_interval;
+      double m_threshold;
+      UInt32 m_max_phases;
+      UInt32 m_detailed_per_phase;
+      bool m_detailed_sync;
+      int m_dispatch_width;
+
+      std::vector<Phase> m_phases;
+      std::vector<double> m_signature;
+      std::vector<UInt64> m_bbv_last;         // Per core: instruction count, NUM_BBV dimensions at the start of the interval
+
+      SubsecondTime m_interval_start;
+      SubsecondTime m_last_callback;
+      bool m_detailed_warmup;
+
+      // Statistics
+      UInt64 m_phase_current;
+      UInt64 m_num_phases;
+      UInt64 m_detailed_intervals;
+      UInt64 m_fastforward_intervals;
+      SubsecondTime m_fastforward_time;
+
+      void computeSignature();
+      UInt32 classify();
+      void recordCPI(Phase &phase);
+      void setFastForwardCPI(const Phase &phase);
+      void endInterval(SubsecondTime time, bool detailed);
+      void stepFastForward(SubsecondTime time);
+
+   public:
+      PhaseSampling(SamplingManager *sampling_manager);
+
+      virtual void callbackDetailed(SubsecondTime now);
+      virtual void callbackFastForward(SubsecondTime now, bool in_warmup);
+};
+
+#endif /* __PHASE_SAMPLING */
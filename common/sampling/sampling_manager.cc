@@ -10,9 +10,12 @@
 #include "config.hpp"
 #include "magic_client.h"
 #include "sampling_provider.h"
+#include "instr_count_sampling.h"
+#include "checkpoint_restore_sampling.h"
+#include "checkpoint_manager.h"
 
 SamplingManager::SamplingManager(void)
-   : m_sampling_enabled(Sim()->getCfg()->getBool("sampling/enabled"))
+   : m_sampling_enabled(Sim()->getCfg()->getBool("sampling/enabled") || Sim()->getCheckpointManager()->isRestoring())
    , m_fastforward(false)
    , m_warmup(false)
    , m_target_ffend(SubsecondTime::Zero())
@@ -25,15 +28,28 @@ SamplingManager::SamplingManager(void)
    if (! m_sampling_enabled)
       return;
 
-   m_uncoordinated = Sim()->getCfg()->getBool("sampling/uncoordinated");
+   // Restoring a checkpoint uses the sampling infrastructure to fast-forward up to the checkpoint
+   bool restore = Sim()->getCheckpointManager()->isRestoring();
+   LOG_ASSERT_ERROR(!(restore && Sim()->getCfg()->getBool("sampling/enabled")), "Sampling cannot be combined with restoring a checkpoint");
 
-   LOG_ASSERT_ERROR(Sim()->getConfig()->getSimulationMode() == Config::PINTOOL, "Sampling is only supported in Pin mode");
+   m_uncoordinated = restore ? false : Sim()->getCfg()->getBool("sampling/uncoordinated");
+
+   // SIFT fast-forward counts instructions without their basic block addresses, so BBVs (and phase signatures) would be empty
+   LOG_ASSERT_ERROR(restore || Sim()->getConfig()->getSimulationMode() == Config::PINTOOL, "Sampling is only supported in Pin mode");
 
    Sim()->getHooksManager()->registerHook(HookType::HOOK_INSTR_COUNT, (HooksManager::HookCallbackFunc)SamplingManager::hook_instr_count, (UInt64)this);
    Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, (HooksManager::HookCallbackFunc)SamplingManager::hook_periodic, (UInt64)this);
 
-   m_sampling_provider = SamplingProvider::create();
-   m_sampling_algorithm = SamplingAlgorithm::create(this);
+   if (restore)
+   {
+      m_sampling_provider = new InstrCountSampling();
+      m_sampling_algorithm = new CheckpointRestoreSampling(this);
+   }
+   else
+   {
+      m_sampling_provider = SamplingProvider::create();
+      m_sampling_algorithm = SamplingAlgorithm::create(this);
+   }
 }
 
 SamplingManager::~SamplingManager(void)
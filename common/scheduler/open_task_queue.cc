@@ -0,0 +1,152 @@
+#include "open_task_queue.h"
+
+#include <climits>
+#include <iostream>
+
+using namespace std;
+
+OpenTaskQueue::OpenTaskQueue(queuePolicy_t queuePolicy)
+	: queuePolicy(queuePolicy),
+	  activeCoreRequirements(0),
+	  pendingArrivals(arrivalOrder{&tasks}),
+	  arrivalsInitialized(false),
+	  queueSequence(0) {
+	for (int state = 0; state < NUM_TASK_STATES; state++) {
+		stateHead[state] = -1;
+		stateTail[state] = -1;
+		stateCount[state] = 0;
+	}
+}
+
+OpenTaskQueue::queuePolicy_t OpenTaskQueue::parseQueuePolicy(String name) {
+	if (name == "FIFO") {
+		return FIFO;
+	} else if (name == "priority") {
+		return PRIORITY;
+	} else if (name == "EDF") {
+		return EDF;
+	} //else if (name ="XYZ") {... } //Place to add a new queuing policy.
+	else {
+		cout << "\n[Scheduler] [Error]: Unknown Queuing Policy: " << name << endl;
+		exit (1);
+	}
+}
+
+void OpenTaskQueue::addTask(const openTask &task) {
+	tasks.push_back(task);
+	openTask &t = tasks.back();
+	t.taskID = tasks.size() - 1;
+	t.state = TASK_WAITING_TO_SCHEDULE;
+	link(t.taskID);
+}
+
+void OpenTaskQueue::unlink(int taskID) {
+	openTask &task = tasks[taskID];
+	if (task.prevInState != -1) {
+		tasks[task.prevInState].nextInState = task.nextInState;
+	} else {
+		stateHead[task.state] = task.nextInState;
+	}
+	if (task.nextInState != -1) {
+		tasks[task.nextInState].prevInState = task.prevInState;
+	} else {
+		stateTail[task.state] = task.prevInState;
+	}
+	task.prevInState = -1;
+	task.nextInState = -1;
+	stateCount[task.state]--;
+
+	if (task.state == TASK_ACTIVE) {
+		activeCoreRequirements -= task.taskCoreRequirement;
+	} else if (task.state == TASK_WAITING_IN_QUEUE) {
+		queueOrder.erase(std::make_tuple(queueKey(task), task.queueSequence, taskID));
+	}
+}
+
+void OpenTaskQueue::link(int taskID) {
+	openTask &task = tasks[taskID];
+	task.prevInState = stateTail[task.state];
+	task.nextInState = -1;
+	if (stateTail[task.state] != -1) {
+		tasks[stateTail[task.state]].nextInState = taskID;
+	} else {
+		stateHead[task.state] = taskID;
+	}
+	stateTail[task.state] = taskID;
+	stateCount[task.state]++;
+
+	if (task.state == TASK_ACTIVE) {
+		activeCoreRequirements += task.taskCoreRequirement;
+	} else if (task.state == TASK_WAITING_IN_QUEUE) {
+		task.queueSequence = queueSequence++;
+		queueOrder.insert(std::make_tuple(queueKey(task), task.queueSequence, taskID));
+	}
+}
+
+void OpenTaskQueue::setState(int taskID, openTaskState state) {
+	if (tasks[taskID].state == state) {
+		return;
+	}
+	unlink(taskID);
+	tasks[taskID].state = state;
+	link(taskID);
+}
+
+UInt64 OpenTaskQueue::queueKey(const openTask &task) const {
+	switch (queuePolicy) {
+		case PRIORITY:
+			return (UInt64)((SInt64)INT_MAX - task.taskPriority);
+		case EDF:
+			return task.taskDeadline == 0 ? UINT64_MAX : task.taskArrivalTime + task.taskDeadline;
+		case FIFO:
+		default:
+			return 0;
+	}
+}
+
+int OpenTaskQueue::front() const {
+	if (queueOrder.empty()) {
+		return -1;
+	}
+	return std::get<2>(*queueOrder.begin());
+}
+
+void OpenTaskQueue::initArrivals() {
+	for (int taskID = stateHead[TASK_WAITING_TO_SCHEDULE]; taskID != -1; taskID = tasks[taskID].nextInState) {
+		pendingArrivals.push(taskID);
+	}
+	arrivalsInitialized = true;
+}
+
+UInt64 OpenTaskQueue::nextArrivalTime() {
+	if (!arrivalsInitialized) {
+		initArrivals();
+	}
+	while (!pendingArrivals.empty() && tasks[pendingArrivals.top()].state != TASK_WAITING_TO_SCHEDULE) {
+		pendingArrivals.pop();
+	}
+	return pendingArrivals.empty() ? UINT64_MAX : tasks[pendingArrivals.top()].taskArrivalTime;
+}
+
+int OpenTaskQueue::fetchArrivedTask(UInt64 now) {
+	if (nextArrivalTime() > now) {
+		return -1;
+	}
+	int taskID = pendingArrivals.top();
+	pendingArrivals.pop();
+	setState(taskID, TASK_WAITING_IN_QUEUE);
+	return taskID;
+}
+
+void OpenTaskQueue::advancePendingArrivals(UInt64 delta) {
+	for (int taskID = stateHead[TASK_WAITING_TO_SCHEDULE]; taskID != -1; taskID = tasks[taskID].nextInState) {
+		tasks[taskID].taskArrivalTime -= delta;
+	}
+
+	// The keys of the entries in pendingArrivals changed in place. Stale entries of tasks that already
+	// arrived were not shifted, so rebuild the heap from the tasks that are still pending.
+	while (!pendingArrivals.empty()) {
+		pendingArrivals.pop();
+	}
+	initArrivals();
+}
@@ -0,0 +1,117 @@
+/**
+ * open_task_queue
+ * This header implements the indexed task state of the open scheduler.
+ * Every task is linked into an intrusive list of its current state, so that state counts and iteration over
+ * the tasks of one state do not need to scan all tasks. Tasks that did not arrive yet are kept in a priority
+ * queue on their arrival time, and queued tasks are ordered according to the queuing policy.
+ */
+
+#ifndef __OPEN_TASK_QUEUE_H
+#define __OPEN_TASK_QUEUE_H
+
+#include "fixed_types.h"
+
+#include <queue>
+#include <set>
+#include <tuple>
+#include <vector>
+
+enum openTaskState {
+	TASK_WAITING_TO_SCHEDULE,  // not yet arrived
+	TASK_WAITING_IN_QUEUE,     // arrived, waiting for cores
+	TASK_ACTIVE,
+	TASK_COMPLETED,
+	NUM_TASK_STATES
+};
+
+//This data structure maintains the state of the tasks.
+struct openTask {
+	openTask(int taskIDInput, String taskNameInput, int taskCoreRequirement)
+	: taskID(taskIDInput), taskName(taskNameInput), taskCoreRequirement(taskCoreRequirement) {}
+
+	int taskID;
+	String taskName;
+	openTaskState state = TASK_WAITING_TO_SCHEDULE;
+	int taskCoreRequirement;
+	int taskPriority = 0;  // higher value is scheduled first with the "priority" queuing policy
+	UInt64 taskArrivalTime = 0;
+	UInt64 taskDeadline = 0;  // relative to the arrival time, 0 means no deadline
+	UInt64 taskStartTime = 0;
+	UInt64 taskDepartureTime = 0;
+
+	// intrusive list of the tasks in the same state
+	int prevInState = -1;
+	int nextInState = -1;
+	UInt64 queueSequence = 0;
+};
+
+class OpenTaskQueue {
+public:
+	enum queuePolicy_t {
+		FIFO,
+		PRIORITY,
+		EDF
+	};
+
+	OpenTaskQueue(queuePolicy_t queuePolicy);
+
+	// Add a new task. All tasks must be added before the first state change.
+	void addTask(const openTask &task);
+
+	openTask &operator[] (int taskID) { return tasks[taskID]; }
+	const openTask &operator[] (int taskID) const { return tasks[taskID]; }
+	int size() const { return tasks.size(); }
+
+	void setState(int taskID, openTaskState state);
+	int count(openTaskState state) const { return stateCount[state]; }
+	int first(openTaskState state) const { return stateHead[state]; }  // iterate with next()
+	int next(int taskID) const { return tasks[taskID].nextInState; }
+	int totalCoreRequirementsOfActiveTasks() const { return activeCoreRequirements; }
+
+	// Task in front of the queue according to the queuing policy, or -1 if the queue is empty.
+	int front() const;
+
+	// Earliest arrival time of the tasks that did not arrive yet, or UINT64_MAX if there are none.
+	UInt64 nextArrivalTime();
+
+	// Move the next task that arrived at or before time "now" into the queue. Returns its ID, or -1 if no
+	// further task has arrived.
+	int fetchArrivedTask(UInt64 now);
+
+	// Move the arrival time of all tasks that did not arrive yet earlier by "delta".
+	void advancePendingArrivals(UInt64 delta);
+
+	static queuePolicy_t parseQueuePolicy(String name);
+
+private:
+	const queuePolicy_t queuePolicy;
+	std::vector<openTask> tasks;
+
+	int stateHead[NUM_TASK_STATES];
+	int stateTail[NUM_TASK_STATES];
+	int stateCount[NUM_TASK_STATES];
+	int activeCoreRequirements;
+
+	// Pending arrivals, ordered on (arrival time, task ID). Entries of tasks that left the
+	// TASK_WAITING_TO_SCHEDULE state otherwise are dropped lazily.
+	struct arrivalOrder {
+		const std::vector<openTask> *tasks;
+		bool operator() (int a, int b) const {
+			const openTask &ta = (*tasks)[a], &tb = (*tasks)[b];
+			return ta.taskArrivalTime != tb.taskArrivalTime ? ta.taskArrivalTime > tb.taskArrivalTime : a > b;
+		}
+	};
+	std::priority_queue<int, std::vector<int>, arrivalOrder> pendingArrivals;
+	bool arrivalsInitialized;
+	void initArrivals();
+
+	// Queued tasks, ordered on (policy key, queue entry order, task ID).
+	std::set<std::tuple<UInt64, UInt64, int> > queueOrder;
+	UInt64 queueSequence;
+	UInt64 queueKey(const openTask &task) const;
+
+	void unlink(int taskID);
+	void link(int taskID);
+};
+
+#endif
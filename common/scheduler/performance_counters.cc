@@ -190,6 +190,7 @@ double PerformanceCounters::getUtilizationOfCore(int coreId) const {
 		    (part.find("ifetch") == std::string::npos) &&
 		    (part.find("sync") == std::string::npos) &&
 		    (part.find("dvfs-transition") == std::string::npos) &&
+		    (part.find("policy-overhead") == std::string::npos) &&
 		    (part.find("imbalance") == std::string::npos) &&
 		    (part.find("other") == std::string::npos)) {
 
@@ -0,0 +1,61 @@
+#include "dvfsQoS.h"
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+DVFSQoS::DVFSQoS(
+        const PerformanceCounters *performanceCounters,
+        const TaskProgress *taskProgress,
+        int numberOfCores,
+        int minFrequency,
+        int maxFrequency,
+        int frequencyStepSize,
+        float boostSlowdown,
+        float relaxSlowdown)
+    : performanceCounters(performanceCounters),
+      taskProgress(taskProgress),
+      numberOfCores(numberOfCores),
+      minFrequency(minFrequency),
+      maxFrequency(maxFrequency),
+      frequencyStepSize(frequencyStepSize),
+      boostSlowdown(boostSlowdown),
+      relaxSlowdown(relaxSlowdown) {
+
+}
+
+std::vector<int> DVFSQoS::getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores) {
+    std::vector<int> frequencies(numberOfCores);
+
+    for (unsigned int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
+        if (activeCores.at(coreCounter)) {
+            int taskID = taskProgress->getTaskOfCore(coreCounter);
+            float slowdown = taskProgress->getSlowdownOfCore(coreCounter);
+            bool behindDeadline = (taskID != -1) && taskProgress->isBehindDeadline(taskID);
+            int frequency = oldFrequencies.at(coreCounter);
+
+            cout << "[Scheduler][qos]: Core " << setw(2) << coreCounter << ":";
+            cout << " task=" << taskID;
+            cout << "  f=" << frequency << " MHz";
+            cout << "  slowdown=" << fixed << setprecision(3) << slowdown;
+            cout << "  behind_deadline=" << behindDeadline << endl;
+
+            if (behindDeadline || slowdown > boostSlowdown) {
+                // task falls behind -> boost
+                frequency = maxFrequency;
+            } else if (slowdown >= 0 && slowdown < relaxSlowdown) {
+                // task runs close to its isolated performance -> save power
+                frequency -= frequencyStepSize;
+                if (frequency < minFrequency) {
+                    frequency = minFrequency;
+                }
+            }
+
+            frequencies.at(coreCounter) = frequency;
+        } else {
+            frequencies.at(coreCounter) = minFrequency;
+        }
+    }
+
+    return frequencies;
+}
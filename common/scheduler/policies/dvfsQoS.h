@@ -0,0 +1,41 @@
+/**
+ * This header implements a QoS-aware DVFS policy.
+ * Cores that run a task that falls behind its isolated-run baseline (slowdown above the boost threshold) or
+ * behind its deadline are boosted to the maximum frequency. Cores whose task is close to its isolated
+ * performance are slowed down step by step to save power.
+ */
+
+#ifndef __DVFS_QOS_H
+#define __DVFS_QOS_H
+
+#include <vector>
+#include "dvfspolicy.h"
+#include "performance_counters.h"
+#include "task_progress.h"
+
+class DVFSQoS : public DVFSPolicy {
+public:
+    DVFSQoS(
+        const PerformanceCounters *performanceCounters,
+        const TaskProgress *taskProgress,
+        int numberOfCores,
+        int minFrequency,
+        int maxFrequency,
+        int frequencyStepSize,
+        float boostSlowdown,
+        float relaxSlowdown);
+    virtual std::vector<int> getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores);
+
+private:
+    const PerformanceCounters *performanceCounters;
+    const TaskProgress *taskProgress;
+
+    unsigned int numberOfCores;
+    int minFrequency;
+    int maxFrequency;
+    int frequencyStepSize;
+    float boostSlowdown;
+    float relaxSlowdown;
+};
+
+#endif
@@ -13,7 +13,7 @@ MapFirstUnused::MapFirstUnused(unsigned int numberOfCores, std::vector<int> pref
 	}
 }
 
-std::vector<int> MapFirstUnused::map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores) {
+std::vector<int> MapFirstUnused::map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores, const TaskProgress *taskProgress) {
 	std::vector<int> cores;
 
 	// try to fill with preferred cores
@@ -10,7 +10,7 @@
 class MapFirstUnused : public MappingPolicy {
 public:
     MapFirstUnused(unsigned int numberOfCores, std::vector<int> preferredCoresOrder);
-    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores);
+    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores, const TaskProgress *taskProgress);
 
 private:
     unsigned int numberOfCores;
@@ -1,18 +1,20 @@
 /**
  * This header implements the MappingPolicy interface.
  * A mapping policy is responsible for task mapping.
+ * It gets the progress of the running tasks to take their slowdown and deadlines into account.
  */
 
 #ifndef __MAPPINGPOLICY_H
 #define __MAPPINGPOLICY_H
 
 #include "fixed_types.h"
+#include "task_progress.h"
 #include <vector>
 
 class MappingPolicy {
 public:
     virtual ~MappingPolicy() {}
-    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores) = 0;
+    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores, const TaskProgress *taskProgress) = 0;
 };
 
 #endif
@@ -0,0 +1,73 @@
+#include "policy_overhead.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "core_manager.h"
+#include "performance_model.h"
+#include "instruction.h"
+#include "stats.h"
+
+#include <iostream>
+
+using namespace std;
+
+PolicyOverhead::PolicyOverhead()
+	: enabled(Sim()->getCfg()->getBool("scheduler/open/overhead/enabled")),
+	  measured(false),
+	  hostTimeScale(Sim()->getCfg()->getFloat("scheduler/open/overhead/host_time_scale")),
+	  managementCore(Sim()->getCfg()->getInt("scheduler/open/overhead/core")) {
+
+	String mode = Sim()->getCfg()->getString("scheduler/open/overhead/mode");
+	if (mode == "measured") {
+		measured = true;
+	} else if (mode != "fixed") {
+		cout << "\n[Scheduler] [Error]: Unknown policy overhead mode: " << mode << endl;
+		exit (1);
+	}
+
+	if (enabled && (managementCore < 0 || managementCore >= (core_id_t)Sim()->getConfig()->getApplicationCores())) {
+		cout << "\n[Scheduler] [Error]: Invalid policy overhead core: " << managementCore << endl;
+		exit (1);
+	}
+
+	for (int policy = 0; policy < NUM_POLICIES; policy++) {
+		fixedCost[policy] = SubsecondTime::NS(Sim()->getCfg()->getInt(String("scheduler/open/overhead/") + policyName((policy_t)policy)));
+		invocations[policy] = 0;
+		chargedTime[policy] = SubsecondTime::Zero();
+		registerStatsMetric("scheduler", 0, String(policyName((policy_t)policy)) + "-invocations", &invocations[policy]);
+		registerStatsMetric("scheduler", 0, String(policyName((policy_t)policy)) + "-overhead", &chargedTime[policy]);
+	}
+}
+
+const char *PolicyOverhead::policyName(policy_t policy) {
+	switch (policy) {
+		case MAPPING: return "mapping";
+		case DVFS: return "dvfs";
+		case DRAM: return "dram";
+		case MIGRATION: return "migration";
+		default: return "unknown";
+	}
+}
+
+void PolicyOverhead::begin() {
+	if (enabled && measured) {
+		hostTimer.start();
+	}
+}
+
+void PolicyOverhead::end(policy_t policy) {
+	invocations[policy]++;
+
+	if (!enabled) {
+		return;
+	}
+
+	SubsecondTime cost = measured ? SubsecondTime::NS(hostTimer.getTime() * hostTimeScale) : fixedCost[policy];
+	if (cost == SubsecondTime::Zero()) {
+		return;
+	}
+
+	// The management core executes the policy, so whatever runs there loses this time slice.
+	PseudoInstruction *i = new DelayInstruction(cost, DelayInstruction::POLICY_OVERHEAD);
+	Sim()->getCoreManager()->getCoreFromID(managementCore)->getPerformanceModel()->queuePseudoInstruction(i);
+	chargedTime[policy] += cost;
+}
@@ -0,0 +1,47 @@
+/**
+ * policy_overhead
+ * This header implements the cost model for the decisions of the open scheduler policies.
+ * Without it, policies run for free in simulated time. When enabled, every policy invocation is charged
+ * to a designated management core as a stolen time slice, either with a fixed cost per policy or with
+ * the (scaled) host time that the policy took to make its decision.
+ */
+
+#ifndef __POLICY_OVERHEAD_H
+#define __POLICY_OVERHEAD_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "timer.h"
+
+class PolicyOverhead {
+public:
+	enum policy_t {
+		MAPPING,
+		DVFS,
+		DRAM,
+		MIGRATION,
+		NUM_POLICIES
+	};
+
+	PolicyOverhead();
+
+	// Call around a policy invocation. end() charges the cost of the decision to the management core.
+	void begin();
+	void end(policy_t policy);
+
+private:
+	bool enabled;
+	bool measured;  // charge the measured host time instead of the fixed cost
+	double hostTimeScale;  // simulated ns charged per host ns in measured mode
+	core_id_t managementCore;
+	SubsecondTime fixedCost[NUM_POLICIES];
+
+	Timer hostTimer;
+
+	UInt64 invocations[NUM_POLICIES];
+	SubsecondTime chargedTime[NUM_POLICIES];
+
+	static const char *policyName(policy_t policy);
+};
+
+#endif
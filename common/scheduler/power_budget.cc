@@ -0,0 +1,200 @@
+#include "power_budget.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "stats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+
+using namespace std;
+
+PowerBudget::PowerBudget(const PerformanceCounters *performanceCounters, int numberOfCores, int minFrequency, int maxFrequency, int frequencyStepSize)
+	: performanceCounters(performanceCounters),
+	  numberOfCores(numberOfCores),
+	  minFrequency(minFrequency),
+	  maxFrequency(maxFrequency),
+	  frequencyStepSize(frequencyStepSize),
+	  useTSP(false),
+	  tdp(0),
+	  staticPower(Sim()->getCfg()->getFloat("scheduler/open/power_budget/static_power")),
+	  cappedEpochs(0) {
+
+	String mode = Sim()->getCfg()->getString("scheduler/open/power_budget/mode");
+	if (mode == "tdp") {
+		tdp = Sim()->getCfg()->getFloat("scheduler/open/power_budget/tdp");
+	} else if (mode == "tsp") {
+		useTSP = true;
+		computeTSPTable(
+			Sim()->getCfg()->getString("scheduler/open/power_budget/tsp/thermal_resistance_file"),
+			Sim()->getCfg()->getFloat("scheduler/open/power_budget/tsp/critical_temperature"),
+			Sim()->getCfg()->getFloat("scheduler/open/power_budget/tsp/ambient_temperature"),
+			Sim()->getCfg()->getFloat("scheduler/open/power_budget/tsp/inactive_power"));
+	} else {
+		cout << "\n[Scheduler] [Error]: Unknown power budget mode: " << mode << endl;
+		exit (1);
+	}
+
+	registerStatsMetric("scheduler", 0, "power-budget-capped-epochs", &cappedEpochs);
+}
+
+/** computeTSPTable
+ * Compute the per-core Thermal Safe Power for every number of active cores m. The file holds the
+ * numberOfCores x numberOfCores thermal resistance matrix (K/W), one row per line.
+ * For each core i, the worst case is that the m-1 cores heating core i the most are active together with i,
+ * while all others dissipate the inactive power:
+ *   TSP(m) = min_i (T_crit - T_amb - P_inactive * sum_{j inactive} R_ij) / (sum_{j active} R_ij)
+ */
+void PowerBudget::computeTSPTable(String thermalResistanceFileName, double criticalTemperature, double ambientTemperature, double inactivePower) {
+	ifstream file(thermalResistanceFileName.c_str());
+	if (!file.good()) {
+		cout << "\n[Scheduler] [Error]: Cannot open thermal resistance file '" << thermalResistanceFileName << "'" << endl;
+		exit (1);
+	}
+
+	vector<vector<double>> resistance(numberOfCores, vector<double>(numberOfCores));
+	for (unsigned int i = 0; i < numberOfCores; i++) {
+		for (unsigned int j = 0; j < numberOfCores; j++) {
+			if (!(file >> resistance[i][j])) {
+				cout << "\n[Scheduler] [Error]: Thermal resistance file '" << thermalResistanceFileName << "' must contain a " << numberOfCores << "x" << numberOfCores << " matrix" << endl;
+				exit (1);
+			}
+		}
+	}
+
+	tspTable.assign(numberOfCores + 1, 0);
+	for (unsigned int m = 1; m <= numberOfCores; m++) {
+		double tsp = -1;
+		for (unsigned int i = 0; i < numberOfCores; i++) {
+			// core i itself is always active, the m-1 other cores with the highest influence on i are active too
+			vector<double> others;
+			for (unsigned int j = 0; j < numberOfCores; j++) {
+				if (j != i) {
+					others.push_back(resistance[i][j]);
+				}
+			}
+			sort(others.begin(), others.end(), greater<double>());
+
+			double activeResistance = resistance[i][i];
+			double inactiveResistance = 0;
+			for (unsigned int k = 0; k < others.size(); k++) {
+				if (k < m - 1) {
+					activeResistance += others[k];
+				} else {
+					inactiveResistance += others[k];
+				}
+			}
+
+			double coreTSP = (criticalTemperature - ambientTemperature - inactivePower * inactiveResistance) / activeResistance;
+			if (tsp < 0 || coreTSP < tsp) {
+				tsp = coreTSP;
+			}
+		}
+		tspTable[m] = max(tsp, 0.0);
+		cout << "[Scheduler][power-budget]: TSP for " << setw(2) << m << " active cores: " << fixed << setprecision(3) << tspTable[m] << " W per core" << endl;
+	}
+}
+
+double PowerBudget::getBudget(int activeCores) const {
+	if (!useTSP) {
+		return tdp;
+	}
+	if (activeCores == 0) {
+		return tspTable[1];
+	}
+	return tspTable[activeCores] * activeCores;
+}
+
+/** estimatePower
+ * Estimate the power of a core at the given frequency from its measured power at the measured frequency.
+ * The dynamic part scales with f*V^2, assuming the voltage scales linearly with the frequency.
+ */
+double PowerBudget::estimatePower(double measuredPower, int measuredFrequency, int frequency) const {
+	double dynamicPower = max(measuredPower - staticPower, 0.0);
+	double scale = (double)frequency / measuredFrequency;
+	return staticPower + dynamicPower * scale * scale * scale;
+}
+
+std::vector<int> PowerBudget::enforce(const std::vector<int> &oldFrequencies, const std::vector<int> &requestedFrequencies, const std::vector<bool> &activeCores) {
+	int numberOfActiveCores = 0;
+	vector<double> measuredPower(numberOfCores);
+	vector<double> throughputPerMHz(numberOfCores);
+	for (unsigned int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
+		if (activeCores.at(coreCounter)) {
+			numberOfActiveCores++;
+		}
+		measuredPower[coreCounter] = performanceCounters->getPowerOfCore(coreCounter);
+		throughputPerMHz[coreCounter] = activeCores.at(coreCounter) ? performanceCounters->getIPSOfCore(coreCounter) / oldFrequencies.at(coreCounter) : 0;
+	}
+	double budget = getBudget(numberOfActiveCores);
+
+	// without a power measurement of every core (-1: power not tracked, or no thermal interval yet),
+	// the estimate would be meaningless, so leave the requested frequencies alone
+	if (*min_element(measuredPower.begin(), measuredPower.end()) < 0) {
+		LOG_PRINT_WARNING_ONCE("Power budget enabled, but the power of the cores is not available. Track the total power (tp) of every core to enforce it.");
+		cout << "[Scheduler][power-budget]: budget=" << fixed << setprecision(3) << budget << " W  core power not available, not enforced" << endl;
+		return requestedFrequencies;
+	}
+
+	// start from the minimum frequency (or the requested one, if lower) on the active cores,
+	// inactive cores are left at the requested frequency
+	vector<int> frequencies(numberOfCores);
+	double totalPower = 0;
+	for (unsigned int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
+		if (!activeCores.at(coreCounter)) {
+			frequencies[coreCounter] = requestedFrequencies.at(coreCounter);
+			if (!useTSP) {
+				totalPower += estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), frequencies[coreCounter]);
+			}
+			continue;
+		}
+		frequencies[coreCounter] = min(minFrequency, requestedFrequencies.at(coreCounter));
+		totalPower += estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), frequencies[coreCounter]);
+	}
+
+	// greedily raise the frequency of the core with the highest marginal throughput per watt
+	typedef pair<double, int> candidate;  // (throughput per watt of the next step, core)
+	priority_queue<candidate> candidates;
+	auto nextStep = [&](int coreCounter) {
+		int frequency = frequencies[coreCounter];
+		int nextFrequency = min(frequency + frequencyStepSize, requestedFrequencies.at(coreCounter));
+		if (nextFrequency <= frequency) {
+			return;
+		}
+		double deltaPower = estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), nextFrequency)
+		                  - estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), frequency);
+		double deltaThroughput = throughputPerMHz[coreCounter] * (nextFrequency - frequency);
+		candidates.push(candidate(deltaThroughput / max(deltaPower, 1e-9), coreCounter));
+	};
+	for (unsigned int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
+		if (activeCores.at(coreCounter)) {
+			nextStep(coreCounter);
+		}
+	}
+
+	bool capped = false;
+	while (!candidates.empty()) {
+		int coreCounter = candidates.top().second;
+		candidates.pop();
+		int frequency = frequencies[coreCounter];
+		int nextFrequency = min(frequency + frequencyStepSize, requestedFrequencies.at(coreCounter));
+		double deltaPower = estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), nextFrequency)
+		                  - estimatePower(measuredPower[coreCounter], oldFrequencies.at(coreCounter), frequency);
+		if (totalPower + deltaPower > budget) {
+			capped = true;
+			continue;
+		}
+		totalPower += deltaPower;
+		frequencies[coreCounter] = nextFrequency;
+		nextStep(coreCounter);
+	}
+
+	if (capped) {
+		cappedEpochs++;
+	}
+	cout << "[Scheduler][power-budget]: budget=" << fixed << setprecision(3) << budget << " W  estimated power=" << totalPower << " W" << (capped ? "  (capped)" : "") << endl;
+
+	return frequencies;
+}
@@ -0,0 +1,51 @@
+/**
+ * power_budget
+ * This header implements the power budget enforcement of the open scheduler.
+ * The budget is either a fixed Thermal Design Power (TDP) or a Thermal Safe Power (TSP) that depends on
+ * the number of active cores. The TSP table is computed from the steady-state thermal resistance matrix of
+ * the cores (the temperature rise of core i per watt dissipated in core j, derived from the floorplan and the
+ * HotSpot RC model) as the worst-case uniform per-core power that keeps every core below the critical
+ * temperature for any set of m active cores.
+ * Each DVFS epoch, the frequencies requested by the DVFS policy for the active cores are redistributed
+ * greedily by marginal throughput per watt so that the estimated power stays within the budget. Inactive
+ * cores keep the requested frequency. Their power counts against the TDP, but not against the TSP, which
+ * is a budget for the active cores only (the inactive power is already part of its derivation).
+ */
+
+#ifndef __POWER_BUDGET_H
+#define __POWER_BUDGET_H
+
+#include "fixed_types.h"
+#include "performance_counters.h"
+
+#include <vector>
+
+class PowerBudget {
+public:
+	PowerBudget(const PerformanceCounters *performanceCounters, int numberOfCores, int minFrequency, int maxFrequency, int frequencyStepSize);
+
+	// Limit the requested frequencies of the active cores so that the estimated power stays within the budget.
+	std::vector<int> enforce(const std::vector<int> &oldFrequencies, const std::vector<int> &requestedFrequencies, const std::vector<bool> &activeCores);
+
+	// Power budget (W) for the given number of active cores: of all cores (TDP) or of the active cores (TSP).
+	double getBudget(int activeCores) const;
+
+private:
+	const PerformanceCounters *performanceCounters;
+	unsigned int numberOfCores;
+	int minFrequency;
+	int maxFrequency;
+	int frequencyStepSize;
+
+	bool useTSP;
+	double tdp;
+	double staticPower;  // frequency-independent part of the core power (W)
+	std::vector<double> tspTable;  // per-core TSP (W), indexed by the number of active cores
+
+	UInt64 cappedEpochs;
+
+	void computeTSPTable(String thermalResistanceFileName, double criticalTemperature, double ambientTemperature, double inactivePower);
+	double estimatePower(double measuredPower, int measuredFrequency, int frequency) const;
+};
+
+#endif
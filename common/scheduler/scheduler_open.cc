@@ -15,12 +15,15 @@
 
 #include "policies/dvfsConstFreq.h"
 #include "policies/dvfsOndemand.h"
+#include "policies/dvfsQoS.h"
 #include "policies/mapFirstUnused.h"
 
 #include "policies/dramLowpower.h"
 
+#include <fstream>
 #include <iomanip>
 #include <random>
+#include <sstream>
 
 using namespace std;
 
@@ -30,6 +33,7 @@ using namespace std;
 */
 SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
    : SchedulerPinnedBase(thread_manager, SubsecondTime::NS(Sim()->getCfg()->getInt("scheduler/pinned/quantum")))
+   , openTasks(OpenTaskQueue::parseQueuePolicy(Sim()->getCfg()->getString("scheduler/open/queuePolicy")))
    , m_interleaving(Sim()->getCfg()->getInt("scheduler/pinned/interleaving"))
    , m_next_core(0) {
 
@@ -48,7 +52,6 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
   	}
 
 	mappingEpoch = atol (Sim()->getCfg()->getString("scheduler/open/epoch").c_str());
-	queuePolicy = Sim()->getCfg()->getString("scheduler/open/queuePolicy").c_str();
 	distribution = Sim()->getCfg()->getString("scheduler/open/distribution").c_str();
 	arrivalRate = atoi (Sim()->getCfg()->getString("scheduler/open/arrivalRate").c_str());
 	arrivalInterval = atoi (Sim()->getCfg()->getString("scheduler/open/arrivalInterval").c_str());
@@ -69,6 +72,8 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 		Sim()->getCfg()->getString("hotspot/log_files/combined_insttemperature_trace_file").c_str(),
 		"InstantaneousCPIStack.log");
 
+	policyOverhead = new PolicyOverhead();
+
 	//Initialize the cores in the system.
 	for (int coreIterator=0; coreIterator < numberOfCores; coreIterator++) {
 		systemCores.push_back (coreIterator);
@@ -79,7 +84,7 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 	String benchmarksDelimiter = "+";
 	for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
 		String taskName = benchmarks.substr(0, benchmarks.find(benchmarksDelimiter));
-		openTasks.push_back (openTask (taskIterator, taskName, coreRequirementTranslation(taskName)));
+		openTasks.addTask (openTask (taskIterator, taskName, coreRequirementTranslation(taskName)));
 		benchmarks.erase(0, benchmarks.find(benchmarksDelimiter) + benchmarksDelimiter.length());
 	}
 
@@ -120,15 +125,81 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << time << +" ns" << endl;
 			openTasks[taskIterator].taskArrivalTime = time;
 		}
+	} else if (distribution == "trace") {
+		loadArrivalTrace(Sim()->getCfg()->getString("scheduler/open/arrivalTrace"));
 	} else {
 		cout << "\n[Scheduler] [Error]: Unknown Workload Arrival Distribution: '" << distribution << "'" << endl;
  		exit (1);
 	}
 
+	taskProgress = new TaskProgress(numberOfTasks, numberOfCores, Sim()->getCfg()->getString("scheduler/open/qos/baseline_file"));
+
 	initMappingPolicy(Sim()->getCfg()->getString("scheduler/open/logic").c_str());
 	initDVFSPolicy(Sim()->getCfg()->getString("scheduler/open/dvfs/logic").c_str());
+	if (Sim()->getCfg()->getBool("scheduler/open/power_budget/enabled")) {
+		if (dvfsPolicy == NULL) {
+			cout << "\n[Scheduler] [Error]: The power budget requires a DVFS policy" << endl;
+			exit (1);
+		}
+		powerBudget = new PowerBudget(performanceCounters, numberOfCores, minFrequency, maxFrequency, frequencyStepSize);
+	}
 	initMigrationPolicy(Sim()->getCfg()->getString("scheduler/open/migration/logic").c_str());
 	initDramPolicy(Sim()->getCfg()->getString("scheduler/open/dram/dtm").c_str());
+
+	printMapping = Sim()->getCfg()->getBool("scheduler/open/print_mapping");
+	printMappingInterval = Sim()->getCfg()->getInt("scheduler/open/print_mapping_interval");
+	lastMappingPrint = UINT64_MAX;
+
+	// Register the deadlines of all periodic work. Policies that are off never get a timer.
+	timers.addPeriodic(TIMER_CONSISTENCY_CHECK, Sim()->getCfg()->getInt("scheduler/open/consistency_check_interval"));
+	if (migrationPolicy != NULL) timers.addPeriodic(TIMER_MIGRATION, migrationEpoch);
+	if (dvfsPolicy != NULL) timers.addPeriodic(TIMER_DVFS, dvfsEpoch);
+	if (dramPolicy != NULL) timers.addPeriodic(TIMER_DRAM, dramEpoch);
+	timers.addPeriodic(TIMER_MAPPING, mappingEpoch);
+}
+
+/** loadArrivalTrace
+ * Read the arrival time, priority and relative deadline of every task from a trace file.
+ * Each non-empty line that does not start with '#' describes the next task: "<arrival ns> [<priority> [<deadline ns>]]".
+ */
+void SchedulerOpen::loadArrivalTrace(String fileName) {
+	ifstream traceFile(fileName.c_str());
+	if (!traceFile.good()) {
+		cout << "\n[Scheduler] [Error]: Cannot open arrival trace '" << fileName << "'" << endl;
+		exit (1);
+	}
+
+	int taskIterator = 0;
+	string line;
+	while (taskIterator < numberOfTasks && getline(traceFile, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		istringstream iss(line);
+		// Parse signed so that negative times are caught instead of wrapping around
+		SInt64 arrivalTime;
+		if (!(iss >> arrivalTime)) {
+			cout << "\n[Scheduler] [Error]: Invalid line in arrival trace: '" << line << "'" << endl;
+			exit (1);
+		}
+		int priority = 0;
+		SInt64 deadline = 0;
+		iss >> priority >> deadline;
+		if (arrivalTime < 0 || deadline < 0) {
+			LOG_PRINT_ERROR("Negative arrival time or deadline in arrival trace '%s': '%s'", fileName.c_str(), line.c_str());
+		}
+
+		openTasks[taskIterator].taskArrivalTime = arrivalTime;
+		openTasks[taskIterator].taskPriority = priority;
+		openTasks[taskIterator].taskDeadline = deadline;
+		taskIterator++;
+	}
+
+	if (taskIterator < numberOfTasks) {
+		cout << "\n[Scheduler] [Error]: Arrival trace '" << fileName << "' only has " << taskIterator << " of " << numberOfTasks << " tasks" << endl;
+		exit (1);
+	}
+	cout << "[Scheduler]: Loaded arrival times of " << numberOfTasks << " tasks from '" << fileName << "'" << endl;
 }
 
 /** initMappingPolicy
@@ -181,6 +252,19 @@ void SchedulerOpen::initDVFSPolicy(String policyName) {
 			dtmCriticalTemperature,
 			dtmRecoveredTemperature
 		);
+	} else if (policyName == "qos") {
+		float boostSlowdown = Sim()->getCfg()->getFloat("scheduler/open/dvfs/qos/boost_slowdown");
+		float relaxSlowdown = Sim()->getCfg()->getFloat("scheduler/open/dvfs/qos/relax_slowdown");
+		dvfsPolicy = new DVFSQoS(
+			performanceCounters,
+			taskProgress,
+			numberOfCores,
+			minFrequency,
+			maxFrequency,
+			frequencyStepSize,
+			boostSlowdown,
+			relaxSlowdown
+		);
 	} //else if (policyName ="XYZ") {... } //Place to instantiate a new DVFS logic. Implementation is put in "policies" package.
 	else {
 		cout << "\n[Scheduler] [Error]: Unknown DVFS Algorithm" << endl;
@@ -203,27 +287,10 @@ void SchedulerOpen::initMigrationPolicy(String policyName) {
 }
 
 /** taskFrontOfQueue
-    Returns the ID of the task in front of queue. Place to implement a new queuing policy.
+    Returns the ID of the task in front of queue according to the queuing policy, or -1 if the queue is empty.
 */
 int SchedulerOpen::taskFrontOfQueue () {
-	int IDofTaskInFrontOfQueue = -1;
-
-	if (queuePolicy == "FIFO") {
-		for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-			if (openTasks [taskIterator].waitingInQueue) {
-				IDofTaskInFrontOfQueue = taskIterator;
-				break;
-			}
-		}
-	}
-	//else if (queuePolicy ="XYZ") {... } //Place to implement a new queuing policy.
-	else {
-	
-		cout<<"\n[Scheduler] [Error]: Unknown Queuing Policy"<< endl;
- 		exit (1);
-	}
-
-	return IDofTaskInFrontOfQueue;
+	return openTasks.front();
 }
 
 
@@ -245,68 +312,35 @@ int SchedulerOpen::numberOfFreeCores () {
     Returns the number of tasks in the queue.
 */
 int SchedulerOpen::numberOfTasksInQueue () {
-	int tasksInQueue = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].waitingInQueue == true) 
-			tasksInQueue++;
-	
-	return tasksInQueue;
+	return openTasks.count(TASK_WAITING_IN_QUEUE);
 }
 
 /** numberOfTasksWaitingToSchedule
     Returns the number of tasks not yet entered into the queue.
 */
 int SchedulerOpen::numberOfTasksWaitingToSchedule () {
-	int tasksWaitingToSchedule = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].waitingToSchedule == true) 
-			tasksWaitingToSchedule++;
-
-	
-	return tasksWaitingToSchedule;
+	return openTasks.count(TASK_WAITING_TO_SCHEDULE);
 }
 
 /** numberOfTasksCompleted
     Returns the number of tasks completed.
 */
 int SchedulerOpen::numberOfTasksCompleted () {
-	int tasksCompleted = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].completed == true) 
-			tasksCompleted++;
-
-	
-	return tasksCompleted;
+	return openTasks.count(TASK_COMPLETED);
 }
 
 /** numberOfActiveTasks
     Returns the number of active tasks.
 */
 int SchedulerOpen::numberOfActiveTasks () {
-	int activeTasks = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].active == true) 
-			activeTasks++;
-
-	
-	return activeTasks;
+	return openTasks.count(TASK_ACTIVE);
 }
 
 /** numberOfActiveTasks
     Returns the number of core required by all active tasks.
 */
 int SchedulerOpen::totalCoreRequirementsOfActiveTasks () {
-	int coreRequirement = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].active == true) 
-			coreRequirement += openTasks[taskCounter].taskCoreRequirement;
-
-	return coreRequirement;
+	return openTasks.totalCoreRequirementsOfActiveTasks();
 }
 
 /** threadSetAffinity
@@ -478,7 +512,9 @@ bool SchedulerOpen::executeMappingPolicy(int taskID, SubsecondTime time) {
 		activeCores.at(i) = isAssignedToTask(i);
 	}
 	// get the cores
-	vector<int> bestCores = mappingPolicy->map(openTasks[taskID].taskName, openTasks[taskID].taskCoreRequirement, availableCores, activeCores);
+	policyOverhead->begin();
+	vector<int> bestCores = mappingPolicy->map(openTasks[taskID].taskName, openTasks[taskID].taskCoreRequirement, availableCores, activeCores, taskProgress);
+	policyOverhead->end(PolicyOverhead::MAPPING);
 	if ((int)bestCores.size() < openTasks[taskID].taskCoreRequirement) {
 		cout << "[Scheduler]: Policy returned too few cores, mapping failed." << endl;
 		return false;
@@ -506,8 +542,7 @@ bool SchedulerOpen::schedule (int taskID, bool isInitialCall, SubsecondTime time
 		return false; //Task not ready for mapping.
 	} else {
 		cout <<"\n[Scheduler]: Task " << taskID << " put into execution queue. \n";
-		openTasks [taskID].waitingInQueue = true;
-		openTasks [taskID].waitingToSchedule = false;
+		openTasks.setState(taskID, TASK_WAITING_IN_QUEUE);
 	}
 
 	if (taskFrontOfQueue () != taskID) {
@@ -529,9 +564,8 @@ bool SchedulerOpen::schedule (int taskID, bool isInitialCall, SubsecondTime time
 		if (!isInitialCall) 
 			cout << "\n[Scheduler]: Waking Task " << taskID << " at core " << setAffinity (taskID) << endl;
 		openTasks [taskID].taskStartTime = time.getNS();
-		openTasks [taskID].active = true;
-		openTasks [taskID].waitingInQueue = false;
-		openTasks [taskID].waitingToSchedule = false;
+		openTasks.setState(taskID, TASK_ACTIVE);
+		taskProgress->taskStarted(taskID, openTasks[taskID].taskName, openTasks[taskID].taskArrivalTime, openTasks[taskID].taskStartTime, openTasks[taskID].taskDeadline);
 	} 
 
 	return mappingSuccesfull;
@@ -548,6 +582,8 @@ core_id_t SchedulerOpen::threadCreate(thread_id_t thread_id) {
 
 	cout << "\n[Scheduler]: Trying to map Thread  " << thread_id << " from Task " << app_id << " at Time " << formatTime(time) << endl;
 
+	taskProgress->threadCreated(app_id, thread_id);
+
 	//thead_id 0 to numberOfTasks are first threads of tasks, which are all created together when the system starts.
 	if (thread_id == 0) 
 	{
@@ -602,12 +638,9 @@ core_id_t SchedulerOpen::threadCreate(thread_id_t thread_id) {
     This function pulls tasks into the openSystem Queue.
 */
 void SchedulerOpen::fetchTasksIntoQueue (SubsecondTime time) {
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) {
-		if (openTasks [taskCounter].waitingToSchedule && openTasks [taskCounter].taskArrivalTime <= time.getNS ()) {
-			cout <<"\n[Scheduler]: Task " << taskCounter << " put into execution queue. \n";
-			openTasks [taskCounter].waitingInQueue = true;
-			openTasks [taskCounter].waitingToSchedule = false;
-		}
+	int taskID;
+	while ((taskID = openTasks.fetchArrivedTask(time.getNS())) != -1) {
+		cout <<"\n[Scheduler]: Task " << taskID << " put into execution queue. \n";
 	}
 }
 
@@ -647,8 +680,8 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 		}
 
 		openTasks[app_id].taskDepartureTime = time.getNS();
-		openTasks[app_id].completed = true;
-		openTasks[app_id].active = false;
+		openTasks.setState(app_id, TASK_COMPLETED);
+		taskProgress->taskCompleted(app_id, time.getNS());
 
 		cout << "\n[Scheduler][Result]: Task " << app_id << " (Response/Service/Wait) Time (ns) "  << " :\t" <<  time.getNS() - openTasks[app_id].taskArrivalTime << "\t" <<  time.getNS() - openTasks[app_id].taskStartTime << "\t" << openTasks[app_id].taskStartTime - openTasks[app_id].taskArrivalTime << "\n";
 	}
@@ -662,34 +695,17 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 		}
 		else if (numberOfTasksWaitingToSchedule () != 0) {
 
-			UInt64 timeJump = 0;
-
-			UInt64 nextArrivalTime = 0;
-			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-				if (openTasks[taskIterator].waitingToSchedule) {
-					if (nextArrivalTime == 0) { 
-						nextArrivalTime = openTasks[taskIterator].taskArrivalTime;
-					}
-					else if (nextArrivalTime > openTasks[taskIterator].taskArrivalTime) {
-						nextArrivalTime = openTasks[taskIterator].taskArrivalTime;
-					}
-				}
-
-			}
+			UInt64 nextArrivalTime = openTasks.nextArrivalTime();
 
-			if (nextArrivalTime == 0) {
-				cout << "\n[Scheduler]: INTERNAL ERROR: nextArrivalTime == 0";
+			if (nextArrivalTime == UINT64_MAX) {
+				cout << "\n[Scheduler]: INTERNAL ERROR: no pending arrival";
 				exit(1);
 			}
 
-			timeJump = nextArrivalTime - time.getNS();
-			cout << "\n[Scheduler]: Readjusting Arrival Time by " << timeJump << " ns \n"; // This will not effect the result of response time as arrival time of all unscheduled tasks are adjusted relatively.
-
-			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-				if (openTasks[taskIterator].waitingToSchedule) {
-					openTasks[taskIterator].taskArrivalTime -= timeJump;
-					cout << "\n[Scheduler]: New Arrival Time from Task " << taskIterator << " set at " << openTasks[taskIterator].taskArrivalTime << " ns" <<  "\n"; 
-				}
+			if (nextArrivalTime > time.getNS()) {
+				UInt64 timeJump = nextArrivalTime - time.getNS();
+				cout << "\n[Scheduler]: Readjusting Arrival Time by " << timeJump << " ns \n"; // This will not effect the result of response time as arrival time of all unscheduled tasks are adjusted relatively.
+				openTasks.advancePendingArrivals(timeJump);
 			}
 
 			fetchTasksIntoQueue (time);
@@ -711,7 +727,8 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 		}
 
 
-		cout << "\n[Scheduler][Result]: Average Response Time (ns) " << " :\t" <<  averageResponseTime/numberOfTasks << "\n\n";
+		cout << "\n[Scheduler][Result]: Average Response Time (ns) " << " :\t" <<  averageResponseTime/numberOfTasks << "\n";
+		cout << "\n[Scheduler][Result]: p95/p99 Response Time (ns) " << " :\t" << taskProgress->getResponseTimePercentile(95) << "\t" << taskProgress->getResponseTimePercentile(99) << "\n\n";
 
 	}
 
@@ -884,17 +901,35 @@ void SchedulerOpen::setFrequency(int coreCounter, int frequency) {
 }
 
 
+/** updateTaskProgress
+ * Update the progress of all running tasks, so that policies see the current state.
+ */
+void SchedulerOpen::updateTaskProgress(SubsecondTime time) {
+	std::vector<int> taskOfCore;
+	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
+		taskOfCore.push_back(systemCores[coreCounter].assignedTaskID);
+	}
+	taskProgress->update(time, taskOfCore);
+}
+
 /** executeDVFSPolicy
  * Set DVFS levels according to the used policy.
  */
-void SchedulerOpen::executeDVFSPolicy() {
+void SchedulerOpen::executeDVFSPolicy(SubsecondTime time) {
+	updateTaskProgress(time);
+
 	std::vector<int> oldFrequencies;
 	std::vector<bool> activeCores;
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
 		oldFrequencies.push_back(Sim()->getMagicServer()->getFrequency(coreCounter));
 		activeCores.push_back(isAssignedToThread(coreCounter));
 	}
+	policyOverhead->begin();
 	vector<int> frequencies = dvfsPolicy->getFrequencies(oldFrequencies, activeCores);
+	policyOverhead->end(PolicyOverhead::DVFS);
+	if (powerBudget != NULL) {
+		frequencies = powerBudget->enforce(oldFrequencies, frequencies, activeCores);
+	}
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
 		setFrequency(coreCounter, frequencies.at(coreCounter));
 	}
@@ -932,7 +967,9 @@ void SchedulerOpen::executeDramPolicy()
 		old_bank_modes[i] = Sim()->m_bank_modes[i];
 	}
 
+	policyOverhead->begin();
 	std::map<int,int> new_bank_modes = dramPolicy->getNewBankModes(old_bank_modes);
+	policyOverhead->end(PolicyOverhead::DRAM);
 
     for (int i = 0; i < numberOfBanks; i++)
 	{
@@ -949,6 +986,8 @@ void SchedulerOpen::setMemBankMode(int bankNr, int mode)
  * Perform migration according to the used policy.
  */
 void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
+	updateTaskProgress(time);
+
 	std::vector<int> taskIds;
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
 		taskIds.push_back(systemCores.at(coreCounter).assignedTaskID);
@@ -958,7 +997,9 @@ void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 		static bool reserved_cores_are_active = Sim()->getCfg()->getBool("scheduler/open/dvfs/reserved_cores_are_active");
 		activeCores.push_back(reserved_cores_are_active ? isAssignedToTask(coreCounter) : isAssignedToThread(coreCounter));
 	}
+	policyOverhead->begin();
 	std::vector<migration> migrations = migrationPolicy->migrate(time, taskIds, activeCores);
+	policyOverhead->end(PolicyOverhead::MIGRATION);
 
 	for (migration &migration : migrations) {
 		if (systemCores.at(migration.fromCore).assignedTaskID == -1) {
@@ -1011,95 +1052,120 @@ void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 }
 
 
-/** periodic
-    This function is called periodically by Sniper at Interval of 100ns.
-*/
-void SchedulerOpen::periodic(SubsecondTime time) {
-	if (time.getNS () % 1000000 == 0) { //Error Checking at every 1ms. Can be faster but will have overhead in simulation time.
-		cout << "\n[Scheduler]: Time " << formatTime(time) << " [Active Tasks =  " << numberOfActiveTasks () << " | Completed Tasks = " <<  numberOfTasksCompleted () << " | Queued Tasks = "  << numberOfTasksInQueue () << " | Non-Queued Tasks  = " <<  numberOfTasksWaitingToSchedule () <<  " | Free Cores = " << numberOfFreeCores () << " | Active Tasks Requirements = " << totalCoreRequirementsOfActiveTasks () << " ] \n" << endl;
-
-		//Following error checking code makes sure that the system state is not messed up.
-
-		if (numberOfCores - totalCoreRequirementsOfActiveTasks () != numberOfFreeCores ()) {
-			cout <<"\n[Scheduler] [Error]: Number of Free Cores + Number of Active Tasks Requirements != Number Of Cores.\n";		
-			exit (1);
-		}
+/** printCoreMapping
+ * Print the current assignment of tasks to cores.
+ */
+void SchedulerOpen::printCoreMapping() {
+	cout << "[Scheduler]: Current mapping:" << endl;
 
-		if (numberOfActiveTasks () + numberOfTasksCompleted () + numberOfTasksInQueue () + numberOfTasksWaitingToSchedule () != numberOfTasks) {
-			cout <<"\n[Scheduler] [Error]: Task State Does Not Match.\n";		
-			exit (1);
+	for (int z = 0; z < coresInZ; z++) {
+		if (coresInZ > 1) {
+			cout << "Core layer " << z << ":" << endl;
 		}
-	}
+		for (int y = 0; y < coresInY; y++) {
+			for (int x = 0; x < coresInX; x++) {
+				if (x > 0) {
+					cout << " ";
+				}
+				int coreId = getCoreNb(x, y, z);
+				if (!isAssignedToTask(coreId)) {
+					cout << "  . ";
+				} else {
+					if (systemCores[coreId].assignedTaskID < 10) {
+						cout << " ";
+					}
 
-	if ((migrationPolicy != NULL) && (time.getNS() % migrationEpoch == 0)) {
-		cout << "\n[Scheduler]: Migration invoked at " << formatTime(time) << endl;
+					char marker1 = '?';
+					char marker2 = '?';
+					if (isAssignedToThread(coreId)) {
+						Core::State state = m_thread_manager->getThreadState(systemCores[coreId].assignedThreadID);
+						if (state == Core::State::RUNNING) {
+							marker1 = '*';
+							marker2 = '*';
+						} else {
+							marker1 = '-';
+							marker2 = '-';
+						}
+					} else {
+						marker1 = '(';
+						marker2 = ')';
+					}
 
-		executeMigrationPolicy(time);
+					cout << marker1 << systemCores[coreId].assignedTaskID << marker2;
+				}
+			}
+			cout << endl;
+		}
 	}
+}
 
-	if ((dvfsPolicy != NULL) && (time.getNS() % dvfsEpoch == 0)) {
-		cout << "\n[Scheduler]: DVFS Control Loop invoked at " << formatTime(time) << endl;
+/** checkConsistency
+ * Print the task state summary and make sure that the system state is not messed up.
+ */
+void SchedulerOpen::checkConsistency(SubsecondTime time) {
+	cout << "\n[Scheduler]: Time " << formatTime(time) << " [Active Tasks =  " << numberOfActiveTasks () << " | Completed Tasks = " <<  numberOfTasksCompleted () << " | Queued Tasks = "  << numberOfTasksInQueue () << " | Non-Queued Tasks  = " <<  numberOfTasksWaitingToSchedule () <<  " | Free Cores = " << numberOfFreeCores () << " | Active Tasks Requirements = " << totalCoreRequirementsOfActiveTasks () << " ] \n" << endl;
 
-		executeDVFSPolicy();
+	if (numberOfCores - totalCoreRequirementsOfActiveTasks () != numberOfFreeCores ()) {
+		cout <<"\n[Scheduler] [Error]: Number of Free Cores + Number of Active Tasks Requirements != Number Of Cores.\n";		
+		exit (1);
 	}
 
-	if ((dramPolicy != NULL) && (time.getNS() % dramEpoch == 0)) {
-		cout << "\n[Scheduler]: Dram Control Loop invoked at " << formatTime(time) << endl;
-
-		executeDramPolicy();
+	if (numberOfActiveTasks () + numberOfTasksCompleted () + numberOfTasksInQueue () + numberOfTasksWaitingToSchedule () != numberOfTasks) {
+		cout <<"\n[Scheduler] [Error]: Task State Does Not Match.\n";		
+		exit (1);
 	}
+}
 
-	if (time.getNS () % mappingEpoch == 0) {
-		
-		cout << "\n[Scheduler]: Scheduler Invoked at " << formatTime(time) << "\n" << endl;
-
-		fetchTasksIntoQueue (time);
-				
-
-
-		while (	numberOfTasksInQueue () != 0) {	
-			if (!schedule (taskFrontOfQueue (), false,time)) break; //Scheduler can't map the task in front of queue.
-		}
+/** executeMapping
+ * Pull arrived tasks into the queue and map as many of them as possible.
+ */
+void SchedulerOpen::executeMapping(SubsecondTime time) {
+	cout << "\n[Scheduler]: Scheduler Invoked at " << formatTime(time) << "\n" << endl;
 
-		cout << "[Scheduler]: Current mapping:" << endl;
+	fetchTasksIntoQueue (time);
+	updateTaskProgress(time);
 
-		for (int z = 0; z < coresInZ; z++) {
-			if (coresInZ > 1) {
-				cout << "Core layer " << z << ":" << endl;
-			}
-			for (int y = 0; y < coresInY; y++) {
-				for (int x = 0; x < coresInX; x++) {
-					if (x > 0) {
-						cout << " ";
-					}
-					int coreId = getCoreNb(x, y, z);
-					if (!isAssignedToTask(coreId)) {
-						cout << "  . ";
-					} else {
-						if (systemCores[coreId].assignedTaskID < 10) {
-							cout << " ";
-						}
+	while (	numberOfTasksInQueue () != 0) {	
+		if (!schedule (taskFrontOfQueue (), false,time)) break; //Scheduler can't map the task in front of queue.
+	}
 
-						char marker1 = '?';
-						char marker2 = '?';
-						if (isAssignedToThread(coreId)) {
-							Core::State state = m_thread_manager->getThreadState(systemCores[coreId].assignedThreadID);
-							if (state == Core::State::RUNNING) {
-								marker1 = '*';
-								marker2 = '*';
-							} else {
-								marker1 = '-';
-								marker2 = '-';
-							}
-						} else {
-							marker1 = '(';
-							marker2 = ')';
-						}
+	// The core map is printed at most once per printMappingInterval to keep the console output bounded.
+	if (printMapping && (lastMappingPrint == UINT64_MAX || time.getNS() >= lastMappingPrint + printMappingInterval)) {
+		printCoreMapping();
+		lastMappingPrint = time.getNS();
+	}
+}
 
-						cout << marker1 << systemCores[coreId].assignedTaskID << marker2;
-					}
-				}
-				cout << endl;
+/** periodic
+    This function is called periodically by Sniper at Interval of 100ns.
+    All periodic work is driven by the timer queue: between two deadlines, only the quantum accounting is done.
+*/
+void SchedulerOpen::periodic(SubsecondTime time) {
+	if (time.getNS() >= timers.nextDeadline()) {
+		int timerID;
+		while (timers.popDue(time.getNS(), timerID)) {
+			switch (timerID) {
+				case TIMER_CONSISTENCY_CHECK:
+					checkConsistency(time);
+					break;
+				case TIMER_MIGRATION:
+					cout << "\n[Scheduler]: Migration invoked at " << formatTime(time) << endl;
+					executeMigrationPolicy(time);
+					break;
+				case TIMER_DVFS:
+					cout << "\n[Scheduler]: DVFS Control Loop invoked at " << formatTime(time) << endl;
+					executeDVFSPolicy(time);
+					break;
+				case TIMER_DRAM:
+					cout << "\n[Scheduler]: Dram Control Loop invoked at " << formatTime(time) << endl;
+					executeDramPolicy();
+					break;
+				case TIMER_MAPPING:
+					executeMapping(time);
+					break;
+				default:
+					cout << "\n[Scheduler] [Error]: Unknown timer " << timerID << endl;
+					exit (1);
 			}
 		}
 	}
@@ -11,6 +11,11 @@
 
 #include "scheduler_pinned_base.h"
 #include "performance_counters.h"
+#include "timer_queue.h"
+#include "open_task_queue.h"
+#include "policy_overhead.h"
+#include "task_progress.h"
+#include "power_budget.h"
 #include "policies/dvfspolicy.h"
 #include "policies/mappingpolicy.h"
 #include "policies/migrationpolicy.h"
@@ -18,23 +23,6 @@
 #include "policies/drampolicy.h"
 
 
-//This data structure maintains the state of the tasks.
-struct openTask {
-	openTask(int taskIDInput, String taskNameInput, int taskCoreRequirement)
-	: taskID(taskIDInput), taskName(taskNameInput), taskCoreRequirement(taskCoreRequirement) {}
-
-	int taskID;
-	String taskName;
-	bool waitingToSchedule = true;
-	bool waitingInQueue = false;
-	bool active = false;
-	bool completed = false;
-	int taskCoreRequirement;
-	UInt64 taskArrivalTime;
-	UInt64 taskStartTime;
-	UInt64 taskDepartureTime;
-};
-
 //This data structure maintains the state of the cores.
 struct systemCore {
 	systemCore(int coreIDInput) : coreID(coreIDInput) {}
@@ -44,6 +32,15 @@ struct systemCore {
 	int assignedThreadID = -1;// -1 means core assigned to no thread.
 };
 
+//Periodic activities of the open scheduler, in the order in which they run when due at the same time.
+enum schedulerTimer {
+	TIMER_CONSISTENCY_CHECK,
+	TIMER_MIGRATION,
+	TIMER_DVFS,
+	TIMER_DRAM,
+	TIMER_MAPPING,
+};
+
 class SchedulerOpen : public SchedulerPinnedBase {
 
 	public:
@@ -65,16 +62,27 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		int banksInZ;
 
 		PerformanceCounters *performanceCounters;
+		PolicyOverhead *policyOverhead;
+		TaskProgress *taskProgress;
+		void updateTaskProgress(SubsecondTime time);
+
+		// periodic work
+		TimerQueue timers;
+		void checkConsistency(SubsecondTime time);
+		bool printMapping;
+		UInt64 printMappingInterval;
+		UInt64 lastMappingPrint;
+		void printCoreMapping();
 
 		// scheduling
-		std::vector <openTask> openTasks;
+		OpenTaskQueue openTasks;
 		std::vector <systemCore> systemCores;
-		String queuePolicy;
 		String distribution;
 		int arrivalRate;
 		int arrivalInterval;
 
 		void fetchTasksIntoQueue (SubsecondTime time);
+		void loadArrivalTrace(String fileName);
 		int coreRequirementTranslation(String compositionString);
 		int taskFrontOfQueue();
 		int numberOfFreeCores();
@@ -88,6 +96,7 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		MappingPolicy *mappingPolicy = NULL;
 		long mappingEpoch;
 		void initMappingPolicy(String policyName);
+		void executeMapping(SubsecondTime time);
 		bool executeMappingPolicy(int taskID, SubsecondTime time);
 		int getCoreNb(int x, int y, int z);
 		bool isAssignedToTask(int coreId);
@@ -97,11 +106,12 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		DVFSPolicy *dvfsPolicy = NULL;
 		long dvfsEpoch;
 		void initDVFSPolicy(String policyName);
-		void executeDVFSPolicy();
+		void executeDVFSPolicy(SubsecondTime time);
 		void setFrequency(int coreCounter, int frequency);
 		int minFrequency;
 		int maxFrequency;
 		int frequencyStepSize;
+		PowerBudget *powerBudget = NULL;
 
 		// Dram
 		DramPolicy *dramPolicy = NULL;
@@ -0,0 +1,164 @@
+#include "task_progress.h"
+#include "simulator.h"
+#include "thread_stats_manager.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+TaskProgress::TaskProgress(int numberOfTasks, int numberOfCores, String baselineFileName)
+	: tasks(numberOfTasks), taskOfCore(numberOfCores, -1) {
+	if (baselineFileName != "") {
+		loadBaselines(baselineFileName);
+	}
+
+	Sim()->getStatsManager()->registerMetric(new StatsMetricCallback("scheduler", 0, "response-time-mean", statsCallback, (UInt64)this));
+	Sim()->getStatsManager()->registerMetric(new StatsMetricCallback("scheduler", 0, "response-time-p95", statsCallback, (UInt64)this));
+	Sim()->getStatsManager()->registerMetric(new StatsMetricCallback("scheduler", 0, "response-time-p99", statsCallback, (UInt64)this));
+}
+
+/** loadBaselines
+ * Read the isolated-run baselines. Each non-empty line that does not start with '#' has the form
+ * "<task name> <isolated runtime ns> <instructions>".
+ */
+void TaskProgress::loadBaselines(String fileName) {
+	ifstream baselineFile(fileName.c_str());
+	if (!baselineFile.good()) {
+		cout << "\n[Scheduler] [Error]: Cannot open task baseline file '" << fileName << "'" << endl;
+		exit (1);
+	}
+
+	string line;
+	while (getline(baselineFile, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		istringstream iss(line);
+		string taskName;
+		baseline b;
+		if (!(iss >> taskName >> b.runtime >> b.instructions) || b.runtime == 0 || b.instructions == 0) {
+			cout << "\n[Scheduler] [Error]: Invalid line in task baseline file: '" << line << "'" << endl;
+			exit (1);
+		}
+		baselines[taskName] = b;
+	}
+}
+
+UInt64 TaskProgress::statsCallback(String objectName, UInt32 index, String metricName, UInt64 arg) {
+	TaskProgress *self = (TaskProgress *)arg;
+	if (metricName == "response-time-p95") {
+		return self->getResponseTimePercentile(95);
+	} else if (metricName == "response-time-p99") {
+		return self->getResponseTimePercentile(99);
+	} else {
+		return self->getMeanResponseTime();
+	}
+}
+
+void TaskProgress::taskStarted(int taskID, String taskName, UInt64 arrivalTime, UInt64 startTime, UInt64 deadline) {
+	taskInfo &task = tasks.at(taskID);
+	task.taskName = taskName;
+	task.arrivalTime = arrivalTime;
+	task.startTime = startTime;
+	task.lastUpdate = startTime;
+	task.deadline = deadline;
+	task.running = true;
+
+	map<string, baseline>::const_iterator it = baselines.find(taskName.c_str());
+	task.isolated = (it == baselines.end()) ? NULL : &it->second;
+}
+
+void TaskProgress::threadCreated(int taskID, thread_id_t threadID) {
+	tasks.at(taskID).threads.push_back(threadID);
+}
+
+void TaskProgress::taskCompleted(int taskID, UInt64 departureTime) {
+	taskInfo &task = tasks.at(taskID);
+	task.running = false;
+	task.lastUpdate = departureTime;
+
+	// keep the response times sorted, percentiles are then a lookup
+	UInt64 responseTime = departureTime - task.arrivalTime;
+	responseTimes.insert(upper_bound(responseTimes.begin(), responseTimes.end(), responseTime), responseTime);
+}
+
+void TaskProgress::update(SubsecondTime time, const std::vector<int> &taskOfCore) {
+	this->taskOfCore = taskOfCore;
+
+	ThreadStatsManager *tsm = Sim()->getThreadStatsManager();
+	for (taskInfo &task : tasks) {
+		if (!task.running) {
+			continue;
+		}
+		task.instructions = 0;
+		for (thread_id_t threadID : task.threads) {
+			tsm->update(threadID, time);
+			task.instructions += tsm->getThreadStatistic(threadID, ThreadStatsManager::INSTRUCTIONS);
+		}
+		task.lastUpdate = time.getNS();
+	}
+}
+
+int TaskProgress::getTaskOfCore(int coreId) const {
+	return taskOfCore.at(coreId);
+}
+
+UInt64 TaskProgress::getInstructionsOfTask(int taskID) const {
+	return tasks.at(taskID).instructions;
+}
+
+double TaskProgress::getProgressOfTask(int taskID) const {
+	const taskInfo &task = tasks.at(taskID);
+	if (task.isolated == NULL) {
+		return -1;
+	}
+	return (double)task.instructions / task.isolated->instructions;
+}
+
+double TaskProgress::getSlowdownOfTask(int taskID) const {
+	const taskInfo &task = tasks.at(taskID);
+	if (task.isolated == NULL || task.instructions == 0) {
+		return -1;
+	}
+	double isolatedTime = (double)task.instructions * task.isolated->runtime / task.isolated->instructions;
+	return (task.lastUpdate - task.startTime) / isolatedTime;
+}
+
+double TaskProgress::getSlowdownOfCore(int coreId) const {
+	int taskID = getTaskOfCore(coreId);
+	return taskID == -1 ? -1 : getSlowdownOfTask(taskID);
+}
+
+bool TaskProgress::isBehindDeadline(int taskID) const {
+	const taskInfo &task = tasks.at(taskID);
+	double progress = getProgressOfTask(taskID);
+	if (task.deadline == 0 || progress < 0) {
+		return false;
+	}
+	return progress < (double)(task.lastUpdate - task.arrivalTime) / task.deadline;
+}
+
+UInt64 TaskProgress::getResponseTimePercentile(double percentile) const {
+	if (responseTimes.empty()) {
+		return 0;
+	}
+	// nearest-rank percentile
+	size_t rank = (size_t)ceil(percentile / 100 * responseTimes.size());
+	return responseTimes.at(max(rank, (size_t)1) - 1);
+}
+
+UInt64 TaskProgress::getMeanResponseTime() const {
+	if (responseTimes.empty()) {
+		return 0;
+	}
+	UInt64 sum = 0;
+	for (UInt64 responseTime : responseTimes) {
+		sum += responseTime;
+	}
+	return sum / responseTimes.size();
+}
@@ -0,0 +1,69 @@
+/**
+ * task_progress
+ * This header implements the per-task progress tracking of the open scheduler.
+ * The progress of a task is the number of instructions its threads retired. It is compared against an
+ * isolated-run baseline (runtime and instruction count of the task running alone) to obtain the slowdown
+ * of the task, and against its deadline to detect tasks that are falling behind.
+ * Policies get a const pointer to this class, in the same way as they get the PerformanceCounters.
+ */
+
+#ifndef __TASK_PROGRESS_H
+#define __TASK_PROGRESS_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class TaskProgress {
+public:
+	TaskProgress(int numberOfTasks, int numberOfCores, String baselineFileName);
+
+	// notifications from the scheduler
+	void taskStarted(int taskID, String taskName, UInt64 arrivalTime, UInt64 startTime, UInt64 deadline);
+	void threadCreated(int taskID, thread_id_t threadID);
+	void taskCompleted(int taskID, UInt64 departureTime);
+	void update(SubsecondTime time, const std::vector<int> &taskOfCore);
+
+	// queries for the policies; values refer to the last update
+	int getTaskOfCore(int coreId) const;
+	UInt64 getInstructionsOfTask(int taskID) const;
+	double getProgressOfTask(int taskID) const;  // fraction of the isolated-run instructions retired, -1 without baseline
+	double getSlowdownOfTask(int taskID) const;  // service time / isolated time for the retired instructions, -1 without baseline
+	double getSlowdownOfCore(int coreId) const;  // slowdown of the task on the core, -1 if unknown
+	bool isBehindDeadline(int taskID) const;  // true if the task retired a smaller fraction of its work than of its deadline
+
+	// response time statistics of the completed tasks
+	UInt64 getResponseTimePercentile(double percentile) const;
+	UInt64 getMeanResponseTime() const;
+
+private:
+	struct baseline {
+		UInt64 runtime;  // ns
+		UInt64 instructions;
+	};
+
+	struct taskInfo {
+		String taskName;
+		std::vector<thread_id_t> threads;
+		UInt64 arrivalTime = 0;
+		UInt64 startTime = 0;
+		UInt64 deadline = 0;
+		UInt64 lastUpdate = 0;
+		UInt64 instructions = 0;
+		const baseline *isolated = NULL;
+		bool running = false;
+	};
+
+	std::vector<taskInfo> tasks;
+	std::vector<int> taskOfCore;
+	std::map<std::string, baseline> baselines;
+	std::vector<UInt64> responseTimes;
+
+	void loadBaselines(String fileName);
+	static UInt64 statsCallback(String objectName, UInt32 index, String metricName, UInt64 arg);
+};
+
+#endif
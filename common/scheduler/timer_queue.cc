@@ -0,0 +1,24 @@
+#include "timer_queue.h"
+
+void TimerQueue::addPeriodic(int timerID, UInt64 epoch, UInt64 firstDeadline) {
+	if (epoch == 0) {
+		return;
+	}
+	UInt64 deadline = ((firstDeadline + epoch - 1) / epoch) * epoch;
+	timers.push({deadline, epoch, timerID});
+}
+
+bool TimerQueue::popDue(UInt64 now, int &timerID) {
+	if (timers.empty() || timers.top().deadline > now) {
+		return false;
+	}
+
+	timer t = timers.top();
+	timers.pop();
+	timerID = t.timerID;
+
+	t.deadline = (now / t.epoch + 1) * t.epoch;
+	timers.push(t);
+
+	return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * timer_queue
+ * This header implements a deadline queue for periodic scheduler work.
+ * Every periodic activity (mapping, DVFS, DRAM, migration, ...) registers the absolute time (in ns) of its
+ * next invocation. The caller only compares the current time against the earliest deadline, so periodic
+ * work costs a single comparison between deadlines.
+ */
+
+#ifndef __TIMER_QUEUE_H
+#define __TIMER_QUEUE_H
+
+#include "fixed_types.h"
+
+#include <queue>
+#include <vector>
+
+class TimerQueue {
+public:
+	// Register a periodic timer with the given epoch. The first deadline is the first multiple of the epoch
+	// that is not before firstDeadline. A zero epoch disables the timer.
+	void addPeriodic(int timerID, UInt64 epoch, UInt64 firstDeadline = 0);
+
+	// Earliest pending deadline, or UINT64_MAX if no timer is pending.
+	UInt64 nextDeadline() const { return timers.empty() ? UINT64_MAX : timers.top().deadline; }
+
+	// Pop the next timer that is due at time "now". Periodic timers are re-armed at the next multiple of
+	// their epoch that lies after "now", so missed deadlines are coalesced into a single invocation.
+	bool popDue(UInt64 now, int &timerID);
+
+private:
+	struct timer {
+		UInt64 deadline;
+		UInt64 epoch;
+		int timerID;  // timers due at the same time are popped in ascending ID order
+
+		bool operator> (const timer &other) const {
+			return deadline != other.deadline ? deadline > other.deadline : timerID > other.timerID;
+		}
+	};
+
+	std::priority_queue<timer, std::vector<timer>, std::greater<timer> > timers;
+};
+
+#endif
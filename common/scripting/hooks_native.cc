@@ -0,0 +1,235 @@
+#include "hooks_native.h"
+#include "hooks_manager.h"
+#include "simulator.h"
+#include "clock_skew_minimization_object.h"
+#include "dvfs_manager.h"
+#include "magic_server.h"
+#include "stats.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <dlfcn.h>
+
+std::vector<HooksNative::Plugin> HooksNative::s_plugins;
+std::vector<StatsManager::handle_t> HooksNative::s_stat_handles;
+std::unordered_map<StatsManager::handle_t, UInt64> HooksNative::s_stat_snapshot;
+Lock HooksNative::s_stat_lock;
+
+const sim_plugin_api_t HooksNative::s_api = {
+   SIM_PLUGIN_API_VERSION,
+   sizeof(sim_plugin_api_t),
+   HooksNative::registerHook,
+   HooksNative::getNumCores,
+   HooksNative::getNumBanks,
+   HooksNative::getTime,
+   HooksNative::getStatHandle,
+   HooksNative::getStat,
+   HooksNative::registerStat,
+   HooksNative::getFrequency,
+   HooksNative::setFrequency,
+   HooksNative::getBankMode,
+   HooksNative::setBankMode,
+   HooksNative::registerIndependentHook,
+   HooksNative::addHookDependency,
+};
+
+namespace {
+   struct HookClosure {
+      sim_plugin_hook_func_t func;
+      void *user;
+   };
+
+   SInt64 callHook(UInt64 arg, UInt64 val)
+   {
+      HookClosure *closure = (HookClosure *)arg;
+      return closure->func(closure->user, val);
+   }
+
+   struct StatClosure {
+      sim_plugin_stat_func_t func;
+      void *user;
+   };
+
+   UInt64 callStat(String objectName, UInt32 index, String metricName, UInt64 arg)
+   {
+      StatClosure *closure = (StatClosure *)arg;
+      return closure->func(closure->user);
+   }
+}
+
+void HooksNative::init()
+{
+   UInt64 numscripts = Sim()->getCfg()->getInt("hooks/numscripts");
+   for(UInt64 i = 0; i < numscripts; ++i) {
+      String scriptname = Sim()->getCfg()->getString(String("hooks/script") + itostr(i) + "name");
+      if (scriptname.length() > 3 && scriptname.substr(scriptname.length()-3) == ".so") {
+         String args = Sim()->getCfg()->getString(String("hooks/script") + itostr(i) + "args");
+         load(scriptname, args);
+      }
+   }
+}
+
+void HooksNative::load(String name, String args)
+{
+   printf("Loading native plugin %s\n", name.c_str());
+
+   void *handle = dlopen(name.c_str(), RTLD_NOW | RTLD_LOCAL);
+   LOG_ASSERT_ERROR(handle, "Cannot load plugin %s: %s", name.c_str(), dlerror());
+
+   typedef int (*init_func_t)(const sim_plugin_api_t *, const char *);
+   init_func_t init_func = (init_func_t)dlsym(handle, "sim_plugin_init");
+   LOG_ASSERT_ERROR(init_func, "Plugin %s does not define sim_plugin_init", name.c_str());
+
+   Plugin plugin = { name, handle };
+   s_plugins.push_back(plugin);
+
+   int res = init_func(&s_api, args.c_str());
+   LOG_ASSERT_ERROR(res == 0, "Plugin %s failed to initialize (%d)", name.c_str(), res);
+}
+
+void HooksNative::fini()
+{
+   for(std::vector<Plugin>::iterator it = s_plugins.begin(); it != s_plugins.end(); ++it) {
+      typedef void (*fini_func_t)(void);
+      fini_func_t fini_func = (fini_func_t)dlsym(it->handle, "sim_plugin_fini");
+      if (fini_func)
+         fini_func();
+      // Do not dlclose(): hooks and statistics callbacks of the plugin remain registered
+   }
+   s_plugins.clear();
+}
+
+int HooksNative::registerHook(int hook, sim_plugin_hook_func_t func, void *user)
+{
+   HookType::hook_type_t type;
+   switch(hook) {
+      case SIM_PLUGIN_HOOK_PERIODIC:       type = HookType::HOOK_PERIODIC;       break;
+      case SIM_PLUGIN_HOOK_SIM_START:      type = HookType::HOOK_SIM_START;      break;
+      case SIM_PLUGIN_HOOK_SIM_END:        type = HookType::HOOK_SIM_END;        break;
+      case SIM_PLUGIN_HOOK_ROI_BEGIN:      type = HookType::HOOK_ROI_BEGIN;      break;
+      case SIM_PLUGIN_HOOK_ROI_END:        type = HookType::HOOK_ROI_END;        break;
+      case SIM_PLUGIN_HOOK_PRE_STAT_WRITE: type = HookType::HOOK_PRE_STAT_WRITE; break;
+      default:
+         return -1;
+   }
+
+   HookClosure *closure = new HookClosure();
+   closure->func = func;
+   closure->user = user;
+   Sim()->getHooksManager()->registerHook(type, callHook, (UInt64)closure, HooksManager::ORDER_ACTION);
+   return 0;
+}
+
+uint32_t HooksNative::getNumCores()
+{
+   return Sim()->getConfig()->getApplicationCores();
+}
+
+uint32_t HooksNative::getNumBanks()
+{
+   return Sim()->getCfg()->getInt("memory/num_banks");
+}
+
+uint64_t HooksNative::getTime()
+{
+   return Sim()->getClockSkewMinimizationServer()->getGlobalTime().getFS();
+}
+
+sim_plugin_stat_t HooksNative::getStatHandle(const char *object_name, uint32_t index, const char *metric_name)
+{
+   LOG_ASSERT_ERROR(!Sim()->getHooksManager()->inPipelinedHook(), "Stats handles cannot be obtained from a pipelined hook");
+   StatsManager::handle_t handle = Sim()->getStatsManager()->getMetricHandle(object_name, index, metric_name);
+   if (handle == StatsManager::INVALID_HANDLE)
+      return SIM_PLUGIN_INVALID_STAT;
+
+   ScopedLock sl(s_stat_lock);
+   if (s_stat_snapshot.count(handle) == 0)
+   {
+      s_stat_handles.push_back(handle);
+      s_stat_snapshot[handle] = Sim()->getStatsManager()->getMetricValue(handle);
+   }
+   return handle;
+}
+
+uint64_t HooksNative::getStat(sim_plugin_stat_t handle)
+{
+   LOG_ASSERT_ERROR(handle < Sim()->getStatsManager()->getNumMetrics(), "Invalid stats handle %u", handle);
+   if (Sim()->getHooksManager()->inPipelinedHook())
+   {
+      // The cores have moved on, return the value at the barrier that started this hook
+      std::unordered_map<StatsManager::handle_t, UInt64>::const_iterator it = s_stat_snapshot.find(handle);
+      LOG_ASSERT_ERROR(it != s_stat_snapshot.end(), "Stats handle %u was not obtained through get_stat_handle", handle);
+      return it->second;
+   }
+   return Sim()->getStatsManager()->getMetricValue(handle);
+}
+
+void HooksNative::snapshotStats()
+{
+   // Called at the barrier, after the previous pipelined batch has completed
+   ScopedLock sl(s_stat_lock);
+   for(std::vector<StatsManager::handle_t>::const_iterator it = s_stat_handles.begin(); it != s_stat_handles.end(); ++it)
+      s_stat_snapshot[*it] = Sim()->getStatsManager()->getMetricValue(*it);
+}
+
+void HooksNative::registerStat(const char *object_name, uint32_t index, const char *metric_name, sim_plugin_stat_func_t func, void *user)
+{
+   StatClosure *closure = new StatClosure();
+   closure->func = func;
+   closure->user = user;
+   Sim()->getStatsManager()->registerMetric(new StatsMetricCallback(object_name, index, metric_name, callStat, (UInt64)closure));
+}
+
+uint32_t HooksNative::getFrequency(int32_t core_id)
+{
+   const ComponentPeriod *domain;
+   if (core_id == -1)
+      domain = Sim()->getDvfsManager()->getGlobalDomain();
+   else if (core_id >= 0 && core_id < (int32_t)Sim()->getConfig()->getApplicationCores())
+      domain = Sim()->getDvfsManager()->getCoreDomain(core_id);
+   else
+      return 0;
+   return 1000000000 / domain->getPeriod().getFS();
+}
+
+int HooksNative::setFrequency(int32_t core_id, uint32_t freq_mhz)
+{
+   if (core_id < 0 || core_id >= (int32_t)Sim()->getConfig()->getApplicationCores())
+      return -1;
+   // Hooks registered with register_hook run on the thread that holds the thread lock, so we can call MagicServer
+   // directly. Independent hooks may run concurrently with each other, and must leave simulator state alone.
+   LOG_ASSERT_ERROR(!Sim()->getHooksManager()->inIndependentHook(), "set_frequency cannot be called from an independent hook");
+   Sim()->getMagicServer()->setFrequency(core_id, freq_mhz);
+   return 0;
+}
+
+int HooksNative::getBankMode(uint32_t bank)
+{
+   if (bank >= getNumBanks())
+      return -1;
+   return Sim()->m_bank_modes[bank];
+}
+
+int HooksNative::setBankMode(uint32_t bank, int mode)
+{
+   if (bank >= getNumBanks() || (mode != SIM_PLUGIN_BANK_LOW_POWER && mode != SIM_PLUGIN_BANK_NORMAL_POWER))
+      return -1;
+   LOG_ASSERT_ERROR(!Sim()->getHooksManager()->inIndependentHook(), "set_bank_mode cannot be called from an independent hook");
+   Sim()->m_bank_modes[bank] = mode;
+   return 0;
+}
+
+int HooksNative::registerIndependentHook(const char *name, sim_plugin_hook_func_t func, void *user, int pipelined)
+{
+   HookClosure *closure = new HookClosure();
+   closure->func = func;
+   closure->user = user;
+   Sim()->getHooksManager()->registerIndependentHook(HookType::HOOK_PERIODIC, callHook, (UInt64)closure, name, HooksManager::ORDER_ACTION, pipelined);
+   return 0;
+}
+
+int HooksNative::addHookDependency(const char *name, const char *after)
+{
+   Sim()->getHooksManager()->addHookDependency(HookType::HOOK_PERIODIC, name, after);
+   return 0;
+}
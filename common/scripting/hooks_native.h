@@ -0,0 +1,48 @@
+#ifndef HOOKS_NATIVE_H
+#define HOOKS_NATIVE_H
+
+#include "fixed_types.h"
+#include "sim_plugin.h"
+#include "stats.h"
+#include "lock.h"
+
+#include <vector>
+#include <unordered_map>
+
+// Loads the native hook plugins (hook scripts ending in .so), see include/sim_plugin.h
+class HooksNative {
+   public:
+      static void init(void);
+      static void fini(void);
+      // Record the value of every statistic a plugin holds a handle to, pipelined hooks read these values
+      static void snapshotStats(void);
+
+   private:
+      struct Plugin {
+         String name;
+         void *handle;
+      };
+      static std::vector<Plugin> s_plugins;
+      static const sim_plugin_api_t s_api;
+      static std::vector<StatsManager::handle_t> s_stat_handles;
+      static std::unordered_map<StatsManager::handle_t, UInt64> s_stat_snapshot;
+      static Lock s_stat_lock;
+
+      static void load(String name, String args);
+
+      static int registerHook(int hook, sim_plugin_hook_func_t func, void *user);
+      static uint32_t getNumCores(void);
+      static uint32_t getNumBanks(void);
+      static uint64_t getTime(void);
+      static sim_plugin_stat_t getStatHandle(const char *object_name, uint32_t index, const char *metric_name);
+      static uint64_t getStat(sim_plugin_stat_t handle);
+      static void registerStat(const char *object_name, uint32_t index, const char *metric_name, sim_plugin_stat_func_t func, void *user);
+      static uint32_t getFrequency(int32_t core_id);
+      static int setFrequency(int32_t core_id, uint32_t freq_mhz);
+      static int getBankMode(uint32_t bank);
+      static int setBankMode(uint32_t bank, int mode);
+      static int registerIndependentHook(const char *name, sim_plugin_hook_func_t func, void *user, int pipelined);
+      static int addHookDependency(const char *name, const char *after);
+};
+
+#endif // HOOKS_NATIVE_H
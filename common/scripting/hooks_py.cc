@@ -5,6 +5,8 @@
 #include "fxsupport.h"
 
 bool HooksPy::pyInit = false;
+Lock HooksPy::s_lock;
+TLS *HooksPy::s_tls_depth = NULL;
 
 void HooksPy::init()
 {
@@ -29,11 +31,18 @@ void HooksPy::init()
          }
       }
    }
+
+#ifdef WITH_THREAD
+   // From now on, Python is only entered through HooksPy::Guard, which takes the GIL
+   if (pyInit)
+      PyEval_SaveThread();
+#endif
 }
 
 void HooksPy::setup()
 {
    pyInit = true;
+   s_tls_depth = TLS::create();
    const char* sim_root = NULL;
    const char env_roots[2][16] = {"SNIPER_ROOT", "GRAPHITE_ROOT"};
    for (unsigned int i = 0 ; i < 2 ; i++)
@@ -50,6 +59,10 @@ void HooksPy::setup()
 #endif
    Py_SetPythonHome(strdup(python_home.c_str()));
    Py_InitializeEx(0 /* don't initialize signal handlers */);
+#if defined(WITH_THREAD) && PY_VERSION_HEX < 0x03070000
+   // Create the GIL: callbacks can come from any simulator or hook worker thread
+   PyEval_InitThreads();
+#endif
 
    // set up all components
    PyConfig::setup();
@@ -65,7 +78,33 @@ void HooksPy::setup()
 void HooksPy::fini()
 {
    if (pyInit)
+   {
+#ifdef WITH_THREAD
+      PyGILState_Ensure();
+#endif
       Py_Finalize();
+   }
+}
+
+HooksPy::Guard::Guard()
+{
+   // Python callbacks can trigger hooks that call back into Python on the same thread
+   if (s_tls_depth->getInt() == 0)
+      s_lock.acquire();
+   s_tls_depth->setInt(s_tls_depth->getInt() + 1);
+#ifdef WITH_THREAD
+   m_gil_state = PyGILState_Ensure();
+#endif
+}
+
+HooksPy::Guard::~Guard()
+{
+#ifdef WITH_THREAD
+   PyGILState_Release(m_gil_state);
+#endif
+   s_tls_depth->setInt(s_tls_depth->getInt() - 1);
+   if (s_tls_depth->getInt() == 0)
+      s_lock.release();
 }
 
 PyObject * HooksPy::callPythonFunction(PyObject *pFunc, PyObject *pArgs)
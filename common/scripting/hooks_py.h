@@ -2,6 +2,8 @@
 #define HOOKS_PY_H
 
 #include "fixed_types.h"
+#include "lock.h"
+#include "tls.h"
 
 /* undef some macros to avoid redefined warnings */
 #undef _POSIX_C_SOURCE
@@ -15,8 +17,24 @@ class HooksPy {
       static void fini(void);
 
       static PyObject * callPythonFunction(PyObject *pFunc, PyObject *pArgs);
+
+      // Hold while calling into Python: independent hooks can run on hook worker threads,
+      // concurrently with Python callbacks on the thread that holds the thread lock.
+      // Serializes Python callbacks and, if Python was built with thread support, holds the GIL
+      // for the calling thread. Without thread support, the lock alone keeps the interpreter consistent.
+      class Guard {
+         public:
+            Guard();
+            ~Guard();
+#ifdef WITH_THREAD
+         private:
+            PyGILState_STATE m_gil_state;
+#endif
+      };
    private:
       static bool pyInit;
+      static Lock s_lock;
+      static TLS *s_tls_depth;
 
       class PyConfig {
          public:
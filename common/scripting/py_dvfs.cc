@@ -2,6 +2,7 @@
 #include "simulator.h"
 #include "dvfs_manager.h"
 #include "magic_server.h"
+#include "hooks_manager.h"
 
 
 static const ComponentPeriod * getDomain(SInt64 domain_id, bool allow_global)
@@ -59,7 +60,12 @@ setFrequency(PyObject *self, PyObject *args)
    if (!domain)
       return NULL;
 
-   // We're running in a hook so we already have the thread lock, call MagicServer directly
+   // Ordinary hooks run on the thread that holds the thread lock, so we can call MagicServer directly.
+   // Independent hooks may run concurrently with each other, and must leave simulator state alone.
+   if (Sim()->getHooksManager()->inIndependentHook()) {
+      PyErr_SetString(PyExc_RuntimeError, "set_frequency cannot be called from an independent hook");
+      return NULL;
+   }
    Sim()->getMagicServer()->setFrequency(core_id, freq_mhz);
 
    Py_RETURN_NONE;
@@ -21,18 +21,21 @@ static SInt64 hookCallbackResult(PyObject *pResult)
 
 static SInt64 hookCallbackNone(UInt64 pFunc, UInt64)
 {
+   HooksPy::Guard guard;
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, NULL);
    return hookCallbackResult(pResult);
 }
 
 static SInt64 hookCallbackInt(UInt64 pFunc, UInt64 argument)
 {
+   HooksPy::Guard guard;
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(L)", argument));
    return hookCallbackResult(pResult);
 }
 
 static SInt64 hookCallbackSubsecondTime(UInt64 pFunc, UInt64 argument)
 {
+   HooksPy::Guard guard;
    SubsecondTime time(*(subsecond_time_t*)&argument);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(L)", time.getFS()));
    return hookCallbackResult(pResult);
@@ -40,6 +43,7 @@ static SInt64 hookCallbackSubsecondTime(UInt64 pFunc, UInt64 argument)
 
 static SInt64 hookCallbackString(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    const char* argument = (const char*)_argument;
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(s)", argument));
    return hookCallbackResult(pResult);
@@ -47,6 +51,7 @@ static SInt64 hookCallbackString(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackMagicMarkerType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    MagicServer::MagicMarkerType* argument = (MagicServer::MagicMarkerType*)_argument;
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iiKKs)", argument->thread_id, argument->core_id, argument->arg0, argument->arg1, argument->str));
    return hookCallbackResult(pResult);
@@ -54,6 +59,7 @@ static SInt64 hookCallbackMagicMarkerType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackThreadCreateType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    HooksManager::ThreadCreate* argument = (HooksManager::ThreadCreate*)_argument;
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(ii)", argument->thread_id, argument->creator_thread_id));
    return hookCallbackResult(pResult);
@@ -61,6 +67,7 @@ static SInt64 hookCallbackThreadCreateType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackThreadTimeType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    HooksManager::ThreadTime* argument = (HooksManager::ThreadTime*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iL)", argument->thread_id, time.getFS()));
@@ -69,6 +76,7 @@ static SInt64 hookCallbackThreadTimeType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackThreadStallType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    HooksManager::ThreadStall* argument = (HooksManager::ThreadStall*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(isL)", argument->thread_id, ThreadManager::stall_type_names[argument->reason], time.getFS()));
@@ -77,6 +85,7 @@ static SInt64 hookCallbackThreadStallType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackThreadResumeType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    HooksManager::ThreadResume* argument = (HooksManager::ThreadResume*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iiL)", argument->thread_id, argument->thread_by, time.getFS()));
@@ -85,6 +94,7 @@ static SInt64 hookCallbackThreadResumeType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackThreadMigrateType(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    HooksManager::ThreadMigrate* argument = (HooksManager::ThreadMigrate*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iiL)", argument->thread_id, argument->core_id, time.getFS()));
@@ -93,6 +103,7 @@ static SInt64 hookCallbackThreadMigrateType(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackSyscallEnter(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    SyscallMdl::HookSyscallEnter* argument = (SyscallMdl::HookSyscallEnter*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iiLi(llllll))", argument->thread_id, argument->core_id, time.getFS(),
@@ -102,6 +113,7 @@ static SInt64 hookCallbackSyscallEnter(UInt64 pFunc, UInt64 _argument)
 
 static SInt64 hookCallbackSyscallExit(UInt64 pFunc, UInt64 _argument)
 {
+   HooksPy::Guard guard;
    SyscallMdl::HookSyscallExit* argument = (SyscallMdl::HookSyscallExit*)_argument;
    SubsecondTime time(argument->time);
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(iiLiO)", argument->thread_id, argument->core_id, time.getFS(),
@@ -152,6 +164,8 @@ registerHook(PyObject *self, PyObject *args)
          Sim()->getHooksManager()->registerHook(type, hookCallbackInt, (UInt64)pFunc);
          break;
       case HookType::HOOK_PRE_STAT_WRITE:
+      case HookType::HOOK_CHECKPOINT_SAVE:
+      case HookType::HOOK_CHECKPOINT_RESTORE:
          Sim()->getHooksManager()->registerHook(type, hookCallbackString, (UInt64)pFunc);
          break;
       case HookType::HOOK_MAGIC_MARKER:
@@ -187,6 +201,52 @@ registerHook(PyObject *self, PyObject *args)
    Py_RETURN_NONE;
 }
 
+static PyObject *
+registerIndependentHook(PyObject *self, PyObject *args)
+{
+   int hook = -1;
+   PyObject *pFunc = NULL;
+   const char *name = NULL;
+
+   if (!PyArg_ParseTuple(args, "lOs", &hook, &pFunc, &name))
+      return NULL;
+
+   if (hook != HookType::HOOK_PERIODIC) {
+      PyErr_SetString(PyExc_ValueError, "Only HOOK_PERIODIC callbacks can be independent");
+      return NULL;
+   }
+   if (!PyCallable_Check(pFunc)) {
+      PyErr_SetString(PyExc_TypeError, "Second argument must be callable");
+      return NULL;
+   }
+
+   Py_INCREF(pFunc);
+
+   // Runs concurrently with native independent callbacks, possibly on a worker thread (hookCallbackSubsecondTime
+   // takes the GIL through HooksPy::Guard). Python callbacks are serialized by the guard anyway, so chain them
+   // in registration order rather than have them contend for it. Same order as sim.hooks.register().
+   static String last_name;
+   Sim()->getHooksManager()->registerIndependentHook(HookType::HOOK_PERIODIC, hookCallbackSubsecondTime, (UInt64)pFunc, name, HooksManager::ORDER_NOTIFY_PRE);
+   if (last_name != "")
+      Sim()->getHooksManager()->addHookDependency(HookType::HOOK_PERIODIC, name, last_name);
+   last_name = name;
+
+   Py_RETURN_NONE;
+}
+
+static PyObject *
+addHookDependency(PyObject *self, PyObject *args)
+{
+   const char *name = NULL, *after = NULL;
+
+   if (!PyArg_ParseTuple(args, "ss", &name, &after))
+      return NULL;
+
+   Sim()->getHooksManager()->addHookDependency(HookType::HOOK_PERIODIC, name, after);
+
+   Py_RETURN_NONE;
+}
+
 static PyObject *
 triggerHookMagicUser(PyObject *self, PyObject *args)
 {
@@ -202,6 +262,8 @@ triggerHookMagicUser(PyObject *self, PyObject *args)
 
 static PyMethodDef PyHooksMethods[] = {
    {"register",  registerHook, METH_VARARGS, "Register callback function to a Sniper hook."},
+   {"register_independent", registerIndependentHook, METH_VARARGS, "Register a HOOK_PERIODIC callback that may run concurrently with other independent callbacks."},
+   {"add_dependency", addHookDependency, METH_VARARGS, "Run independent HOOK_PERIODIC callback name after callback after."},
    {"trigger_magic_user", triggerHookMagicUser, METH_VARARGS, "Trigger HOOK_MAGIC_USER hook."},
    {NULL, NULL, 0, NULL} /* Sentinel */
 };
@@ -30,6 +30,46 @@ getStatsValue(PyObject *self, PyObject *args)
 }
 
 
+//////////
+// handle(): return the integer handle of a statistic, get_handle(): retrieve a stats value by handle
+//////////
+
+static PyObject *
+getStatsHandle(PyObject *self, PyObject *args)
+{
+   const char *objectName = NULL, *metricName = NULL;
+   long int index = -1;
+
+   if (!PyArg_ParseTuple(args, "sls", &objectName, &index, &metricName))
+      return NULL;
+
+   StatsManager::handle_t handle = Sim()->getStatsManager()->getMetricHandle(objectName, index, metricName);
+
+   if (handle == StatsManager::INVALID_HANDLE) {
+      PyErr_SetString(PyExc_ValueError, "Stats metric not found");
+      return NULL;
+   }
+
+   return PyLong_FromUnsignedLong(handle);
+}
+
+static PyObject *
+getStatsValueByHandle(PyObject *self, PyObject *args)
+{
+   unsigned long int handle = 0;
+
+   if (!PyArg_ParseTuple(args, "k", &handle))
+      return NULL;
+
+   if (handle >= Sim()->getStatsManager()->getNumMetrics()) {
+      PyErr_SetString(PyExc_ValueError, "Invalid stats handle");
+      return NULL;
+   }
+
+   return PyLong_FromUnsignedLongLong(Sim()->getStatsManager()->getMetricValue(handle));
+}
+
+
 //////////
 // getter(): return a statsGetterObject Python object which, when called, returns a stats value
 //////////
@@ -145,6 +185,7 @@ writeStats(PyObject *self, PyObject *args)
 
 static UInt64 statsCallback(String objectName, UInt32 index, String metricName, UInt64 _pFunc)
 {
+   HooksPy::Guard guard;
    PyObject *pFunc = (PyObject*)_pFunc;
    PyObject *pResult = HooksPy::callPythonFunction(pFunc, Py_BuildValue("(sls)", objectName.c_str(), index, metricName.c_str()));
 
@@ -245,6 +286,8 @@ getIcount(PyObject *self, PyObject *args)
 
 static PyMethodDef PyStatsMethods[] = {
    {"get",  getStatsValue, METH_VARARGS, "Retrieve current value of statistic (objectName, index, metricName)."},
+   {"handle", getStatsHandle, METH_VARARGS, "Return the integer handle of a statistic (objectName, index, metricName)."},
+   {"get_handle", getStatsValueByHandle, METH_VARARGS, "Retrieve current value of statistic by handle."},
    {"getter", getStatsGetter, METH_VARARGS, "Return object to retrieve statistics value."},
    {"write", writeStats, METH_VARARGS, "Write statistics (<prefix>, [<filename>])."},
    {"register", registerStats, METH_VARARGS, "Register callback that defines statistics value for (objectName, index, metricName)."},
@@ -12,8 +12,13 @@
 #include "stats.h"
 #include "config.hpp"
 #include "circular_log.h"
+#include "timer.h"
 
 #include <algorithm>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
 
 BarrierSyncServer::BarrierSyncServer()
    : m_local_clock_list(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero())
@@ -24,6 +29,19 @@ BarrierSyncServer::BarrierSyncServer()
    , m_global_time(SubsecondTime::Zero())
    , m_fastforward(false)
    , m_disable(false)
+   , m_coherence_stats_resolved(false)
+   , m_last_coherence_events(0)
+   , m_sync_events(0)
+   , m_num_releases(0)
+   , m_host_wait_time(Sim()->getConfig()->getApplicationCores(), 0)
+   , m_sr_state(0)
+   , m_sr_futex(0)
+   , m_sr_next_barrier_fs(0)
+   , m_sr_expected(Sim()->getConfig()->getApplicationCores(), SR_NONE)
+   , m_sr_arrived(Sim()->getConfig()->getApplicationCores(), SR_NONE)
+   , m_sr_force_exit(Sim()->getConfig()->getApplicationCores(), 0)
+   , m_sr_releasing(false)
+   , m_sr_futex_waits(0)
 {
    try
    {
@@ -39,12 +57,39 @@ BarrierSyncServer::BarrierSyncServer()
 
    m_next_barrier_time = m_barrier_interval;
 
+   m_adaptive = Sim()->getCfg()->getBool("clock_skew_minimization/barrier/adaptive");
+   m_min_interval = m_barrier_interval;
+   m_max_interval = SubsecondTime::NS() * (UInt64) Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/max_quantum");
+   m_widen_below = Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/widen_below");
+   m_narrow_above = Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/narrow_above");
+   if (m_adaptive)
+   {
+      LOG_ASSERT_ERROR(m_max_interval >= m_min_interval, "clock_skew_minimization/barrier/adaptive/max_quantum must be at least the barrier quantum");
+      LOG_ASSERT_ERROR(m_widen_below <= m_narrow_above, "clock_skew_minimization/barrier/adaptive/widen_below cannot exceed narrow_above");
+   }
+
+   String implementation = Sim()->getCfg()->getString("clock_skew_minimization/barrier/implementation");
+   LOG_ASSERT_ERROR(implementation == "locked" || implementation == "sense_reversal", "Invalid clock_skew_minimization/barrier/implementation %s, expected locked or sense_reversal", implementation.c_str());
+   m_sense_reversal = (implementation == "sense_reversal");
+   m_spin_count = Sim()->getCfg()->getInt("clock_skew_minimization/barrier/sense_reversal/spin_count");
+   LOG_ASSERT_ERROR(Sim()->getConfig()->getApplicationCores() <= SR_COUNT_MASK, "Too many cores for the sense-reversing barrier");
+   m_sr_next_barrier_fs = m_next_barrier_time.getFS();
+
    // Order our hooks to occur after possible reschedulings (which are done with ORDER_ACTION)
    Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_EXIT, BarrierSyncServer::hookThreadExit, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
    Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_STALL, BarrierSyncServer::hookThreadStall, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
    Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_MIGRATE, BarrierSyncServer::hookThreadMigrate, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
+   if (m_sense_reversal)
+   {
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_RESUME, BarrierSyncServer::hookThreadResume, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
+      registerStatsMetric("barrier", 0, "futex-waits", &m_sr_futex_waits);
+   }
 
    registerStatsMetric("barrier", 0, "global_time", &m_global_time);
+   registerStatsMetric("barrier", 0, "quantum", &m_barrier_interval);
+   registerStatsMetric("barrier", 0, "releases", &m_num_releases);
+   for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
+      registerStatsMetric("barrier", core_id, "host-wait-time", &m_host_wait_time[core_id]);
 }
 
 BarrierSyncServer::~BarrierSyncServer()
@@ -56,6 +101,12 @@ BarrierSyncServer::~BarrierSyncServer()
 void
 BarrierSyncServer::synchronize(core_id_t core_id, SubsecondTime time)
 {
+   if (m_sense_reversal && !m_fastforward)
+   {
+      srSynchronize(core_id, time);
+      return;
+   }
+
    ScopedLock sl(Sim()->getThreadManager()->getLock());
    if (m_disable)
       return;
@@ -97,7 +148,11 @@ BarrierSyncServer::synchronize(core_id_t core_id, SubsecondTime time)
       mustWait = barrierRelease(thread_me);
 
    if (mustWait)
+   {
+      UInt64 wait_start = Timer::now();
       m_core_cond[master_core_id]->wait(Sim()->getThreadManager()->getLock());
+      m_host_wait_time[master_core_id] += Timer::now() - wait_start;
+   }
    else
       master_core->getPerformanceModel()->barrierExit();
 
@@ -107,6 +162,11 @@ BarrierSyncServer::synchronize(core_id_t core_id, SubsecondTime time)
 void
 BarrierSyncServer::threadExit(HooksManager::ThreadTime *argument)
 {
+   if (m_sense_reversal && !m_fastforward)
+   {
+      srThreadEvent(argument->thread_id);
+      return;
+   }
    // Release thread from the barrier
    releaseThread(argument->thread_id);
    // Check to see if we were waiting for this thread
@@ -116,6 +176,12 @@ BarrierSyncServer::threadExit(HooksManager::ThreadTime *argument)
 void
 BarrierSyncServer::threadStall(HooksManager::ThreadStall *argument)
 {
+   ++m_sync_events;
+   if (m_sense_reversal && !m_fastforward)
+   {
+      srThreadEvent(argument->thread_id);
+      return;
+   }
    // Release thread from the barrier
    releaseThread(argument->thread_id);
    // Check to see if we were waiting for this thread
@@ -125,6 +191,11 @@ BarrierSyncServer::threadStall(HooksManager::ThreadStall *argument)
 void
 BarrierSyncServer::threadMigrate(HooksManager::ThreadMigrate *argument)
 {
+   if (m_sense_reversal && !m_fastforward)
+   {
+      srThreadEvent(argument->thread_id);
+      return;
+   }
    // Update the migrating thread's time so we'll be sure to release it
    releaseThread(argument->thread_id);
    // Migration due to thread stall/exit will generate another event later, we'll do a signal() then
@@ -186,7 +257,10 @@ BarrierSyncServer::isCoreRunning(core_id_t core_id, bool siblings)
 void
 BarrierSyncServer::advance()
 {
-   barrierRelease(INVALID_THREAD_ID, true);
+   if (m_sense_reversal && !m_fastforward)
+      srRelease(srEpisode(), true);
+   else
+      barrierRelease(INVALID_THREAD_ID, true);
 }
 
 bool
@@ -283,6 +357,9 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
       if (m_disable)
          return false;
 
+      if (m_adaptive && !m_fastforward)
+         adaptBarrierInterval();
+
       m_next_barrier_time += m_barrier_interval;
       LOG_PRINT("m_next_barrier_time updated to (%s)", itostr(m_next_barrier_time).c_str());
 
@@ -315,12 +392,257 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
    // To avoid overwhelming the OS scheduler, we only release N threads at a time (N ~= host cores).
    // Once a thread is done (stops executing because it completed the next barrier quantum, or due to thread stall),
    // one more thread is released so we always have at most N running threads.
+   ++m_num_releases;
    std::random_shuffle(m_to_release.begin(), m_to_release.end());
    doRelease(m_fastforward ? -1 : Sim()->getConfig()->getNumHostCores());
 
    return must_wait;
 }
 
+UInt64
+BarrierSyncServer::getCoherenceEvents()
+{
+   // Caches register their statistics after the barrier server is created, resolve them on first use
+   if (!m_coherence_stats_resolved)
+   {
+      String stats = Sim()->getCfg()->getString("clock_skew_minimization/barrier/adaptive/coherence_stats");
+      String::size_type start = 0;
+      while (start < stats.length())
+      {
+         String::size_type end = stats.find(',', start);
+         if (end == String::npos)
+            end = stats.length();
+         String name = stats.substr(start, end - start);
+         String::size_type dot = name.rfind('.');
+         LOG_ASSERT_ERROR(dot != String::npos, "Invalid statistic %s in clock_skew_minimization/barrier/adaptive/coherence_stats, expected object.metric", name.c_str());
+         std::vector<StatsManager::handle_t> handles = Sim()->getStatsManager()->getMetricHandles(name.substr(0, dot), name.substr(dot + 1));
+         m_coherence_stats.insert(m_coherence_stats.end(), handles.begin(), handles.end());
+         start = end + 1;
+      }
+      m_coherence_stats_resolved = true;
+   }
+
+   UInt64 events = 0;
+   for(std::vector<StatsManager::handle_t>::iterator it = m_coherence_stats.begin(); it != m_coherence_stats.end(); ++it)
+      events += Sim()->getStatsManager()->getMetricValue(*it);
+   return events;
+}
+
+void
+BarrierSyncServer::adaptBarrierInterval()
+{
+   UInt64 coherence_events = getCoherenceEvents();
+   UInt64 events = (coherence_events - m_last_coherence_events) + m_sync_events;
+   m_last_coherence_events = coherence_events;
+   m_sync_events = 0;
+
+   // Event rate over the quantum that just finished, in events per microsecond
+   UInt64 rate = events * 1000 / std::max(m_barrier_interval.getNS(), UInt64(1));
+
+   // Quanta are power-of-two multiples of the base quantum
+   SubsecondTime old_interval = m_barrier_interval;
+   UInt64 multiple = m_barrier_interval.getFS() / m_min_interval.getFS();
+   if (rate > m_narrow_above && multiple > 1)
+      m_barrier_interval = m_min_interval * (multiple / 2);
+   else if (rate < m_widen_below && m_barrier_interval < m_max_interval)
+      m_barrier_interval = std::min(m_max_interval, m_min_interval * (multiple * 2));
+
+   // BarrierSyncClient places its next barrier on the next multiple of the current interval.
+   // Move to the new interval's phase, so that m_next_barrier_time += m_barrier_interval lands on
+   // the same time as the clients do.
+   if (m_barrier_interval != old_interval)
+      m_next_barrier_time = (m_next_barrier_time / m_barrier_interval) * m_barrier_interval;
+}
+
+void
+BarrierSyncServer::srSynchronize(core_id_t core_id, SubsecondTime time)
+{
+   if (m_disable)
+      return;
+
+   // Lock-free fast path: no barrier to wait for yet
+   if (time.getFS() < __atomic_load_n(&m_sr_next_barrier_fs, __ATOMIC_ACQUIRE))
+      return;
+
+   Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+   core_id_t master_core_id = m_core_group[core_id] == INVALID_CORE_ID ? core_id : m_core_group[core_id];
+   Core *master_core = Sim()->getCoreManager()->getCoreFromID(core_id);
+
+   CLOG("barrier", "Core %d entry (master core %d, sense reversal)", core_id, master_core_id);
+
+   master_core->getPerformanceModel()->barrierEnter();
+
+   m_local_clock_list[master_core_id] = time;
+   m_core_thread[master_core_id] = core->getThread()->getId();
+   UInt64 wait_start = Timer::now();
+
+   while (true)
+   {
+      UInt64 episode = srEpisode();
+      __atomic_store_n(&m_sr_arrived[master_core_id], episode, __ATOMIC_RELEASE);
+
+      // Only cores that were expected in this episode count down; the last one releases the barrier
+      if (__sync_bool_compare_and_swap(&m_sr_expected[master_core_id], episode, SR_NONE))
+      {
+         UInt64 state = __sync_fetch_and_sub(&m_sr_state, 1);
+         if ((state & SR_COUNT_MASK) == 1)
+         {
+            ScopedLock sl(Sim()->getThreadManager()->getLock());
+            // Thread state changes may have released this episode already, or made a newly
+            // running core expected in it, in which case that core releases it when it arrives
+            if (srEpisode() == episode
+                && (__atomic_load_n(&m_sr_state, __ATOMIC_ACQUIRE) & SR_COUNT_MASK) == 0
+                && !m_sr_releasing)
+               srRelease(episode);
+         }
+      }
+
+      srWait(episode);
+
+      if (m_disable || m_fastforward || __atomic_load_n(&m_sr_force_exit[master_core_id], __ATOMIC_ACQUIRE)
+          || time.getFS() < __atomic_load_n(&m_sr_next_barrier_fs, __ATOMIC_ACQUIRE))
+         break;
+      // Still ahead of the next barrier: arrive again in the next episode
+   }
+
+   __atomic_store_n(&m_sr_force_exit[master_core_id], 0, __ATOMIC_RELEASE);
+   m_host_wait_time[master_core_id] += Timer::now() - wait_start;
+   master_core->getPerformanceModel()->barrierExit();
+
+   CLOG("barrier", "Core %d exit (master core %d, sense reversal)", core_id, master_core_id);
+}
+
+void
+BarrierSyncServer::srWait(UInt64 episode)
+{
+   for(UInt64 i = 0; i < m_spin_count; ++i)
+   {
+      if (srEpisode() != episode)
+         return;
+#if defined(__i386__) || defined(__x86_64__)
+      __builtin_ia32_pause();
+#endif
+   }
+
+   int futex_value = int(episode);
+   while (__atomic_load_n(&m_sr_futex, __ATOMIC_ACQUIRE) == futex_value)
+   {
+      __sync_fetch_and_add(&m_sr_futex_waits, 1);
+      // Returns immediately when the episode was changed in the meantime
+      syscall(SYS_futex, (void*) &m_sr_futex, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, futex_value, NULL, NULL, 0);
+   }
+}
+
+bool
+BarrierSyncServer::srHasWaiters(UInt64 episode)
+{
+   for(core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+      if (__atomic_load_n(&m_sr_arrived[core_id], __ATOMIC_ACQUIRE) == episode)
+         return true;
+   return false;
+}
+
+void
+BarrierSyncServer::srRelease(UInt64 episode, bool continue_until_release)
+{
+   // Called with the thread manager lock held, all cores that are expected in this episode have arrived
+   CLOG("barrier", "Release (sense reversal, episode %" PRId64 ")", episode);
+   m_sr_releasing = true;
+
+   // Same as barrierRelease(): if no waiting core can be resumed, keep advancing time so we make forward progress
+   bool core_resumed = false;
+   while (!core_resumed)
+   {
+      m_global_time = m_next_barrier_time;
+      CLOG("barrier", "Barrier %" PRId64 "ns", m_next_barrier_time.getNS());
+      Sim()->getHooksManager()->callHooks(HookType::HOOK_PERIODIC, static_cast<subsecond_time_t>(m_next_barrier_time).m_time);
+
+      if (continue_until_release)
+      {
+         // HOOK_PERIODIC woke someone up, start a new episode that includes it
+         if (Sim()->getThreadManager()->anyThreadRunning())
+            break;
+         else
+            LOG_ASSERT_ERROR(Sim()->getSyscallServer()->getNextTimeout(m_global_time) < SubsecondTime::MaxTime(), "No threads running, no timeout. Application has deadlocked...");
+      }
+
+      // If the barrier was disabled from HOOK_PERIODIC, waiting cores leave when the episode ends
+      if (m_disable)
+         break;
+
+      if (m_adaptive)
+         adaptBarrierInterval();
+
+      m_next_barrier_time += m_barrier_interval;
+
+      for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+         if (__atomic_load_n(&m_sr_arrived[core_id], __ATOMIC_ACQUIRE) == episode
+             && (m_local_clock_list[core_id] < m_next_barrier_time || __atomic_load_n(&m_sr_force_exit[core_id], __ATOMIC_ACQUIRE)))
+            core_resumed = true;
+   }
+
+   ++m_num_releases;
+   m_sr_releasing = false;
+   srPublish();
+}
+
+void
+BarrierSyncServer::srPublish()
+{
+   // Called with the thread manager lock held: start the next episode, every running core is expected to arrive
+   UInt64 episode = srEpisode() + 1;
+   UInt64 count = 0;
+   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   {
+      if (m_core_group[core_id] == INVALID_CORE_ID && isCoreRunning(core_id))
+      {
+         __atomic_store_n(&m_sr_expected[core_id], episode, __ATOMIC_RELEASE);
+         ++count;
+      }
+      else
+         __atomic_store_n(&m_sr_expected[core_id], SR_NONE, __ATOMIC_RELEASE);
+   }
+
+   __atomic_store_n(&m_sr_next_barrier_fs, m_next_barrier_time.getFS(), __ATOMIC_RELEASE);
+   __atomic_store_n(&m_sr_state, (episode << SR_COUNT_BITS) | count, __ATOMIC_RELEASE);
+   __atomic_store_n(&m_sr_futex, int(episode), __ATOMIC_RELEASE);
+   syscall(SYS_futex, (void*) &m_sr_futex, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, NULL, NULL, 0);
+}
+
+void
+BarrierSyncServer::srThreadEvent(thread_id_t thread_id)
+{
+   // Called with the thread manager lock held, after a thread stalled, resumed, exited or migrated
+   UInt64 episode = srEpisode();
+
+   // A thread that is moved away while waiting in the barrier leaves when the episode ends
+   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+      if (__atomic_load_n(&m_sr_arrived[core_id], __ATOMIC_ACQUIRE) == episode && m_core_thread[core_id] == thread_id)
+         __atomic_store_n(&m_sr_force_exit[core_id], 1, __ATOMIC_RELEASE);
+
+   // Update the set of cores that are expected to arrive in this episode
+   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   {
+      if (m_core_group[core_id] == INVALID_CORE_ID && isCoreRunning(core_id))
+      {
+         if (__atomic_load_n(&m_sr_expected[core_id], __ATOMIC_ACQUIRE) != episode
+             && __atomic_load_n(&m_sr_arrived[core_id], __ATOMIC_ACQUIRE) != episode)
+         {
+            // Started running during this episode
+            __atomic_store_n(&m_sr_expected[core_id], episode, __ATOMIC_RELEASE);
+            __sync_fetch_and_add(&m_sr_state, 1);
+         }
+      }
+      else if (__sync_bool_compare_and_swap(&m_sr_expected[core_id], episode, SR_NONE))
+      {
+         // Stopped running before arriving, the barrier no longer waits for it
+         UInt64 state = __sync_fetch_and_sub(&m_sr_state, 1);
+         if ((state & SR_COUNT_MASK) == 1 && !m_sr_releasing && srHasWaiters(episode))
+            srRelease(episode);
+      }
+   }
+}
+
 void
 BarrierSyncServer::doRelease(int n)
 {
@@ -338,6 +660,18 @@ void
 BarrierSyncServer::abortBarrier()
 {
    CLOG("barrier", "Abort");
+   if (m_sense_reversal)
+   {
+      // Let all cores waiting in the current episode leave. If we are called from HOOK_PERIODIC,
+      // the release in progress starts the next episode.
+      UInt64 episode = srEpisode();
+      for(core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+         if (__atomic_load_n(&m_sr_arrived[core_id], __ATOMIC_ACQUIRE) == episode)
+            __atomic_store_n(&m_sr_force_exit[core_id], 1, __ATOMIC_RELEASE);
+      if (!m_sr_releasing)
+         srPublish();
+   }
+
    for(core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
    {
       // Check if this core was running. If yes, release that core
@@ -379,6 +713,7 @@ BarrierSyncServer::setFastForward(bool fastforward, SubsecondTime next_barrier_t
    {
       m_next_barrier_time = std::max(m_next_barrier_time, next_barrier_time);
    }
+   __atomic_store_n(&m_sr_next_barrier_fs, m_next_barrier_time.getFS(), __ATOMIC_RELEASE);
 }
 
 void
@@ -4,6 +4,7 @@
 #include "fixed_types.h"
 #include "cond.h"
 #include "hooks_manager.h"
+#include "stats.h"
 
 #include <vector>
 
@@ -24,6 +25,50 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       bool m_fastforward;
       volatile bool m_disable;
 
+      // Adaptive quantum: widen the barrier interval (up to m_max_interval) while coherence traffic and
+      // synchronization are rare, narrow it (down to the configured quantum) when they become frequent
+      bool m_adaptive;
+      SubsecondTime m_min_interval;
+      SubsecondTime m_max_interval;
+      UInt64 m_widen_below;   // events per microsecond
+      UInt64 m_narrow_above;  // events per microsecond
+      std::vector<StatsManager::handle_t> m_coherence_stats;
+      bool m_coherence_stats_resolved;
+      UInt64 m_last_coherence_events;
+      UInt64 m_sync_events;
+      void adaptBarrierInterval(void);
+      UInt64 getCoherenceEvents(void);
+
+      UInt64 m_num_releases;
+      std::vector<UInt64> m_host_wait_time;   // host time spent waiting at the barrier, in ns
+
+      // Sense-reversing barrier (implementation = sense_reversal, detailed mode only): cores arrive with atomic
+      // operations on an (episode, arrivals still expected) word and wait for the episode to change, first by
+      // spinning and then by sleeping on a futex. Only the last arriving core takes the thread manager lock,
+      // to call HOOK_PERIODIC and start the next episode. Thread state changes, which already happen under the
+      // thread manager lock, update the set of cores that are expected to arrive.
+      static const UInt64 SR_COUNT_BITS = 24;
+      static const UInt64 SR_COUNT_MASK = (1 << SR_COUNT_BITS) - 1;
+      static const UInt64 SR_NONE = UINT64_MAX;
+      bool m_sense_reversal;
+      UInt64 m_spin_count;
+      volatile UInt64 m_sr_state;              // episode << SR_COUNT_BITS | number of cores still expected to arrive
+      volatile int m_sr_futex;                 // low bits of the episode, to sleep on
+      volatile UInt64 m_sr_next_barrier_fs;    // copy of m_next_barrier_time for the lock-free fast path
+      std::vector<UInt64> m_sr_expected;       // episode in which the core is still expected to arrive, or SR_NONE
+      std::vector<UInt64> m_sr_arrived;        // last episode in which the core arrived
+      std::vector<UInt8> m_sr_force_exit;      // leave the barrier when the episode ends, regardless of time (read lock-free, access atomically)
+      bool m_sr_releasing;
+      UInt64 m_sr_futex_waits;
+
+      UInt64 srEpisode(void) { return __atomic_load_n(&m_sr_state, __ATOMIC_ACQUIRE) >> SR_COUNT_BITS; }
+      void srSynchronize(core_id_t core_id, SubsecondTime time);
+      void srWait(UInt64 episode);
+      bool srHasWaiters(UInt64 episode);
+      void srRelease(UInt64 episode, bool continue_until_release = false);
+      void srPublish(void);
+      void srThreadEvent(thread_id_t thread_id);
+
       bool isBarrierReached(void);
       bool barrierRelease(thread_id_t thread_id = INVALID_THREAD_ID, bool continue_until_release = false);
       void abortBarrier(void);
@@ -41,6 +86,9 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       static SInt64 hookThreadMigrate(UInt64 object, UInt64 argument) {
          ((BarrierSyncServer*)object)->threadMigrate((HooksManager::ThreadMigrate*)argument); return 0;
       }
+      static SInt64 hookThreadResume(UInt64 object, UInt64 argument) {
+         ((BarrierSyncServer*)object)->srThreadEvent(((HooksManager::ThreadResume*)argument)->thread_id); return 0;
+      }
       void threadExit(HooksManager::ThreadTime *argument);
       void threadStall(HooksManager::ThreadStall *argument);
       void threadMigrate(HooksManager::ThreadMigrate *argument);
@@ -0,0 +1,198 @@
+#include "checkpoint_manager.h"
+#include "simulator.h"
+#include "core_manager.h"
+#include "core.h"
+#include "performance_model.h"
+#include "memory_manager_base.h"
+#include "shmem_perf_model.h"
+#include "hooks_manager.h"
+#include "magic_server.h"
+#include "stats.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
+
+CheckpointManager::CheckpointManager()
+   : m_save_time(SubsecondTime::NS(Sim()->getCfg()->getInt("checkpoint/save_time")))
+   , m_save_marker(Sim()->getCfg()->getInt("checkpoint/save_marker"))
+   , m_save_dir(Sim()->getConfig()->formatOutputFileName(Sim()->getCfg()->getString("checkpoint/dir")))
+   , m_save_pending(false)
+   , m_saved(false)
+   , m_restore_dir(Sim()->getCfg()->getString("checkpoint/restore"))
+   , m_restore_time(SubsecondTime::Zero())
+   , m_restore_cpis(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero())
+{
+   if (m_save_time > SubsecondTime::Zero() || m_save_marker)
+   {
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, CheckpointManager::hook_periodic, (UInt64)this);
+      if (m_save_marker)
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_MAGIC_MARKER, CheckpointManager::hook_marker, (UInt64)this);
+   }
+
+   if (isRestoring())
+      readHeader();
+}
+
+SInt64
+CheckpointManager::hook_marker(UInt64 self, UInt64 arg)
+{
+   MagicServer::MagicMarkerType *marker = (MagicServer::MagicMarkerType *)arg;
+   ((CheckpointManager*)self)->marker(marker->arg0);
+   return 0;
+}
+
+void
+CheckpointManager::marker(UInt64 arg0)
+{
+   // Markers are called from application threads while other cores are still running,
+   // delay the checkpoint until the next barrier when all cores are stopped
+   if (arg0 == m_save_marker && !m_saved)
+      m_save_pending = true;
+}
+
+void
+CheckpointManager::periodic(SubsecondTime time)
+{
+   if (m_saved)
+      return;
+   if (m_save_pending || (m_save_time > SubsecondTime::Zero() && time >= m_save_time))
+      save(time);
+}
+
+void
+CheckpointManager::save(SubsecondTime time)
+{
+   m_saved = true;
+   m_save_pending = false;
+
+   if (mkdir(m_save_dir.c_str(), 0777) != 0 && errno != EEXIST)
+      LOG_PRINT_ERROR("Cannot create checkpoint directory %s: %s", m_save_dir.c_str(), strerror(errno));
+
+   String filename = m_save_dir + "/checkpoint.dat";
+   FILE *fp = fopen(filename.c_str(), "w");
+   LOG_ASSERT_ERROR(fp, "Cannot write checkpoint file %s", filename.c_str());
+
+   fprintf(fp, "version %u\n", VERSION);
+   fprintf(fp, "time %" PRIu64 "\n", time.getFS());
+
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      fprintf(fp, "core %u %" PRIu64 " %" PRIu64 "\n", core_id, core->getInstructionCount(), core->getPerformanceModel()->getElapsedTime().getFS());
+   }
+
+   for(int bank = 0; bank < Sim()->getCfg()->getInt("memory/num_banks"); ++bank)
+      fprintf(fp, "bank %d %" PRIu64 "\n", bank, Sim()->m_bank_modes[bank]);
+
+   UInt64 num_lines = 0;
+   std::vector<MemoryManagerBase::CheckpointLine> lines;
+   for(UInt32 core_id = 0; core_id < Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      lines.clear();
+      Sim()->getCoreManager()->getCoreFromID(core_id)->getMemoryManager()->getCheckpointLines(lines);
+      for(std::vector<MemoryManagerBase::CheckpointLine>::iterator it = lines.begin(); it != lines.end(); ++it)
+         fprintf(fp, "line %u %d %" PRIxPTR " %d\n", core_id, it->mem_component, it->address, it->dirty);
+      num_lines += lines.size();
+   }
+
+   fclose(fp);
+
+   printf("[CHECKPOINT] Saved %" PRIu64 " cache lines at %" PRIu64 " ns to %s\n", num_lines, time.getNS(), m_save_dir.c_str());
+
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_CHECKPOINT_SAVE, (UInt64)m_save_dir.c_str());
+}
+
+void
+CheckpointManager::readHeader()
+{
+   String filename = m_restore_dir + "/checkpoint.dat";
+   FILE *fp = fopen(filename.c_str(), "r");
+   LOG_ASSERT_ERROR(fp, "Cannot read checkpoint file %s", filename.c_str());
+
+   char key[16];
+   while (fscanf(fp, "%15s", key) == 1)
+   {
+      if (strcmp(key, "version") == 0)
+      {
+         UInt32 version = 0;
+         LOG_ASSERT_ERROR(fscanf(fp, "%u", &version) == 1 && version == VERSION, "Unsupported checkpoint version in %s", filename.c_str());
+      }
+      else if (strcmp(key, "time") == 0)
+      {
+         UInt64 time_fs = 0;
+         LOG_ASSERT_ERROR(fscanf(fp, "%" SCNu64, &time_fs) == 1, "Invalid checkpoint file %s", filename.c_str());
+         m_restore_time = SubsecondTime::FS(time_fs);
+      }
+      else if (strcmp(key, "core") == 0)
+      {
+         UInt32 core_id = 0;
+         UInt64 instructions = 0, elapsed_fs = 0;
+         LOG_ASSERT_ERROR(fscanf(fp, "%u %" SCNu64 " %" SCNu64, &core_id, &instructions, &elapsed_fs) == 3, "Invalid checkpoint file %s", filename.c_str());
+         LOG_ASSERT_ERROR(core_id < m_restore_cpis.size(), "Checkpoint %s was taken with more cores than this configuration has", filename.c_str());
+         if (instructions)
+            m_restore_cpis[core_id] = SubsecondTime::FS(elapsed_fs / instructions);
+      }
+      else
+         // Header is complete
+         break;
+   }
+
+   fclose(fp);
+}
+
+void
+CheckpointManager::restore()
+{
+   String filename = m_restore_dir + "/checkpoint.dat";
+   FILE *fp = fopen(filename.c_str(), "r");
+   LOG_ASSERT_ERROR(fp, "Cannot read checkpoint file %s", filename.c_str());
+
+   UInt64 num_lines = 0;
+   char key[16];
+   while (fscanf(fp, "%15s", key) == 1)
+   {
+      if (strcmp(key, "bank") == 0)
+      {
+         int bank = 0;
+         UInt64 mode = 0;
+         LOG_ASSERT_ERROR(fscanf(fp, "%d %" SCNu64, &bank, &mode) == 2, "Invalid checkpoint file %s", filename.c_str());
+         if (bank < Sim()->getCfg()->getInt("memory/num_banks"))
+            Sim()->m_bank_modes[bank] = mode;
+      }
+      else if (strcmp(key, "line") == 0)
+      {
+         UInt32 core_id = 0;
+         int mem_component = 0, dirty = 0;
+         IntPtr address = 0;
+         LOG_ASSERT_ERROR(fscanf(fp, "%u %d %" SCNxPTR " %d", &core_id, &mem_component, &address, &dirty) == 4, "Invalid checkpoint file %s", filename.c_str());
+         if (core_id >= Sim()->getConfig()->getApplicationCores())
+            continue;
+         // Replay the line as an access from its core, so it travels through the coherence protocol.
+         // With a different cache configuration, this warms the new hierarchy as well as possible.
+         Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+         core->getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_USER_THREAD, core->getPerformanceModel()->getElapsedTime());
+         core->getMemoryManager()->coreInitiateMemoryAccess(
+               mem_component == MemComponent::L1_ICACHE ? MemComponent::L1_ICACHE : MemComponent::L1_DCACHE,
+               Core::NONE, dirty ? Core::WRITE : Core::READ,
+               address, 0, NULL, core->getMemoryManager()->getCacheBlockSize(),
+               Core::MEM_MODELED_NONE);
+         ++num_lines;
+      }
+      else
+      {
+         // Header fields were handled by readHeader(), skip the rest of the line
+         int c;
+         while ((c = fgetc(fp)) != EOF && c != '\n') ;
+      }
+   }
+
+   fclose(fp);
+
+   printf("[CHECKPOINT] Restored %" PRIu64 " cache lines at %" PRIu64 " ns from %s\n", num_lines, m_restore_time.getNS(), m_restore_dir.c_str());
+
+   Sim()->getStatsManager()->recordStats("checkpoint");
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_CHECKPOINT_RESTORE, (UInt64)m_restore_dir.c_str());
+}
@@ -0,0 +1,57 @@
+#ifndef __CHECKPOINT_MANAGER_H
+#define __CHECKPOINT_MANAGER_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <vector>
+
+// Warm-state checkpoints
+//
+// A checkpoint is taken at a given time or magic marker, at the first barrier after it. It stores per core the
+// instruction count and elapsed time, the contents of all caches and the DRAM bank power modes. Scripts save their
+// own state (e.g. the HotSpot temperature vectors in memTherm_core.py) from HOOK_CHECKPOINT_SAVE.
+//
+// A run restoring a checkpoint, possibly with a different policy configuration, fast-forwards to the checkpoint time
+// at the per-core CPI of the checkpointed prefix (CheckpointRestoreSampling). It then replays the cache contents
+// through the memory hierarchy, which keeps the coherence directories consistent, restores the bank modes, calls
+// HOOK_CHECKPOINT_RESTORE and continues in detailed mode. A statistics snapshot named "checkpoint" marks the restore.
+// Scheduler state is not stored: the scheduler runs through the fast-forwarded prefix, and rebuilds it.
+
+class CheckpointManager
+{
+   public:
+      CheckpointManager();
+
+      bool isRestoring() const { return m_restore_dir != ""; }
+      SubsecondTime getRestoreTime() const { return m_restore_time; }
+      // Fast-forward CPI per core, zero for cores that had not executed any instructions
+      SubsecondTime getRestoreCPI(core_id_t core_id) const { return m_restore_cpis.at(core_id); }
+
+      // Called by CheckpointRestoreSampling once the checkpoint time has been reached
+      void restore();
+
+   private:
+      static const UInt32 VERSION = 1;
+
+      SubsecondTime m_save_time;
+      UInt64 m_save_marker;
+      String m_save_dir;
+      bool m_save_pending;
+      bool m_saved;
+
+      String m_restore_dir;
+      SubsecondTime m_restore_time;
+      std::vector<SubsecondTime> m_restore_cpis;
+
+      void save(SubsecondTime time);
+      void readHeader();
+
+      void periodic(SubsecondTime time);
+      void marker(UInt64 arg0);
+
+      static SInt64 hook_periodic(UInt64 self, UInt64 time) { subsecond_time_t t; t.m_time = time; ((CheckpointManager*)self)->periodic(t); return 0; }
+      static SInt64 hook_marker(UInt64 self, UInt64 arg);
+};
+
+#endif // __CHECKPOINT_MANAGER_H
@@ -0,0 +1,116 @@
+#include "hook_executor.h"
+#include "log.h"
+
+#include <unistd.h>
+
+HookExecutor::HookExecutor(UInt32 num_workers)
+   : m_remaining(0)
+   , m_running_workers(num_workers)
+   , m_quit(false)
+   , m_pipelined(false)
+   , m_tls_task(TLS::create())
+{
+   for(UInt32 i = 0; i < num_workers; ++i)
+   {
+      Worker *worker = new Worker(this);
+      m_workers.push_back(worker);
+      worker->spawn();
+   }
+}
+
+HookExecutor::~HookExecutor()
+{
+   wait();
+
+   m_lock.acquire();
+   m_quit = true;
+   m_cond_work.broadcast();
+   m_lock.release();
+
+   // Workers are not joinable on all front-ends, wait for them to leave workerLoop()
+   while (*const_cast<volatile UInt32*>(&m_running_workers) > 0)
+      usleep(100);
+
+   for(std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+      delete *it;
+   delete m_tls_task;
+}
+
+void
+HookExecutor::submit(const std::vector<Task> &tasks, bool pipelined)
+{
+   wait();
+
+   ScopedLock sl(m_lock);
+   m_tasks = tasks;
+   m_pipelined = pipelined;
+   m_remaining = m_tasks.size();
+   for(UInt32 task_id = 0; task_id < m_tasks.size(); ++task_id)
+      if (m_tasks[task_id].num_dependencies == 0)
+         m_ready.push_back(task_id);
+   LOG_ASSERT_ERROR(m_remaining == 0 || m_ready.size() > 0, "Circular dependency between hooks");
+   m_cond_work.broadcast();
+}
+
+void
+HookExecutor::wait()
+{
+   ScopedLock sl(m_lock);
+   while (m_remaining > 0)
+   {
+      // Help out instead of just waiting
+      if (m_ready.size())
+      {
+         UInt32 task_id = m_ready.front();
+         m_ready.pop_front();
+         execute(task_id);
+      }
+      else
+         m_cond_done.wait(m_lock);
+   }
+}
+
+void
+HookExecutor::workerLoop()
+{
+   ScopedLock sl(m_lock);
+   while (!m_quit)
+   {
+      if (m_ready.size())
+      {
+         UInt32 task_id = m_ready.front();
+         m_ready.pop_front();
+         execute(task_id);
+      }
+      else
+         m_cond_work.wait(m_lock);
+   }
+   --m_running_workers;
+}
+
+void
+HookExecutor::execute(UInt32 task_id)
+{
+   Task &task = m_tasks[task_id];
+
+   m_tls_task->setInt(m_pipelined ? TASK_PIPELINED : TASK_WAITED);
+   m_lock.release();
+   task.func(task.arg, task.argument);
+   m_lock.acquire();
+   m_tls_task->setInt(TASK_NONE);
+
+   bool new_work = false;
+   for(std::vector<UInt32>::iterator it = task.dependents.begin(); it != task.dependents.end(); ++it)
+   {
+      if (--m_tasks[*it].num_dependencies == 0)
+      {
+         m_ready.push_back(*it);
+         new_work = true;
+      }
+   }
+   if (new_work)
+      m_cond_work.broadcast();
+
+   if (--m_remaining == 0)
+      m_cond_done.broadcast();
+}
@@ -0,0 +1,75 @@
+#ifndef __HOOK_EXECUTOR_H
+#define __HOOK_EXECUTOR_H
+
+#include "fixed_types.h"
+#include "_thread.h"
+#include "lock.h"
+#include "cond.h"
+#include "tls.h"
+
+#include <vector>
+#include <deque>
+
+// Worker pool that runs a batch of independent hook callbacks concurrently. A task only starts once
+// all tasks it depends on (within the same batch) have completed. The thread that submitted the batch
+// helps executing tasks while it waits.
+class HookExecutor
+{
+   public:
+      typedef SInt64 (*TaskFunc)(UInt64, UInt64);
+
+      struct Task {
+         TaskFunc func;
+         UInt64 arg;
+         UInt64 argument;
+         std::vector<UInt32> dependents;   // indices of tasks that wait for this one
+         UInt32 num_dependencies;
+         Task(TaskFunc _func, UInt64 _arg, UInt64 _argument) : func(_func), arg(_arg), argument(_argument), num_dependencies(0) {}
+      };
+
+      HookExecutor(UInt32 num_workers);
+      ~HookExecutor();
+
+      // Start executing a batch, tasks[i].dependents must be set up. Waits for the previous batch first.
+      // A pipelined batch is not waited for by the caller, it overlaps with simulation.
+      void submit(const std::vector<Task> &tasks, bool pipelined = false);
+      // Wait until the current batch has completed
+      void wait();
+      bool busy() const { return __atomic_load_n(&m_remaining, __ATOMIC_ACQUIRE) > 0; }
+      // Is the calling thread executing a task, or a task of a pipelined batch
+      bool inTask() const { return m_tls_task->getInt() != TASK_NONE; }
+      bool inPipelinedTask() const { return m_tls_task->getInt() == TASK_PIPELINED; }
+
+   private:
+      class Worker : public Runnable
+      {
+         public:
+            Worker(HookExecutor *executor) : m_executor(executor), m_thread(NULL) {}
+            ~Worker() { delete m_thread; }
+            void spawn() { m_thread = _Thread::create(this); m_thread->run(); }
+            void run() { m_executor->workerLoop(); }
+         private:
+            HookExecutor *m_executor;
+            _Thread *m_thread;
+      };
+
+      std::vector<Worker*> m_workers;
+      std::vector<Task> m_tasks;
+      std::deque<UInt32> m_ready;
+      UInt32 m_remaining;
+      UInt32 m_running_workers;
+      bool m_quit;
+      bool m_pipelined;
+      enum { TASK_NONE, TASK_WAITED, TASK_PIPELINED };
+      TLS *m_tls_task;
+
+      Lock m_lock;
+      ConditionVariable m_cond_work;
+      ConditionVariable m_cond_done;
+
+      void workerLoop();
+      // Called with m_lock held, releases it while running the task
+      void execute(UInt32 task_id);
+};
+
+#endif // __HOOK_EXECUTOR_H
@@ -1,6 +1,10 @@
 #include "hooks_manager.h"
+#include "hook_executor.h"
+#include "hooks_native.h"
 #include "log.h"
 
+#include <deque>
+
 const char* HookType::hook_type_names[] = {
    "HOOK_PERIODIC",
    "HOOK_PERIODIC_INS",
@@ -27,11 +31,18 @@ const char* HookType::hook_type_names[] = {
    "HOOK_APPLICATION_ROI_BEGIN",
    "HOOK_APPLICATION_ROI_END",
    "HOOK_SIGUSR1",
+   "HOOK_CHECKPOINT_SAVE",
+   "HOOK_CHECKPOINT_RESTORE",
 };
 static_assert(HookType::HOOK_TYPES_MAX == sizeof(HookType::hook_type_names) / sizeof(HookType::hook_type_names[0]),
               "Not enough values in HookType::hook_type_names");
 
 HooksManager::HooksManager()
+   : m_executor(NULL)
+   , m_tls_independent(TLS::create())
+   , m_pipelined(false)
+   , m_parallel_batches(0)
+   , m_pipelined_waits(0)
 {
 }
 
@@ -40,20 +51,150 @@ void HooksManager::registerHook(HookType::hook_type_t type, HookCallbackFunc fun
    m_registry[type].push_back(HookCallback(func, argument, order));
 }
 
+void HooksManager::registerIndependentHook(HookType::hook_type_t type, HookCallbackFunc func, UInt64 argument, String name, HookCallbackOrder order, bool pipelined)
+{
+   LOG_ASSERT_ERROR(type == HookType::HOOK_PERIODIC, "Only HOOK_PERIODIC callbacks can be registered as independent");
+   HookCallback callback(func, argument, order);
+   callback.name = name;
+   callback.independent = true;
+   callback.pipelined = pipelined;
+   m_registry[type].push_back(callback);
+}
+
+void HooksManager::addHookDependency(HookType::hook_type_t type, String name, String after)
+{
+   for(std::vector<HookCallback>::iterator it = m_registry[type].begin(); it != m_registry[type].end(); ++it)
+   {
+      if (it->independent && it->name == name)
+      {
+         it->after.push_back(after);
+         return;
+      }
+   }
+   LOG_PRINT_ERROR("Cannot add dependency to unknown hook %s", name.c_str());
+}
+
 SInt64 HooksManager::callHooks(HookType::hook_type_t type, UInt64 arg, bool expect_return)
 {
+   // Pipelined callbacks of the previous interval must complete before this interval's callbacks start
+   if (m_executor && type == HookType::HOOK_PERIODIC && m_executor->busy())
+   {
+      ++m_pipelined_waits;
+      m_executor->wait();
+   }
+
+   std::vector<HookCallback*> independent, pipelined;
    for(unsigned int order = 0; order < NUM_HOOK_ORDER; ++order)
    {
       for(std::vector<HookCallback>::iterator it = m_registry[type].begin(); it != m_registry[type].end(); ++it)
       {
          if (it->order == (HookCallbackOrder)order)
          {
+            if (it->independent && !expect_return)
+            {
+               if (it->pipelined && m_pipelined)
+                  pipelined.push_back(&*it);
+               else
+                  independent.push_back(&*it);
+               continue;
+            }
+
+            // A callback that was not declared independent sees the effects of all callbacks registered before it
+            if (independent.size())
+            {
+               callIndependentHooks(independent, arg, true);
+               independent.clear();
+            }
+
             SInt64 result = it->func(it->arg, arg);
             if (expect_return && result != -1)
                return result;
          }
       }
+      if (independent.size())
+      {
+         callIndependentHooks(independent, arg, true);
+         independent.clear();
+      }
+   }
+
+   if (pipelined.size())
+   {
+      // Pipelined callbacks read statistics as they are now, not as the cores advance
+      if (m_executor)
+         HooksNative::snapshotStats();
+      callIndependentHooks(pipelined, arg, false);
    }
 
    return -1;
 }
+
+bool HooksManager::inIndependentHook() const
+{
+   return m_tls_independent->getInt() || (m_executor && m_executor->inTask());
+}
+
+bool HooksManager::inPipelinedHook() const
+{
+   return m_executor && m_executor->inPipelinedTask();
+}
+
+void HooksManager::callIndependentHooks(const std::vector<HookCallback*> &callbacks, UInt64 arg, bool wait)
+{
+   if (callbacks.size() == 1 && (wait || !m_executor))
+   {
+      m_tls_independent->setInt(true);
+      callbacks[0]->func(callbacks[0]->arg, arg);
+      m_tls_independent->setInt(false);
+      return;
+   }
+
+   std::vector<HookExecutor::Task> tasks;
+   for(std::vector<HookCallback*>::const_iterator it = callbacks.begin(); it != callbacks.end(); ++it)
+      tasks.push_back(HookExecutor::Task((*it)->func, (*it)->arg, arg));
+
+   // Dependencies on callbacks outside of this batch were already satisfied by running them first
+   for(UInt32 task_id = 0; task_id < callbacks.size(); ++task_id)
+   {
+      for(std::vector<String>::const_iterator after = callbacks[task_id]->after.begin(); after != callbacks[task_id]->after.end(); ++after)
+      {
+         for(UInt32 other_id = 0; other_id < callbacks.size(); ++other_id)
+         {
+            if (callbacks[other_id]->name == *after)
+            {
+               tasks[other_id].dependents.push_back(task_id);
+               ++tasks[task_id].num_dependencies;
+            }
+         }
+      }
+   }
+
+   if (!m_executor)
+   {
+      // Run serially, in registration order except where a dependency points to a later callback
+      std::deque<UInt32> ready;
+      for(UInt32 task_id = 0; task_id < tasks.size(); ++task_id)
+         if (tasks[task_id].num_dependencies == 0)
+            ready.push_back(task_id);
+      UInt32 done = 0;
+      while (ready.size())
+      {
+         UInt32 task_id = ready.front();
+         ready.pop_front();
+         m_tls_independent->setInt(true);
+         tasks[task_id].func(tasks[task_id].arg, tasks[task_id].argument);
+         m_tls_independent->setInt(false);
+         ++done;
+         for(std::vector<UInt32>::iterator it = tasks[task_id].dependents.begin(); it != tasks[task_id].dependents.end(); ++it)
+            if (--tasks[*it].num_dependencies == 0)
+               ready.push_back(*it);
+      }
+      LOG_ASSERT_ERROR(done == tasks.size(), "Circular dependency between hooks");
+      return;
+   }
+
+   ++m_parallel_batches;
+   m_executor->submit(tasks, !wait);
+   if (wait)
+      m_executor->wait();
+}
@@ -4,10 +4,13 @@
 #include "fixed_types.h"
 #include "subsecond_time.h"
 #include "thread_manager.h"
+#include "tls.h"
 
 #include <vector>
 #include <unordered_map>
 
+class HookExecutor;
+
 class HookType
 {
 public:
@@ -38,6 +41,8 @@ public:
       HOOK_APPLICATION_ROI_BEGIN, // none                            ROI begin, always triggers
       HOOK_APPLICATION_ROI_END,   // none                            ROI end, always triggers
       HOOK_SIGUSR1,             // none                              Sniper process received SIGUSR1
+      HOOK_CHECKPOINT_SAVE,     // const char * directory            Checkpoint is being written (save script state now)
+      HOOK_CHECKPOINT_RESTORE,  // const char * directory            Checkpoint was restored, continuing in detailed mode
       HOOK_TYPES_MAX
    };
    static const char* hook_type_names[];
@@ -68,7 +73,11 @@ public:
       HookCallbackFunc func;
       UInt64 arg;
       HookCallbackOrder order;
-      HookCallback(HookCallbackFunc _func, UInt64 _arg, HookCallbackOrder _order) : func(_func), arg(_arg), order(_order) {}
+      String name;
+      bool independent;                // Does not touch simulator state used by other hooks, can run on a worker thread
+      bool pipelined;                  // May overlap with simulation of the next interval (HOOK_PERIODIC only)
+      std::vector<String> after;       // Names of independent callbacks of the same order that must complete first
+      HookCallback(HookCallbackFunc _func, UInt64 _arg, HookCallbackOrder _order) : func(_func), arg(_arg), order(_order), independent(false), pipelined(false) {}
    };
    typedef struct {
       thread_id_t thread_id;
@@ -98,10 +107,30 @@ public:
    void init();
    void fini();
    void registerHook(HookType::hook_type_t type, HookCallbackFunc func, UInt64 argument, HookCallbackOrder order = ORDER_NOTIFY_PRE);
+   // Register a HOOK_PERIODIC callback that is independent of all other hooks, unless declared with addHookDependency.
+   // With hooks/parallel/workers > 0, consecutive independent callbacks of the same order run concurrently on worker
+   // threads. The thread that reached the barrier holds the thread lock until they have all completed.
+   // Pipelined callbacks (with hooks/parallel/pipelined = true) are only waited for at the next HOOK_PERIODIC.
+   // They run without the thread lock while cores simulate the next interval, so they must not change simulator
+   // state; statistics read through the plugin API are those of the barrier that started them.
+   // Only callbacks that read simulator state qualify: the scheduler, which migrates threads and changes DVFS,
+   // is an ordinary ORDER_ACTION hook. Built-in independent callback: "thermal" (memTherm_core.py, ORDER_NOTIFY_PRE).
+   void registerIndependentHook(HookType::hook_type_t type, HookCallbackFunc func, UInt64 argument, String name, HookCallbackOrder order = ORDER_NOTIFY_PRE, bool pipelined = false);
+   void addHookDependency(HookType::hook_type_t type, String name, String after);
    SInt64 callHooks(HookType::hook_type_t type, UInt64 argument, bool expect_return = false);
+   // Is the calling thread running an independent callback, or a pipelined one
+   bool inIndependentHook() const;
+   bool inPipelinedHook() const;
 
 private:
    std::unordered_map<HookType::hook_type_t, std::vector<HookCallback> > m_registry;
+
+   HookExecutor *m_executor;
+   TLS *m_tls_independent;    // Set while an independent callback runs on the calling thread, outside of m_executor
+   bool m_pipelined;
+   UInt64 m_parallel_batches;
+   UInt64 m_pipelined_waits;
+   void callIndependentHooks(const std::vector<HookCallback*> &callbacks, UInt64 argument, bool wait);
 };
 
 #endif /* __HOOKS_MANAGER_H */
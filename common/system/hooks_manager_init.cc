@@ -1,12 +1,15 @@
 #include "hooks_manager.h"
 
 #include "hooks_py.h"
+#include "hooks_native.h"
 
 #include "subsecond_time.h"
 #include "fixed_point.h"
 #include "simulator.h"
 #include "stats.h"
 #include "dvfs_manager.h"
+#include "hook_executor.h"
+#include "config.hpp"
 
 
 // Example live-analysis code: print out the IPC for core 0
@@ -43,11 +46,25 @@ void hook_print_core0_ipc(void*, subsecond_time_t _time)
 // Handy place to instantiate all classes that need to register hooks but are otherwise unconnected to the basic simulator
 void HooksManager::init(void)
 {
+   UInt32 workers = Sim()->getCfg()->getInt("hooks/parallel/workers");
+   m_pipelined = Sim()->getCfg()->getBool("hooks/parallel/pipelined");
+   if (workers > 0)
+      m_executor = new HookExecutor(workers);
+   registerStatsMetric("hooks", 0, "parallel-batches", &m_parallel_batches);
+   registerStatsMetric("hooks", 0, "pipelined-waits", &m_pipelined_waits);
+
    HooksPy::init();
+   HooksNative::init();
    //registerHook(HookType::HOOK_PERIODIC, (HookCallbackFunc)hook_print_core0_ipc, NULL);
 }
 
 void HooksManager::fini(void)
 {
+   if (m_executor)
+   {
+      delete m_executor;
+      m_executor = NULL;
+   }
+   HooksNative::fini();
    HooksPy::fini();
 }
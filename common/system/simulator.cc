@@ -18,6 +18,7 @@
 #include "dvfs_manager.h"
 #include "hooks_manager.h"
 #include "sampling_manager.h"
+#include "checkpoint_manager.h"
 #include "fault_injection.h"
 #include "routine_tracer.h"
 #include "instruction.h"
@@ -122,6 +123,7 @@ Simulator::Simulator()
    , m_dvfs_manager(NULL)
    , m_hooks_manager(NULL)
    , m_sampling_manager(NULL)
+   , m_checkpoint_manager(NULL)
    , m_faultinjection_manager(NULL)
    , m_rtn_tracer(NULL)
    , m_memory_tracker(NULL)
@@ -156,6 +158,7 @@ void Simulator::start()
    }
 
    m_sim_thread_manager = new SimThreadManager();
+   m_checkpoint_manager = new CheckpointManager();
    m_sampling_manager = new SamplingManager();
    m_fastforward_performance_manager = FastForwardPerformanceManager::create();
    m_rtn_tracer = RoutineTracer::create();
@@ -252,6 +255,7 @@ Simulator::~Simulator()
    // Don't remove the trace manager as threads could still be alive even if they are done
    //delete m_trace_manager;             m_trace_manager = NULL;
    delete m_sampling_manager;          m_sampling_manager = NULL;
+   delete m_checkpoint_manager;        m_checkpoint_manager = NULL;
    if (m_faultinjection_manager)
    {
       delete m_faultinjection_manager; m_faultinjection_manager = NULL;
@@ -1,13 +1,24 @@
 #include <string.h>
 
 #include "smtransport.h"
+#include "simulator.h"
 #include "config.h"
+#include "config.hpp"
 #include "log.h"
 
 // -- SmTransport -- //
 
 SmTransport::SmTransport()
+   : m_ring_enabled(Sim()->getCfg()->getString("transport/type") == "ring")
+   , m_ring_slots(Sim()->getCfg()->getInt("transport/ring/slots"))
+   , m_ring_slot_size(Sim()->getCfg()->getInt("transport/ring/slot_size"))
 {
+   String type = Sim()->getCfg()->getString("transport/type");
+   LOG_ASSERT_ERROR(type == "queue" || type == "ring", "Unknown transport/type %s", type.c_str());
+   if (m_ring_enabled)
+      LOG_ASSERT_ERROR(m_ring_slots > 0 && (m_ring_slots & (m_ring_slots - 1)) == 0,
+                       "transport/ring/slots must be a power of two");
+
    m_global_node = new SmNode(-1, this);
    m_core_nodes = new SmNode* [ Config::getSingleton()->getTotalCores() ];
    for (UInt32 i = 0; i < Config::getSingleton()->getTotalCores(); i++)
@@ -64,17 +75,126 @@ void SmTransport::clearNodeForId(core_id_t core_id)
       m_core_nodes[core_id] = NULL;
 }
 
+// -- Ring -- //
+
+// Bounded queue after Dmitry Vyukov: each slot carries a sequence number that tells
+// producers and the consumer whose turn it is, so slots are claimed with a single CAS.
+
+SmTransport::Ring::Ring(UInt32 num_slots, UInt32 slot_size)
+   : m_mask(num_slots - 1)
+   , m_slot_size(slot_size)
+   , m_buffer_size(UInt64(num_slots) * slot_size)
+   , m_enqueue_pos(0)
+   , m_dequeue_pos(0)
+{
+   m_slots = new Slot[num_slots];
+   m_buffer = new Byte[m_buffer_size];
+   for (UInt32 i = 0; i < num_slots; i++)
+      m_slots[i].sequence = i;
+}
+
+SmTransport::Ring::~Ring()
+{
+   while (Byte *data = peek())
+      release(data);
+   delete [] m_slots;
+   delete [] m_buffer;
+}
+
+Byte* SmTransport::Ring::reserve(UInt32 length)
+{
+   if (length > m_slot_size)
+      return NULL;
+
+   UInt64 pos = m_enqueue_pos;
+   Slot *slot;
+
+   while (true)
+   {
+      slot = &m_slots[pos & m_mask];
+      SInt64 diff = SInt64(slot->sequence - pos);
+      if (diff == 0)
+      {
+         if (__sync_bool_compare_and_swap(&m_enqueue_pos, pos, pos + 1))
+            break;
+      }
+      else if (diff < 0)
+      {
+         // The consumer has not yet released this slot from the previous round
+         return NULL;
+      }
+      pos = m_enqueue_pos;
+   }
+
+   // The slot stays invisible to the consumer until commit()
+   return m_buffer + (pos & m_mask) * m_slot_size;
+}
+
+void SmTransport::Ring::commit(Byte *buffer)
+{
+   Slot *slot = getSlot(buffer);
+
+   // We own the slot, its sequence still holds the position we claimed
+   __sync_synchronize();
+   slot->sequence = slot->sequence + 1;
+}
+
+bool SmTransport::Ring::contains(const Byte *buffer) const
+{
+   return buffer >= m_buffer && buffer < m_buffer + m_buffer_size;
+}
+
+SmTransport::Ring::Slot* SmTransport::Ring::getSlot(const Byte *buffer) const
+{
+   LOG_ASSERT_ERROR(contains(buffer) && (buffer - m_buffer) % m_slot_size == 0, "Buffer %p is not a ring slot", buffer);
+   return &m_slots[(buffer - m_buffer) / m_slot_size];
+}
+
+Byte* SmTransport::Ring::peek()
+{
+   Slot *slot = &m_slots[m_dequeue_pos & m_mask];
+   if (slot->sequence != m_dequeue_pos + 1)
+      return NULL;
+   __sync_synchronize();
+   return m_buffer + (m_dequeue_pos & m_mask) * m_slot_size;
+}
+
+bool SmTransport::Ring::empty() const
+{
+   return m_enqueue_pos == m_dequeue_pos;
+}
+
+void SmTransport::Ring::release(Byte *buffer)
+{
+   Slot *slot = &m_slots[m_dequeue_pos & m_mask];
+   LOG_ASSERT_ERROR(slot == getSlot(buffer), "Ring slots must be released in order");
+
+   // Hand the slot to the producers of the next round
+   __sync_synchronize();
+   slot->sequence = m_dequeue_pos + m_mask + 1;
+   m_dequeue_pos++;
+}
+
 // -- SmTransportNode -- //
 
 SmTransport::SmNode::SmNode(core_id_t core_id, SmTransport *smt)
    : Node(core_id)
+   , m_ring(smt->m_ring_enabled ? new Ring(smt->m_ring_slots, smt->m_ring_slot_size) : NULL)
+   , m_overflowed(false)
+   , m_sleeping(false)
    , m_smt(smt)
 {
 }
 
 SmTransport::SmNode::~SmNode()
 {
-   LOG_ASSERT_WARNING(m_queue.empty(), "Unread messages in queue for core: %d", getCoreId());
+   LOG_ASSERT_WARNING(m_queue.empty() && (!m_ring || !m_ring->peek()), "Unread messages in queue for core: %d", getCoreId());
+   while (!m_queue.empty())
+   {
+      delete [] m_queue.front();
+      m_queue.pop();
+   }
+   delete m_ring;
    m_smt->clearNodeForId(getCoreId());
 }
 
@@ -93,21 +213,131 @@ void SmTransport::SmNode::send(SInt32 dest_id, const void* buffer, UInt32 length
 
 void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 length)
 {
-   Byte *data = new Byte[length];
+   Byte *data = reserve(dest_node, length);
    memcpy(data, buffer, length);
+   commit(dest_node, data, length);
+}
+
+Byte* SmTransport::SmNode::reserve(SInt32 dest_id, UInt32 length)
+{
+   SmNode *dest_node = m_smt->getNodeFromId(dest_id);
+   LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
+   return reserve(dest_node, length);
+}
 
-   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, dest_node);
+void SmTransport::SmNode::commit(SInt32 dest_id, Byte *buffer, UInt32 length)
+{
+   SmNode *dest_node = m_smt->getNodeFromId(dest_id);
+   LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
+   commit(dest_node, buffer, length);
+}
+
+Byte* SmTransport::SmNode::reserve(SmNode *dest_node, UInt32 length)
+{
+   if (dest_node->m_ring && !dest_node->m_overflowed)
+   {
+      Byte *data = dest_node->m_ring->reserve(length);
+      if (data)
+         return data;
+   }
+
+   // Queue mode, or the message goes through the overflow queue
+   return new Byte[length];
+}
+
+void SmTransport::SmNode::commit(SmNode *dest_node, Byte *buffer, UInt32 length)
+{
+   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, buffer, dest_node);
+
+   if (dest_node->m_ring)
+   {
+      if (dest_node->m_ring->contains(buffer))
+      {
+         dest_node->m_ring->commit(buffer);
+      }
+      else
+      {
+         dest_node->m_lock.acquire();
+         dest_node->m_overflowed = true;
+         dest_node->m_queue.push(buffer);
+         dest_node->m_lock.release();
+      }
+
+      dest_node->wakeup();
+      return;
+   }
 
    dest_node->m_lock.acquire();
-   dest_node->m_queue.push(data);
+   dest_node->m_queue.push(buffer);
    dest_node->m_lock.release();
    dest_node->m_cond.broadcast();
 }
 
+void SmTransport::SmNode::wakeup()
+{
+   // Pairs with the barrier in recv(): either the consumer sees our message when it
+   // checks before going to sleep, or we see it sleeping and wake it up
+   __sync_synchronize();
+   if (m_sleeping)
+   {
+      // Wait until the consumer is inside m_cond.wait()
+      m_lock.acquire();
+      m_lock.release();
+      m_cond.broadcast();
+   }
+}
+
+Byte* SmTransport::SmNode::tryRecv()
+{
+   Byte *data = m_ring->peek();
+   if (data)
+      return data;
+
+   if (m_overflowed)
+   {
+      ScopedLock sl(m_lock);
+
+      // Look at the ring again: a sender may have filled it before overflowing.
+      // Slots that are claimed but not yet committed hold older messages too, their commit wakes us up.
+      data = m_ring->peek();
+      if (data || !m_ring->empty())
+         return data;
+
+      data = m_queue.front();
+      m_queue.pop();
+      if (m_queue.empty())
+         m_overflowed = false;
+      return data;
+   }
+
+   return NULL;
+}
+
 Byte* SmTransport::SmNode::recv()
 {
    LOG_PRINT("attempting recv -- this: %p", this);
 
+   if (m_ring)
+   {
+      while (true)
+      {
+         Byte *data = tryRecv();
+         if (data)
+         {
+            LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
+            return data;
+         }
+
+         m_lock.acquire();
+         m_sleeping = true;
+         __sync_synchronize();
+         if (!m_ring->peek() && (!m_overflowed || !m_ring->empty()))
+            m_cond.wait(m_lock);
+         m_sleeping = false;
+         m_lock.release();
+      }
+   }
+
    m_lock.acquire();
 
    while (true)
@@ -129,8 +359,19 @@ Byte* SmTransport::SmNode::recv()
    }
 }
 
+void SmTransport::SmNode::release(Byte *buffer)
+{
+   if (m_ring && m_ring->contains(buffer))
+      m_ring->release(buffer);
+   else
+      delete [] buffer;
+}
+
 bool SmTransport::SmNode::query()
 {
+   if (m_ring)
+      return m_ring->peek() || (m_overflowed && m_ring->empty());
+
    bool result = false;
 
    m_lock.acquire();
@@ -12,6 +12,43 @@ public:
    SmTransport();
    ~SmTransport();
 
+   // Bounded multi-producer, single-consumer ring of preallocated message slots.
+   // Producers reserve a slot, serialize their message into it and commit it,
+   // the consumer is handed the slot itself and gives it back through release().
+   class Ring
+   {
+   public:
+      Ring(UInt32 num_slots, UInt32 slot_size);
+      ~Ring();
+
+      // Returns NULL if the ring is full or the message does not fit in a slot
+      Byte* reserve(UInt32 length);
+      // Publish a slot obtained from reserve()
+      void commit(Byte *buffer);
+      bool contains(const Byte *buffer) const;
+      // Oldest message, or NULL if the ring is empty. Stays valid until release().
+      Byte* peek();
+      void release(Byte *buffer);
+      // True if no producer holds a slot, committed or not. Consumer only.
+      bool empty() const;
+
+   private:
+      struct Slot
+      {
+         volatile UInt64 sequence;
+      };
+
+      Slot* getSlot(const Byte *buffer) const;
+
+      Slot *m_slots;
+      Byte *m_buffer;
+      const UInt64 m_mask;
+      const UInt32 m_slot_size;
+      const UInt64 m_buffer_size;
+      volatile UInt64 m_enqueue_pos;
+      UInt64 m_dequeue_pos;
+   };
+
    class SmNode : public Node
    {
    public:
@@ -20,11 +57,26 @@ public:
 
       void globalSend(SInt32, const void*, UInt32);
       void send(core_id_t, const void*, UInt32);
+      Byte* reserve(core_id_t, UInt32);
+      void commit(core_id_t, Byte*, UInt32);
       Byte* recv();
+      void release(Byte *buffer);
       bool query();
 
    private:
       void send(SmNode *dest, const void *buffer, UInt32 length);
+      Byte* reserve(SmNode *dest, UInt32 length);
+      void commit(SmNode *dest, Byte *buffer, UInt32 length);
+      Byte* tryRecv();
+      void wakeup();
+
+      // Ring mode: messages that did not fit in the ring, because it was full or they are
+      // larger than a slot, go to m_queue. While it is non-empty, producers keep appending
+      // there so each sender's messages stay in order, and the consumer only serves it once the
+      // ring is empty, so messages committed to the ring before the overflow are received first.
+      Ring *m_ring;
+      volatile bool m_overflowed;
+      volatile bool m_sleeping;
 
       std::queue<Byte*> m_queue;
       Lock m_lock;
@@ -38,6 +90,11 @@ public:
    Node* getGlobalNode();
 
 private:
+   // queue: unbounded queue of heap-allocated messages, ring: bounded ring of preallocated slots
+   const bool m_ring_enabled;
+   const UInt32 m_ring_slots;
+   const UInt32 m_ring_slot_size;
+
    Node *m_global_node;
    SmNode **m_core_nodes;
 
@@ -17,7 +17,13 @@ public:
 
       virtual void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length) = 0;
       virtual void send(core_id_t dest, const void *buffer, UInt32 length) = 0;
+      // Zero-copy send: serialize the message into the buffer returned by reserve(),
+      // then pass it to commit(). Nothing else may be sent from this thread in between.
+      virtual Byte* reserve(core_id_t dest, UInt32 length) = 0;
+      virtual void commit(core_id_t dest, Byte *buffer, UInt32 length) = 0;
       virtual Byte* recv() = 0;
+      // Hand a buffer obtained from recv() back to the transport once its contents have been consumed
+      virtual void release(Byte *buffer) = 0;
       virtual bool query() = 0;
 
    protected:
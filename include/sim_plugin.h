@@ -0,0 +1,87 @@
+#ifndef __SIM_PLUGIN
+#define __SIM_PLUGIN
+
+// Native hook plugins
+//
+// A plugin is a shared object passed as a hook script (run-sniper -s plugin.so:args, or hooks/scriptNname).
+// The simulator loads it with dlopen() and calls sim_plugin_init() with a table of entry points. The plugin
+// only depends on this header: all simulator functionality is reached through the table, so plugins keep
+// working across simulator builds as long as SIM_PLUGIN_API_VERSION does not change.
+//
+// Hooks registered with register_hook run on the thread that holds the simulator's thread lock, the same
+// context as Python hooks. Independent hooks may run on a worker thread instead, while the thread holding
+// the lock waits for them; pipelined independent hooks run without the lock, see register_independent_hook.
+//
+// Build with: g++ -shared -fPIC -I$SNIPER_ROOT/include -o plugin.so plugin.cc
+
+#include <stdint.h>
+
+#define SIM_PLUGIN_API_VERSION 1
+
+// Hook types, parameter passed as the second argument of the callback
+#define SIM_PLUGIN_HOOK_PERIODIC        0  // current time in femtoseconds, called at every barrier
+#define SIM_PLUGIN_HOOK_SIM_START       1  // none
+#define SIM_PLUGIN_HOOK_SIM_END         2  // none
+#define SIM_PLUGIN_HOOK_ROI_BEGIN       3  // none
+#define SIM_PLUGIN_HOOK_ROI_END         4  // none
+#define SIM_PLUGIN_HOOK_PRE_STAT_WRITE  5  // const char * prefix
+
+#define SIM_PLUGIN_BANK_LOW_POWER       0
+#define SIM_PLUGIN_BANK_NORMAL_POWER    1
+
+#define SIM_PLUGIN_INVALID_STAT         UINT32_MAX
+
+typedef uint32_t sim_plugin_stat_t;
+typedef int64_t (*sim_plugin_hook_func_t)(void *user, uint64_t arg);
+typedef uint64_t (*sim_plugin_stat_func_t)(void *user);
+
+typedef struct {
+   uint32_t version;                      // SIM_PLUGIN_API_VERSION
+   uint32_t size;                         // sizeof(sim_plugin_api_t), fields are only ever appended
+
+   // Returns 0 on success, -1 for an unknown hook type
+   int (*register_hook)(int hook, sim_plugin_hook_func_t func, void *user);
+
+   uint32_t (*get_num_cores)(void);
+   uint32_t (*get_num_banks)(void);
+   uint64_t (*get_time)(void);            // global time in femtoseconds (last barrier)
+
+   // Statistics: resolve a handle once, read it every period. Returns SIM_PLUGIN_INVALID_STAT if not found.
+   sim_plugin_stat_t (*get_stat_handle)(const char *object_name, uint32_t index, const char *metric_name);
+   uint64_t (*get_stat)(sim_plugin_stat_t handle);
+   void (*register_stat)(const char *object_name, uint32_t index, const char *metric_name, sim_plugin_stat_func_t func, void *user);
+
+   // DVFS, in MHz. get_frequency(-1) returns the global frequency.
+   uint32_t (*get_frequency)(int32_t core_id);
+   int (*set_frequency)(int32_t core_id, uint32_t freq_mhz);  // Returns 0 on success, -1 for an invalid core
+
+   // DRAM bank power modes
+   int (*get_bank_mode)(uint32_t bank);
+   int (*set_bank_mode)(uint32_t bank, int mode);             // Returns 0 on success, -1 for an invalid bank or mode
+
+   // Periodic callbacks that only read simulator state and touch their own state. With hooks/parallel/workers > 0
+   // they run concurrently with other independent callbacks on worker threads. They must not call set_frequency
+   // or set_bank_mode: callbacks that change simulator state are registered with register_hook.
+   // Pipelined callbacks (hooks/parallel/pipelined = true) may still be running while cores simulate the next
+   // interval, and are waited for at the next barrier. They see the statistics of the barrier that started them,
+   // for handles obtained beforehand (e.g. in sim_plugin_init).
+   // Returns 0 on success.
+   int (*register_independent_hook)(const char *name, sim_plugin_hook_func_t func, void *user, int pipelined);
+   // Independent callback "name" runs after independent callback "after". Returns 0 on success.
+   int (*add_hook_dependency)(const char *name, const char *after);
+} sim_plugin_api_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Implemented by the plugin. Return 0 on success, any other value aborts the simulation.
+int sim_plugin_init(const sim_plugin_api_t *api, const char *args);
+// Optional, called at the end of the simulation
+void sim_plugin_fini(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_PLUGIN */
@@ -3,7 +3,7 @@ memTherm_core.py
 
 """
 
-import sys, os, sim
+import sys, os, sim, subprocess, time
 
 LOW_POWER = 0
 NORMAL_POWER = 1
@@ -18,6 +18,7 @@ logic_core_power = float(sim.config.get('memory/logic_core_power'))
 energy_per_refresh_access = float(sim.config.get('memory/energy_per_refresh_access'))
 sampling_interval = int(sim.config.get('hotspot/sampling_interval'))    #time in ns
 interval_sec = sampling_interval * 1e-9
+hotspot_async = sim.config.get_bool('hotspot/async')     # run McPAT and hotspot in the background, DTM sees temperatures one interval late
 timestep = sampling_interval/1000                       # in uS. Should be in sync with hotspot.config (sampling_intvl)
 t_refi = float(sim.config.get('memory/t_refi'))
 no_refesh_commands_in_t_refw = int(sim.config.get('memory/no_refesh_commands_in_t_refw'))
@@ -26,6 +27,10 @@ bank_static_power = 0
 core_thermal_enabled = sim.config.get("core_thermal/enabled")
 
 mem_dtm = sim.config.get('scheduler/open/dram/dtm')
+checkpoint_restore = sim.config.get('checkpoint/restore')
+phase_sampling = sim.config.get_bool('sampling/enabled') and sim.config.get('sampling/algorithm') == 'phase'
+dtm_core_temperature = float(sim.config.get('scheduler/open/dvfs/ondemand/dtm_cricital_temperature'))
+dtm_mem_temperature = float(sim.config.get('scheduler/open/dram/dtm/dtm_critical_temperature'))
 lpm_dynamic_power = float(sim.config.get('perf_model/dram/lowpower/lpm_dynamic_power'))
 lpm_leakage_power = float(sim.config.get('perf_model/dram/lowpower/lpm_leakage_power'))
 
@@ -309,6 +314,31 @@ class memTherm:
 
     self.sd = sim.util.StatsDelta()
 
+    #state of the (async) McPAT and hotspot runs
+    self.hotspot_job = None
+    self.pending_phase = None
+    self.core_hotspot = False
+    self.last_temperatures = None
+    self.lag_intervals = 0
+    self.async_wait_time = 0      # host time in ns spent waiting for background McPAT and hotspot runs
+    self.lag_error_sum = 0        # in milli-degrees, summed over intervals
+    self.lag_error_max = 0
+    self.lag_dtm_mismatches = 0   # component-intervals where the lagged temperature is on the other side of the DTM threshold
+    for metric in ('async-intervals', 'async-wait-time', 'lag-error-sum', 'lag-error-max', 'lag-dtm-mismatches'):
+      sim.stats.register('hotspot', 0, metric, self.get_lag_stat)
+
+    #checkpoint restore: no thermal simulation while fast-forwarding to the checkpoint, DTM sees the checkpointed temperatures
+    self.restoring = checkpoint_restore != ""
+    self.restored = False
+
+    #phase-based sampling: power traces of the last detailed interval of each phase
+    self.phase_power = {}
+    if phase_sampling:
+      self.phase_stats = {
+        'phase': self.sd.getter('sampling', 0, 'phase'),
+        'ffwd_time': self.sd.getter('sampling', 0, 'fastforward-time'),
+      }
+
     if mem_dtm != 'off':
       self.stats = {
         'time': [ self.getStatsGetter('performance_model', core, 'elapsed_time') for core in range(sim.config.ncores) ],
@@ -351,8 +381,10 @@ class memTherm:
     with open(full_bank_mode_trace_file, "w") as f:
         f.write("%s\n" %(mem_header))
     f.close()
+    if self.restoring:
+      os.system("cp " + os.path.join(checkpoint_restore, 'combined_insttemperature.trace') + " " + combined_insttemperature_trace_file)
     #setup to invoke the hotspot tool every interval_ns time and invoke calc_temperature_trace function
-    sim.util.Every(interval_ns * sim.util.Time.NS, self.calc_temperature_trace, statsdelta = self.sd, roi_only = True)
+    sim.util.Every(interval_ns * sim.util.Time.NS, self.calc_temperature_trace, statsdelta = self.sd, roi_only = True, independent = 'thermal')
 
 
   def get_bank_modes(self, time, time_delta):
@@ -459,6 +491,8 @@ class memTherm:
 
 
     # calculate power trace using access rate and other parameters
+    # for 3D and 2.5D, the core power trace is only available once McPAT has run: the memory part is written
+    # now and the commands that combine it with the core power trace are returned, to run after McPAT
   def calc_power_trace(self, time, time_delta):
     accesses_read, accesses_write, accesses_read_lowpower, accesses_write_lowpower = self.get_access_rates(time, time_delta)
  #    print accesses 
@@ -488,13 +522,6 @@ class memTherm:
         logic_power_trace = [logic_core_power for number in xrange(NUM_LC)]
     power_trace = ''
     # convert power trace into a concatenated string for formated output
-    #for 2.5D, read the core power from the core power trace file and include in the total power trace
-    if (type_of_stack == "2.5D"):
-        with open(c_power_trace_file, 'r') as power_file:
-            power_file.readline()  # ignore first line that contains the header
-            c_power_data=power_file.readline()  # ignore first line that contains the header
-        power_file.close()
-        power_trace = power_trace + c_power_data 
     #print logic power trace to the main power_trace
     for p in logic_power_trace:
         power_trace = power_trace + str(p) + '\t'
@@ -516,26 +543,27 @@ class memTherm:
     if (type_of_stack == "2.5D"):
         for x in range(1,4):
             power_trace = power_trace + str(0.00) + '\t'
-    c_power_data = ""
-      #read core power and add to main power trace at last for 3D
-    if (type_of_stack == "3D"):
-        with open(c_power_trace_file, 'r') as power_file:
-            power_file.readline()  # ignore first line that contains the header
-            c_power_data=power_file.readline()  # ignore first line that contains the header
-        power_file.close()
-        #print c_power_data
-
-    power_trace = power_trace + c_power_data + "\r\n"
     ptrace_header = gen_ptrace_header()
-   #write power information into the trace file for use by hotspot
-    with open("%s" %(power_trace_file), "w") as f:
-        f.write("%s\n" %(ptrace_header))
-        f.write("%s" %(power_trace))
-    f.close()
-    return power_trace
-
-  def execute_core_hotspot(self, vdd_str):
-     #the function to execute core hotspot separately. It is called only for 3Dmem and 2D arch.
+    #the core power (second line of the core power trace) goes first for 2.5D, last for 3D
+    if (type_of_stack == "2.5D"):
+        pre, post = "%s\n" %(ptrace_header), power_trace + "\r\n"
+    elif (type_of_stack == "3D"):
+        pre, post = "%s\n" %(ptrace_header) + power_trace, "\r\n"
+    else:
+        #write power information into the trace file for use by hotspot
+        with open("%s" %(power_trace_file), "w") as f:
+            f.write("%s\n" %(ptrace_header))
+            f.write("%s" %(power_trace + "\r\n"))
+        f.close()
+        return []
+    with open(power_trace_file + '.pre', 'w') as f:
+        f.write(pre)
+    with open(power_trace_file + '.post', 'w') as f:
+        f.write(post)
+    return [ '{ cat %s.pre ; tail -n +2 %s ; cat %s.post ; } > %s' % (power_trace_file, c_power_trace_file, power_trace_file, power_trace_file) ]
+
+  def core_hotspot_commands(self, vdd_str):
+     #the commands to execute core hotspot separately. It is called only for 3Dmem and 2D arch.
     c_executable = hotspot_path + 'hotspot'
  #  hotspot_steady_temp_file = config.get('hotspot_c/hotspot_steady_temp_file')
  #  hotspot_grid_steady_file = config.get('hotspot_c/hotspot_grid_steady_file')
@@ -543,9 +571,6 @@ class memTherm:
 
     c_powerLogFileName = file(c_full_power_trace_file, 'a');
     #c_powerInstantaneousFileName = file(c_power_trace_file, 'r');
-    if (core_thermal_enabled == 'true'):
-     c_thermalLogFileName = file(c_full_temperature_trace_file, 'a');
-    
     first_run = (sum(1 for linee in open(combined_temperature_trace_file, 'r')) == 1) 
 #    needInitializing = os.stat(c_full_power_trace_file).st_size == 0
     if (core_thermal_enabled == 'true'):
@@ -566,20 +591,21 @@ class memTherm:
                     + ' -v ' + vdd_str \
                     + ' -detailed_3D on'
                     #+ ' -f ' + c_hotspot_floorplan_file \
-     if (c_init_file_external!= "None") or (not first_run):
+     if (c_init_file_external!= "None") or (not first_run) or self.restored:
          c_hotspot_args += ' -init_file ' + c_init_file
 
      #print hotspot_binary, hotspot_args
 #     c_temperatures = subprocess.check_output([hotspot_binary] + hotspot_args)
      #print c_hotspot_args
-     os.system(c_hotspot_args)
-     os.system("cp -f " + c_hotspot_all_transient_file + " " + c_init_file)
+     return [ c_hotspot_args, "cp -f " + c_hotspot_all_transient_file + " " + c_init_file ]
+    return []
+
+  def log_core_temperature(self):
+    with open(c_temperature_trace_file, 'r') as instTemperatureFile:
+      instTemperatureFile.readline()  # ignore first line that contains the header
+      with open(c_full_temperature_trace_file, 'a') as c_thermalLogFileName:
+        c_thermalLogFileName.write(instTemperatureFile.readline())
 
-     with open(c_temperature_trace_file, 'r') as instTemperatureFile:
-       instTemperatureFile.readline()  # ignore first line that contains the header
-       c_thermalLogFileName.write(instTemperatureFile.readline())
-     c_thermalLogFileName.close()
-          
 
   def gen_combined_trace_header(self):
     trace_header = ""
@@ -669,25 +695,84 @@ class memTherm:
 
   # invokes hotspot to generate the temperature trace
   def calc_temperature_trace(self, time, time_delta):
+    if self.restoring:
+        return
+    #in async mode, collect the hotspot run of the previous interval before its input files are overwritten
+    self.finish_temperature_trace()
+    #with phase-based sampling, fast-forwarded intervals have no activity statistics to compute power from.
+    #the thermal model keeps running on the power of the last detailed interval of the same phase.
+    phase = None
+    extrapolate = False
+    if phase_sampling:
+        phase = int(self.phase_stats['phase'].last)
+        extrapolate = self.phase_stats['ffwd_time'].delta > time_delta / 2 and phase in self.phase_power
 #   print power_trace
-    #invoke energystats function to compute core power trace
-    self.ES.periodic(time, time_delta)
+    #invoke energystats to get the McPAT command that computes the core power trace. the stats snapshot
+    #advances on extrapolated intervals too, so the next detailed interval only covers its own activity
+    commands = []
+    power_command = self.ES.periodic(time, time_delta, run_power = not extrapolate)
+    if power_command:
+        commands.append(power_command)
     vdd_string = self.get_core_vdd_for_hotspot()     #used to scale core leakage power in hotspot
 
     self.write_bank_leakage_trace(time, time_delta)
 
     #execute hotspot separately for core in case of 3Dmem and 2D memories
-    if (core_thermal_enabled == 'true' and (type_of_stack=="3Dmem" or type_of_stack=="DDR")):
-        self.execute_core_hotspot(vdd_string)
-     #calculate memory power trace (combines with core trace in case of 3D and 2.5D within function)
-    self.calc_power_trace(time, time_delta)
+    self.core_hotspot = core_thermal_enabled == 'true' and (type_of_stack=="3Dmem" or type_of_stack=="DDR")
+    if self.core_hotspot:
+        commands += self.core_hotspot_commands(vdd_string)
+     #calculate memory power trace (combines with core trace in case of 3D and 2.5D after McPAT has run)
+    if extrapolate:
+        self.restore_phase_power(phase)
+    else:
+        commands += self.calc_power_trace(time, time_delta)
+        if phase_sampling:
+            #the power traces are complete once the commands have run
+            self.pending_phase = phase
      #invoke the memory hotspot. It will include core parts automatically for 3D and 2.5D
     hcmd = hotspot_command
     hcmd += ' -v ' + vdd_string
     first_run = (sum(1 for linee in open(combined_temperature_trace_file, 'r')) == 1) 
-    if (init_file_external!= "None") or (not first_run):
+    if (init_file_external!= "None") or (not first_run) or self.restored:
         hcmd += ' -init_file ' + init_file
-    os.system(hcmd)
+    commands.append(hcmd)
+    if hotspot_async:
+        #run McPAT and hotspot while the cores simulate the next interval, the results are collected at the next call
+        self.hotspot_job = subprocess.Popen(' ; '.join(commands), shell = True)
+    else:
+        for cmd in commands:
+            os.system(cmd)
+        self.hotspot_job = True
+        self.finish_temperature_trace()
+
+  # the power traces are the hotspot inputs, save or restore them as a whole
+  def save_phase_power(self, phase):
+    traces = {}
+    for filename in (power_trace_file, c_power_trace_file):
+      if os.path.exists(filename):
+        traces[filename] = open(filename, 'r').read()
+    self.phase_power[phase] = traces
+
+  def restore_phase_power(self, phase):
+    for filename, trace in self.phase_power[phase].items():
+      with open(filename, 'w') as f:
+        f.write(trace)
+
+  # wait for the outstanding McPAT and hotspot run and append its results to the trace files
+  def finish_temperature_trace(self):
+    if not self.hotspot_job:
+        return
+    if hotspot_async:
+        time_start = time.time()
+        self.hotspot_job.wait()
+        self.async_wait_time += long((time.time() - time_start) * 1e9)
+    self.hotspot_job = None
+    self.ES.finish()
+    if self.pending_phase is not None:
+        self.save_phase_power(self.pending_phase)
+        self.pending_phase = None
+    if self.core_hotspot:
+        self.log_core_temperature()
     self.format_trace_file(True, c_temperature_trace_file, temperature_trace_file, combined_temperature_trace_file, combined_insttemperature_trace_file)
     self.format_trace_file(True, c_power_trace_file, power_trace_file, combined_power_trace_file, combined_instpower_trace_file)
     self.format_trace_file(True, c_power_trace_file_total, power_trace_file_total, combined_power_trace_file_total, combined_instpower_trace_file_total)
@@ -698,6 +783,51 @@ class memTherm:
 
     os.system("tail -1 " + bank_mode_trace_file + " >>" + full_bank_mode_trace_file)
     os.system("rm -f tmmpFile_*")
+    self.update_lag_stats()
+
+  # Quantify the effect of the async lag: during the interval that just finished, DTM policies acted on the
+  # temperatures of the interval before it, where synchronous evaluation would have shown them the new ones.
+  def update_lag_stats(self):
+    with open(combined_insttemperature_trace_file, 'r') as f:
+      f.readline()  # ignore first line that contains the header
+      temperatures = [ float(t) for t in f.readline().split() ]
+    if hotspot_async and self.last_temperatures:
+      error = max([ abs(t - l) for t, l in zip(temperatures, self.last_temperatures) ] or [ 0 ])
+      self.lag_error_sum += long(error * 1000)
+      self.lag_error_max = max(self.lag_error_max, long(error * 1000))
+      for idx, (t, l) in enumerate(zip(temperatures, self.last_temperatures)):
+        threshold = dtm_core_temperature if idx < NUM_CORES else dtm_mem_temperature
+        if (t >= threshold) != (l >= threshold):
+          self.lag_dtm_mismatches += 1
+      self.lag_intervals += 1
+    self.last_temperatures = temperatures
+
+  def get_lag_stat(self, objectName, index, metricName):
+    return {
+      'async-intervals': self.lag_intervals,
+      'async-wait-time': self.async_wait_time,
+      'lag-error-sum': self.lag_error_sum,
+      'lag-error-max': self.lag_error_max,
+      'lag-dtm-mismatches': self.lag_dtm_mismatches,
+    }[metricName]
+
+  def hook_sim_end(self):
+    self.finish_temperature_trace()
+
+  # the hotspot state of a checkpoint: the transient temperatures the next run starts from
+  def hook_checkpoint_save(self, dirname):
+    self.finish_temperature_trace()
+    os.system("cp " + init_file + " " + os.path.join(dirname, 'hotspot_mem.init'))
+    if core_thermal_enabled == 'true' and (type_of_stack=="3Dmem" or type_of_stack=="DDR"):
+      os.system("cp " + c_init_file + " " + os.path.join(dirname, 'hotspot_core.init'))
+    os.system("cp " + combined_insttemperature_trace_file + " " + os.path.join(dirname, 'combined_insttemperature.trace'))
+
+  def hook_checkpoint_restore(self, dirname):
+    os.system("cp " + os.path.join(dirname, 'hotspot_mem.init') + " " + init_file)
+    if os.path.exists(os.path.join(dirname, 'hotspot_core.init')):
+      os.system("cp " + os.path.join(dirname, 'hotspot_core.init') + " " + c_init_file)
+    self.restoring = False
+    self.restored = True
 
   def getStatsGetter(self, component, core, metric):
     # Some components don't exist (i.e. DRAM reads on cores that don't have a DRAM controller),
@@ -741,23 +871,31 @@ class EnergyStats:
     self.in_stats_write = False
     self.power = {}
     self.energy = {}
+    self.name_delete = []   #snapshots still read by an outstanding McPAT run
     self.update()       #call the update function once dummy during init to preset various variables
 
-  def periodic(self, time, time_delta):
-    self.update()
+  #returns the McPAT command that computes the core power trace of the last interval, or None
+  def periodic(self, time, time_delta, run_power = True):
+    return self.update(run_power)
 
   def hook_pre_stat_write(self, prefix):
     if not self.in_stats_write:
-      self.update()
+      command = self.update()
+      if command:
+        os.system(command)
+      self.finish()
 
   def hook_sim_end(self):
+    self.finish()
     if self.name_last:
       sim.util.db_delete(self.name_last, True)
 
-  def update(self):
+  #the snapshot is always advanced, so that the next McPAT run only covers its own interval
+  def update(self, run_power = True):
+    command = None
     if sim.stats.time() == self.time_last_power:
       # Time did not advance: don't recompute
-      return
+      return command
     if not self.power or (sim.stats.time() - self.time_last_power >= 10 * sim.util.Time.US):
       # Time advanced significantly, or no power result yet: compute power
       #   Save snapshot
@@ -766,17 +904,23 @@ class EnergyStats:
       sim.stats.write(current)
       self.in_stats_write = False
       #   If we also have a previous snapshot: update power
+      if self.name_last and run_power:
+        command = self.power_command(self.name_last, current)
+      #   Clean up previous last, once McPAT is done with it
       if self.name_last:
-        power = self.run_power(self.name_last, current)
-        #self.update_power(power)
-      #   Clean up previous last
-      if self.name_last:
-        sim.util.db_delete(self.name_last)
+        self.name_delete.append(self.name_last)
       #   Update new last
       self.name_last = current
       self.time_last_power = sim.stats.time()
     # Increment energy
     #self.update_energy()
+    return command
+
+  #called once the McPAT command returned by update() has completed
+  def finish(self):
+    for name in self.name_delete:
+      sim.util.db_delete(name)
+    self.name_delete = []
 
   def get_vdd_from_freq(self, f):
     # Assume self.dvfs_table is sorted from highest frequency to lowest
@@ -799,22 +943,19 @@ vdd[] = %s
     cfg.close()
     return configfile
 
-  def run_power(self, name0, name1):
+  #McPAT writes the core power trace (hotspot/log_files_core/power_trace_file) between snapshots name0 and name1
+  def power_command(self, name0, name1):
     outputbase = os.path.join(sim.config.output_dir, 'energystats-temp')
 
     configfile = self.gen_config(outputbase)
 
-    os.system('unset PYTHONHOME; %s -d %s -o %s -c %s -t %s --partial=%s:%s --no-graph --no-text' % (
+    return 'unset PYTHONHOME; %s -d %s -o %s -c %s -t %s --partial=%s:%s --no-graph --no-text' % (
       os.path.join(os.getenv('SNIPER_ROOT'), 'tools/mcpat.py'),
       sim.config.output_dir,
       outputbase,
       configfile,
       'dynamic',
       name0, name1
-    ))
-
-    result = {}
-    execfile(outputbase + '.py', {}, result)
-    return result['power']
+    )
 
 sim.util.register(memTherm())
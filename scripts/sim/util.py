@@ -131,7 +131,11 @@ class StatsDelta:
 
 
 class Every:
-  def __init__(self, interval, callback, statsdelta = None, roi_only = True):
+  # With independent = <name>, the periodic callback may run concurrently with the simulator's other independent
+  # HOOK_PERIODIC callbacks (see HooksManager::registerIndependentHook), those can declare a dependency on <name>.
+  # It keeps the order of sim.hooks.register(), so it still runs before the scheduler. Only use it for callbacks
+  # that do not change simulator state.
+  def __init__(self, interval, callback, statsdelta = None, roi_only = True, independent = None):
     min_interval = long(sim.config.get('clock_skew_minimization/barrier/quantum')) * 1e6
     if interval < min_interval:
       print >> sys.stderr, 'sim.util.Every(): interval(%dns) < periodic callback(%dns), consider reducing clock_skew_minimization/barrier/quantum' % (interval/1e6, min_interval/1e6)
@@ -142,7 +146,12 @@ class Every:
     self.time_next = 0
     self.time_last = 0
     self.in_roi = False
-    register(self)
+    if independent:
+      sim.hooks.register(sim.hooks.HOOK_ROI_BEGIN, self.hook_roi_begin)
+      sim.hooks.register(sim.hooks.HOOK_ROI_END, self.hook_roi_end)
+      sim.hooks.register_independent(sim.hooks.HOOK_PERIODIC, self.hook_periodic, independent)
+    else:
+      register(self)
 
   def hook_roi_begin(self):
     self.in_roi = True
@@ -24,3 +24,9 @@ VIDEO_BREAKOUT_TYPE = 'CORE'  # CORE or MEMORY
 VIDEO_INVERTED_VIEW = False  # inverted = heatsink on bottom
 VIDEO_EXPLICIT_TMIN = None  # if None use default min and max values
 VIDEO_EXPLICIT_TMAX = None  # if None use default min and max values
+
+
+# parallel sweeps (sweep.py)
+SWEEP_FOLDER = os.path.join(SNIPER, 'sweeps')  # working directories of running jobs and aggregated datasets
+SWEEP_CORES_PER_JOB = 1  # host cores reserved per simulation
+SWEEP_MEMORY_PER_JOB_GB = 4  # host memory reserved per simulation
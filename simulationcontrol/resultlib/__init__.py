@@ -103,6 +103,16 @@ def get_individual_response_times(run):
         return [resp_times[task] for task in keys]
 
 
+@cache.memoize()
+def get_tail_response_times(run):
+    with _open_file(run, 'execution.log') as f:
+        for line in f:
+            m = re.search(r'p95/p99 Response Time \(ns\)\s+:\s+(\d+)\s+(\d+)', line)
+            if m is not None:
+                return int(m.group(1)), int(m.group(2))
+    return '-'
+
+
 def _get_traces(run, filename, multiplicator=1):
     traces = []
 
@@ -266,3 +276,17 @@ def count_cores(run):
 def get_active_cores(run):
     utilization_traces = get_core_utilization_traces(run)
     return [i for i, utilization in enumerate(utilization_traces) if max(utilization) > 0.01]
+
+
+def get_trace_columns(run):
+    """all periodic traces of a run as columns: name -> list of values (one per interval)"""
+    columns = collections.OrderedDict()
+    for name, trace in _get_named_traces(run, 'combined_power.trace').items():
+        columns['power.' + name] = trace
+    for name, trace in _get_named_traces(run, 'combined_temperature.trace').items():
+        columns['temperature.' + name] = trace
+    for core, trace in enumerate(get_core_freq_traces(run)):
+        columns['frequency.C{}'.format(core)] = trace
+    for core, trace in enumerate(get_cpi_traces(run, raw=True)):
+        columns['cpi.C{}'.format(core)] = trace
+    return columns
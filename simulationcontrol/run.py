@@ -1,4 +1,5 @@
 import runlib
+import sweep
 
 
 def example2():
@@ -42,6 +43,15 @@ def case_study():
     runlib.run(['open', 'ondemand'], runlib.get_instance('parsec-swaptions', parallelism=4, input_set='medium'))
 
 
+def sweep_example():
+    # runs in parallel, jobs that have already been run with the same configuration are skipped
+    sweep.run_sweep({
+        'benchmark': [runlib.get_instance('parsec-blackscholes', parallelism, input_set='simsmall') for parallelism in (2, 4)],
+        'frequency': ['{:.1f}GHz'.format(freq) for freq in (1, 2, 3, 4)],
+        'policy': [['open', 'constFreq']],
+    }, dataset='blackscholes_frequencies')
+
+
 def main():
     example()
     case_study()
@@ -20,42 +20,53 @@ BENCHMARKS = os.path.join(SNIPER_BASE, 'benchmarks')
 BATCH_START = datetime.datetime.now().strftime('%Y-%m-%d_%H.%M')
 
 
-def change_configuration_files(configuration_tags):
-    seen = set()
-    for filename in os.listdir(os.path.join(SNIPER_BASE, 'config')):
+def apply_configuration_tags(content, configuration_tags, seen=None):
+    new_content = ''
+    for line in content.splitlines():
+        m = re.match('.*cfg:(!?)([a-zA-Z_\\.0-9]+)$', line)
+        if m:
+            inverted = m.group(1) == '!'
+            include = inverted ^ (m.group(2) in configuration_tags)
+            included = line[0] != '#'
+            if include and not included:
+                line = line[1:]
+            elif not include and included:
+                line = '#' + line
+            if seen is not None and m.group(2) in configuration_tags:
+                seen.add(m.group(2))
+        new_content += line
+        new_content += '\n'
+    return new_content
+
+
+def get_configuration_files(configuration_tags, seen=None):
+    """returns (filename, original content, content with configuration_tags applied) for all config files"""
+    files = []
+    for filename in sorted(os.listdir(os.path.join(SNIPER_BASE, 'config'))):
         if filename.endswith('.cfg'):
             full_filename = os.path.join(SNIPER_BASE, 'config', filename)
             with open(full_filename, 'r') as f:
                 content = f.read()
+            files.append((filename, content, apply_configuration_tags(content, configuration_tags, seen)))
+    return files
 
-            new_content = ''
-            for line in content.splitlines():
-                m = re.match('.*cfg:(!?)([a-zA-Z_\\.0-9]+)$', line)
-                if m:
-                    inverted = m.group(1) == '!'
-                    include = inverted ^ (m.group(2) in configuration_tags)
-                    included = line[0] != '#'
-                    if include and not included:
-                        line = line[1:]
-                    elif not include and included:
-                        line = '#' + line
-                    if m.group(2) in configuration_tags:
-                        seen.add(m.group(2))
-                new_content += line
-                new_content += '\n'
-
-            if content != new_content:
-                print('changing', full_filename)
-                print(''.join(difflib.unified_diff(content.splitlines(keepends=True), new_content.splitlines(keepends=True))), end='')
-                with open(full_filename, 'w') as f:
-                    f.write(new_content)
+
+def change_configuration_files(configuration_tags):
+    seen = set()
+    for filename, content, new_content in get_configuration_files(configuration_tags, seen):
+        full_filename = os.path.join(SNIPER_BASE, 'config', filename)
+        if content != new_content:
+            print('changing', full_filename)
+            print(''.join(difflib.unified_diff(content.splitlines(keepends=True), new_content.splitlines(keepends=True))), end='')
+            with open(full_filename, 'w') as f:
+                f.write(new_content)
     not_seen = set(configuration_tags) - seen
     if not_seen:
         print('WARNING: these configuration options have no match in base.cfg and have no effect: {}'.format(', '.join(not_seen)))
         input('Please press enter to continue...')
 
 
-def create_video(run):
+def create_video(run, output_dir=BENCHMARKS):
     args = [
         os.path.join(SNIPER_BASE, 'scripts', 'heatView.py'),
         '--cores_in_x', str(config.NUMBER_CORES_X),
@@ -69,7 +80,7 @@ def create_video(run):
         '--layer_to_view', str(config.VIDEO_BREAKOUT_LAYER),
         '--type_to_view', config.VIDEO_BREAKOUT_TYPE,
         '--samplingRate', '1',
-        '--traceFile', os.path.join(BENCHMARKS, 'combined_temperature.trace'),
+        '--traceFile', os.path.join(output_dir, 'combined_temperature.trace'),
         '--output', os.path.join(config.RESULTS_FOLDER, run, 'video'),
         '--clean',
     ]
@@ -83,11 +94,15 @@ def create_video(run):
     subprocess.check_call(args)
 
 
-def save_output(configuration_tags, benchmark, console_output, started, ended):
+def get_run_name(configuration_tags, benchmark):
     benchmark_text = benchmark
     if len(benchmark_text) > 100:
         benchmark_text = benchmark_text[:100] + '__etc'
-    run = 'results_{}_{}_{}'.format(BATCH_START, '+'.join(configuration_tags), benchmark_text)
+    return 'results_{}_{}_{}'.format(BATCH_START, '+'.join(configuration_tags), benchmark_text)
+
+
+def save_output(configuration_tags, benchmark, console_output, started, ended, output_dir=BENCHMARKS, video=True):
+    run = get_run_name(configuration_tags, benchmark)
     directory = os.path.join(config.RESULTS_FOLDER, run)
     if not os.path.exists(directory):
         os.makedirs(directory)
@@ -103,7 +118,7 @@ def save_output(configuration_tags, benchmark, console_output, started, ended):
               'sim.info',
               'sim.out',
               'sim.stats.sqlite3'):
-        shutil.copy(os.path.join(BENCHMARKS, f), directory)
+        shutil.copy(os.path.join(output_dir, f), directory)
     for f in ('combined_power.trace',  # this contains power of cores and memory banks
               'full_power_mem.trace',  # this contains power of memory banks and logic cores (memory controllers)
               'full_power_core.trace',  # this contains power of cores (included for consistency)
@@ -111,35 +126,48 @@ def save_output(configuration_tags, benchmark, console_output, started, ended):
               'PeriodicFrequency.log',
               'PeriodicVdd.log',
               'PeriodicCPIStack.log',):
-        with open(os.path.join(BENCHMARKS, f), 'rb') as f_in, gzip.open('{}.gz'.format(os.path.join(directory, f)), 'wb') as f_out:
+        with open(os.path.join(output_dir, f), 'rb') as f_in, gzip.open('{}.gz'.format(os.path.join(directory, f)), 'wb') as f_out:
             shutil.copyfileobj(f_in, f_out)
     create_plots(run)
-    create_video(run)
+    if video:
+        create_video(run, output_dir)
+    return run
 
 
-def run(configuration_tags, benchmark):
-    print('running {} with configuration {}'.format(benchmark, '+'.join(configuration_tags)))
-    started = datetime.datetime.now()
-    change_configuration_files(configuration_tags)
-
-    args = '-n {number_cores} -c {config} --benchmarks={benchmark} --no-roi --sim-end=last -s memTherm_core' \
+def get_sniper_args(benchmark, sniper_config=None):
+    return '-n {number_cores} -c {config} --benchmarks={benchmark} --no-roi --sim-end=last -s memTherm_core' \
         .format(number_cores=config.NUMBER_CORES,
-                config=config.SNIPER_CONFIG,
+                config=sniper_config or config.SNIPER_CONFIG,
                 benchmark=benchmark)
+
+
+def execute_sniper(args, cwd=BENCHMARKS, echo=True):
+    """runs benchmarks/run-sniper in cwd, returns the return code and the console output"""
     console_output = ''
-    print(args)
     run_sniper = os.path.join(BENCHMARKS, 'run-sniper')
-    p = subprocess.Popen([run_sniper] + args.split(' '), stdout=subprocess.PIPE, stderr=subprocess.STDOUT, bufsize=1, cwd=BENCHMARKS)
+    p = subprocess.Popen([run_sniper] + args.split(' '), stdout=subprocess.PIPE, stderr=subprocess.STDOUT, bufsize=1, cwd=cwd)
     with p.stdout:
         for line in iter(p.stdout.readline, b''):
             linestr = line.decode('utf-8')
             console_output += linestr
-            print(linestr, end='')
+            if echo:
+                print(linestr, end='')
     p.wait()
+    return p.returncode, console_output
+
+
+def run(configuration_tags, benchmark):
+    print('running {} with configuration {}'.format(benchmark, '+'.join(configuration_tags)))
+    started = datetime.datetime.now()
+    change_configuration_files(configuration_tags)
+
+    args = get_sniper_args(benchmark)
+    print(args)
+    returncode, console_output = execute_sniper(args)
 
     ended = datetime.datetime.now()
 
-    if p.returncode != 0:
+    if returncode != 0:
         raise Exception('return code != 0')
 
     save_output(configuration_tags, benchmark, console_output, started, ended)
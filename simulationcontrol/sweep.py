@@ -0,0 +1,254 @@
+"""Parallel parameter sweeps
+
+A sweep is a grid of parameters. Every parameter maps to a list of values, each value being a
+configuration tag (see the cfg: comments in config/base.cfg), a list of tags, or None for no tag.
+The special parameter 'benchmark' lists the benchmarks. The sweep runs the cross product.
+
+    sweep.run_sweep({
+        'benchmark': ['parsec-blackscholes-simsmall-2', 'parsec-swaptions-simsmall-2'],
+        'frequency': ['1.0GHz', '2.0GHz', '3.0GHz', '4.0GHz'],
+        'policy': [['open', 'constFreq']],
+    }, dataset='frequencies')
+
+Unlike runlib.run, jobs do not change the configuration files in place: every job gets its own
+working directory (config.SWEEP_FOLDER) with tagged copies of the configuration files, so jobs can
+run concurrently. The number of concurrent jobs is limited by the host cores and available memory.
+run-sniper always loads config/base.cfg before the job's copy, so a sweep first resets the tags in
+config/base.cfg that an earlier runlib.run enabled; do not use runlib.run while a sweep is running.
+
+Results are stored in config.RESULTS_FOLDER like runlib.run does, together with a hash of the
+effective configuration and the benchmark. Jobs whose hash is already in the results are not
+run again. The traces of all jobs are combined into one table (one row per job and interval,
+one column per trace) in config.SWEEP_FOLDER/<dataset>.csv.gz.
+"""
+
+import collections
+import concurrent.futures
+import csv
+import datetime
+import gzip
+import hashlib
+import itertools
+import json
+import os
+import shutil
+
+import config
+import runlib
+import resultlib
+
+KEY_FILE = 'sweep.key'
+PARAMS_FILE = 'sweep.json'
+
+Job = collections.namedtuple('Job', ['params', 'configuration_tags', 'benchmark'])
+
+
+def expand_grid(grid):
+    assert 'benchmark' in grid, 'a sweep needs a benchmark parameter'
+    names = list(grid.keys())
+    jobs = []
+    for values in itertools.product(*(grid[name] for name in names)):
+        params = collections.OrderedDict(zip(names, values))
+        tags = []
+        for name, value in params.items():
+            if name == 'benchmark' or value is None:
+                continue
+            for tag in ([value] if isinstance(value, str) else value):
+                if tag not in tags:
+                    tags.append(tag)
+        jobs.append(Job(params, tags, params['benchmark']))
+    return jobs
+
+
+def get_untagged_base_config():
+    """config/base.cfg without any configuration tags, as every job loads it before its own copy"""
+    with open(os.path.join(runlib.SNIPER_BASE, 'config', 'base.cfg'), 'r') as f:
+        return runlib.apply_configuration_tags(f.read(), [])
+
+
+def reset_base_config():
+    """disables the tagged lines that runlib.run enabled in config/base.cfg"""
+    filename = os.path.join(runlib.SNIPER_BASE, 'config', 'base.cfg')
+    untagged = get_untagged_base_config()
+    with open(filename, 'r') as f:
+        if f.read() == untagged:
+            return
+    print('resetting configuration tags in', filename)
+    with open(filename, 'w') as f:
+        f.write(untagged)
+
+
+def get_key(job):
+    """hash of everything that determines the result of a job"""
+    h = hashlib.sha256()
+    # all configuration files a job loads: config/base.cfg, then the job's copies and the untagged files
+    h.update(get_untagged_base_config().encode('utf-8'))
+    for filename, _, content in runlib.get_configuration_files(job.configuration_tags):
+        h.update(filename.encode('utf-8'))
+        h.update(content.encode('utf-8'))
+    h.update('{} {} {}'.format(config.SNIPER_CONFIG, config.NUMBER_CORES, job.benchmark).encode('utf-8'))
+    return h.hexdigest()
+
+
+def get_cached_runs():
+    """key -> run for all finished sweep jobs in the results"""
+    cached = {}
+    for run in resultlib.get_runs():
+        key_file = os.path.join(resultlib.find_run(run), KEY_FILE)
+        if os.path.exists(key_file):
+            with open(key_file, 'r') as f:
+                cached[f.read().strip()] = run
+    return cached
+
+
+def get_max_jobs():
+    cores = os.cpu_count() or 1
+    by_cores = max(1, cores // config.SWEEP_CORES_PER_JOB)
+    try:
+        with open('/proc/meminfo', 'r') as f:
+            meminfo = dict(line.split(':', 1) for line in f)
+        available_gb = int(meminfo['MemAvailable'].split()[0]) / 1024 / 1024
+    except (IOError, KeyError, ValueError):
+        return by_cores
+    by_memory = max(1, int(available_gb // config.SWEEP_MEMORY_PER_JOB_GB))
+    return min(by_cores, by_memory)
+
+
+def _prepare_job_dir(job, key):
+    """working directory with the configuration files of this job, returns (directory, -c argument)"""
+    directory = os.path.join(config.SWEEP_FOLDER, 'jobs', key[:16])
+    if os.path.exists(directory):
+        shutil.rmtree(directory)
+    os.makedirs(directory)
+
+    seen = set()
+    sniper_configs = [config.SNIPER_CONFIG]
+    for filename, _, content in runlib.get_configuration_files(job.configuration_tags, seen):
+        if 'cfg:' not in content:
+            continue
+        # config files are searched in the current directory first, so includes also pick up these copies
+        with open(os.path.join(directory, filename), 'w') as f:
+            f.write(content)
+        if filename == 'base.cfg':
+            # run-sniper always loads config/base.cfg first (reset_base_config removed its tags), the copy
+            # then sets the values of this job's tags. A line the copy disables cannot be undone that way.
+            untagged = get_untagged_base_config().splitlines()
+            for line in set(untagged) - set(content.splitlines()):
+                if not line.startswith('#'):
+                    raise Exception('base.cfg line cannot be disabled by a configuration tag in a sweep: {}'.format(line))
+            sniper_configs.insert(0, os.path.join(directory, filename))
+    not_seen = set(job.configuration_tags) - seen
+    if not_seen:
+        raise Exception('these configuration options have no match in base.cfg: {}'.format(', '.join(not_seen)))
+    return directory, ','.join(sniper_configs)
+
+
+def _run_job(job, directory, sniper_config):
+    started = datetime.datetime.now()
+    args = runlib.get_sniper_args(job.benchmark, sniper_config) + ' -d {}'.format(directory)
+    returncode, console_output = runlib.execute_sniper(args, cwd=directory, echo=False)
+    ended = datetime.datetime.now()
+    with open(os.path.join(directory, 'execution.log'), 'w') as f:
+        f.write(console_output)
+    return returncode, console_output, started, ended
+
+
+def _describe(job):
+    return '{} with configuration {}'.format(job.benchmark, '+'.join(job.configuration_tags))
+
+
+def run_sweep(grid, dataset='sweep', max_jobs=None, force=False, video=False, keep_job_dirs=False):
+    """runs all jobs of grid that are not cached yet, returns a list of (job, run)"""
+    jobs = expand_grid(grid)
+    reset_base_config()
+    keys = [get_key(job) for job in jobs]
+    cached = {} if force else get_cached_runs()
+    max_jobs = max_jobs or get_max_jobs()
+
+    runs = {}
+    pending = []
+    for job, key in zip(jobs, keys):
+        if key in cached:
+            print('cached: {} ({})'.format(_describe(job), cached[key]))
+            runs[key] = cached[key]
+        elif key not in [k for _, k in pending]:
+            pending.append((job, key))
+
+    print('sweep: {} jobs, {} cached, {} to run with {} parallel jobs'.format(len(jobs), len(jobs) - len(pending), len(pending), max_jobs))
+
+    failed = []
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max_jobs) as executor:
+        futures = {}
+        for job, key in pending:
+            directory, sniper_config = _prepare_job_dir(job, key)
+            print('starting {}'.format(_describe(job)))
+            futures[executor.submit(_run_job, job, directory, sniper_config)] = (job, key, directory)
+
+        # post-processing (plots use matplotlib, which is not thread-safe) happens here, one job at a time
+        for future in concurrent.futures.as_completed(futures):
+            job, key, directory = futures[future]
+            returncode, console_output, started, ended = future.result()
+            if returncode != 0:
+                print('FAILED: {}, see {}'.format(_describe(job), os.path.join(directory, 'execution.log')))
+                failed.append(job)
+                continue
+            run = runlib.save_output(job.configuration_tags, job.benchmark, console_output, started, ended, output_dir=directory, video=video)
+            run_dir = resultlib.find_run(run)
+            with open(os.path.join(run_dir, PARAMS_FILE), 'w') as f:
+                json.dump(job.params, f)
+            # written last: a run with a key file is complete
+            with open(os.path.join(run_dir, KEY_FILE), 'w') as f:
+                f.write(key)
+            runs[key] = run
+            if not keep_job_dirs:
+                shutil.rmtree(directory)
+            print('finished {} ({})'.format(_describe(job), ended - started))
+
+    if failed:
+        print('WARNING: {} jobs failed'.format(len(failed)))
+
+    results = [(job, runs[key]) for job, key in zip(jobs, keys) if key in runs]
+    if dataset:
+        aggregate(results, os.path.join(config.SWEEP_FOLDER, '{}.csv.gz'.format(dataset)))
+    return results
+
+
+def aggregate(results, filename):
+    """combines the traces of all (job, run) into one table"""
+    param_names = []
+    trace_names = []
+    tables = []
+    for job, run in results:
+        for name in job.params:
+            if name not in param_names:
+                param_names.append(name)
+        columns = resultlib.get_trace_columns(run)
+        for name in columns:
+            if name not in trace_names:
+                trace_names.append(name)
+        tables.append((job, run, columns))
+
+    if not os.path.exists(os.path.dirname(filename)):
+        os.makedirs(os.path.dirname(filename))
+    with gzip.open(filename, 'wt', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['run'] + param_names + ['interval'] + trace_names)
+        for job, run, columns in tables:
+            params = [_format_param(job.params.get(name)) for name in param_names]
+            length = max(len(trace) for trace in columns.values()) if columns else 0
+            for interval in range(length):
+                values = []
+                for name in trace_names:
+                    trace = columns.get(name, ())
+                    value = trace[interval] if interval < len(trace) else None
+                    values.append('' if value is None else value)
+                writer.writerow([run] + params + [interval] + values)
+    print('sweep dataset: {} ({} runs)'.format(filename, len(tables)))
+
+
+def _format_param(value):
+    if value is None:
+        return ''
+    if isinstance(value, str):
+        return value
+    return '+'.join(value)
@@ -92,6 +92,7 @@ def build_itemlist(use_simple_sync = False, use_simple_mem = True):
 
   items += [
     [ 'dvfs-transition', 0.01, 'SyncDvfsTransition' ],
+    [ 'policy-overhead', 0.01, 'SyncPolicyOverhead' ],
     [ 'imbalance', 0.01, [
       [ 'start', 0.01, ('StartTime', 'Unknown') ],
       [ 'end',   0.01, 'Imbalance' ],
@@ -310,7 +310,7 @@ def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no
   time0_begin = results['results']['global.time_begin']
   time0_end = results['results']['global.time_end']
   seconds = (time0_end - time0_begin)/1e15
-  results = power_stack(power_dat,results['config'], powertype)  
+  results = power_stack(power_dat,results['config'], powertype, stats = results['results'])  
   # Plot stack
   plot_labels = []
   plot_data = {}
@@ -387,7 +387,7 @@ def scale_power(suffix, power, size_nm):
   else:
     raise Exception('do not know how to scale power: {}'.format(suffix))
 
-def power_stack(power_dat, cfg, powertype = 'total', nocollapse = False):
+def power_stack(power_dat, cfg, powertype = 'total', nocollapse = False, stats = None):
   size_nm = int(sniper_config.get_config(cfg, "power/technology_node"))
   def getpower(powers, key = None):
     def getcomponent(suffix):
@@ -610,9 +610,18 @@ def power_stack(power_dat, cfg, powertype = 'total', nocollapse = False):
   if sniper_config.get_config_bool(cfg, "core_power/l3"):  
     Readings += str(L3Power)+"\t"  # Private L3
   
+  # NoC power per router, in proportion to the flits sent out by each router (emesh_hop_by_hop network only)
+  nocPower = [ 0 ] * len(power_dat['Core'])
+  if sniper_config.get_config_default(cfg, "core_power/noc", "false") == "true" and stats and 'network.shmem-1.mesh.router-flits' in stats:
+    flits = stats['network.shmem-1.mesh.router-flits']
+    totalFlits = float(sum(flits) or 1)
+    for i in range(min(len(flits), len(nocPower))):
+      nocPower[i] = data['noc'] * flits[i] / totalFlits
+
   amtCores = len(power_dat['Core'])
   for i, core in enumerate(power_dat['Core']):
-    totalPower = getpower(core)
+    # Routers are part of the core tile in the floorplan
+    totalPower = getpower(core) + nocPower[i]
     IFUPower =  getpower(core, 'Instruction Fetch Unit/Branch Predictor') + getpower(core, 'Instruction Fetch Unit/Branch Target Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Decoder') + getpower(core, 'Instruction Fetch Unit/Instruction Cache') 
     LSUPower =  getpower(core, 'Load Store Unit/Data Cache') + getpower(core, 'Load Store Unit/LoadQ') + getpower(core, 'Load Store Unit/StoreQ')
     EUPower = getpower(core, 'Execution Unit/Instruction Scheduler') + getpower(core, 'Execution Unit/Register Files') + getpower(core, 'Execution Unit/Results Broadcast Bus') + getpower(core, 'Execution Unit/Complex ALUs') + getpower(core, 'Execution Unit/Floating Point Units') + getpower(core, 'Execution Unit/Integer ALUs')
@@ -948,6 +957,8 @@ def edit_XML(statsobj, stats, cfg):
           elif template[i][1][0]=="NoC.duty_cycle":
             if 'network.shmem-1.mesh.link-left.total-time-used' in stats:
               DIRECTIONS = ('up', 'down', 'left', 'right')
+              if 'network.shmem-1.mesh.link-above.total-time-used' in stats:
+                DIRECTIONS += ('above', 'below')
               total_time_used = sum([ sum(stats['network.shmem-1.mesh.link-%s.total-time-used' % direction]) for direction in DIRECTIONS ])
               num_links_used = sum([ sum([ v > 0 and 1 or 0 for v in stats['network.shmem-1.mesh.link-%s.num-requests' % direction] ]) for direction in DIRECTIONS ])
               # Not all links (e.g. boundary of mesh) are actually present in hardware
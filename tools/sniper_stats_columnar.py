@@ -0,0 +1,168 @@
+import os, sys, getopt, struct, zlib, sniper_stats_sqlite
+
+COLUMNAR_MAGIC = 'SNSTCOL1'
+INDEX_MAGIC = 'SNSTIDX1'
+RECORD_COLUMNS, RECORD_SNAPSHOT, RECORD_INDEX = 1, 2, 3
+
+# Index of a file still being written: path -> (inode, file offset up to which it was scanned, compressed, columns, offsets).
+# Later readers in the same process only scan the records appended since.
+_scanned = {}
+
+# Statistics values are stored in sim.stats.columnar, one UInt64 vector per snapshot.
+# Metric names, prefixes, topology and events remain in sim.stats.sqlite3.
+class SniperStatsColumnar(sniper_stats_sqlite.SniperStatsSqlite):
+  def __init__(self, filename = 'sim.stats.sqlite3', columnarfile = 'sim.stats.columnar'):
+    sniper_stats_sqlite.SniperStatsSqlite.__init__(self, filename)
+    self.columnarfile = columnarfile
+    self.columns = []   # column -> (nameid, index)
+    self.offsets = {}   # prefixid -> (file offset, number of columns, payload size)
+    self.read_index()
+
+  def add_columns(self, values):
+    # Indices are UInt32 in the simulator, the sqlite format stores them as signed integers
+    self.columns += [ (nameid, index - 2**32 if index >= 2**31 else index) for nameid, index in zip(values[0::2], values[1::2]) ]
+
+  def add_snapshot(self, prefixid, offset, ncolumns, size):
+    if prefixid not in self.offsets: # Keep the first snapshot of a prefix, like the sqlite reader
+      self.offsets[prefixid] = (offset, ncolumns, size)
+
+  def read_index(self):
+    with open(self.columnarfile, 'rb') as fp:
+      magic = fp.read(8)
+      if magic != COLUMNAR_MAGIC:
+        raise ValueError('Invalid columnar statistics file %s' % self.columnarfile)
+      self.compressed, = struct.unpack('Q', fp.read(8))
+      # A completed run appends an index, found through the trailer at the end of the file
+      fp.seek(0, os.SEEK_END)
+      filesize = fp.tell()
+      if filesize >= 32:
+        fp.seek(-16, os.SEEK_END)
+        offset, = struct.unpack('Q', fp.read(8))
+        if fp.read(8) == INDEX_MAGIC:
+          fp.seek(offset)
+          self.read_index_record(fp)
+          return
+      # Otherwise, scan the records, resuming where an earlier reader of this file stopped
+      path = os.path.realpath(self.columnarfile)
+      inode = os.fstat(fp.fileno()).st_ino
+      fp.seek(16)
+      if path in _scanned:
+        cached_inode, offset, compressed, columns, offsets = _scanned[path]
+        # A new run truncates the file, start over if it no longer matches
+        if (cached_inode, compressed) == (inode, self.compressed) and offset <= filesize:
+          self.columns, self.offsets = list(columns), dict(offsets)
+          fp.seek(offset)
+      offset = self.scan_records(fp, filesize)
+      _scanned[path] = (inode, offset, self.compressed, list(self.columns), dict(self.offsets))
+
+  def read_index_record(self, fp):
+    rtype, ncolumns = struct.unpack('QQ', fp.read(16))
+    if rtype != RECORD_INDEX:
+      raise ValueError('Invalid index in %s' % self.columnarfile)
+    self.add_columns(struct.unpack('%dQ' % (2*ncolumns), fp.read(16*ncolumns)))
+    nsnapshots, = struct.unpack('Q', fp.read(8))
+    values = struct.unpack('%dQ' % (4*nsnapshots), fp.read(32*nsnapshots))
+    for i in range(nsnapshots):
+      self.add_snapshot(*values[4*i:4*i+4])
+
+  def scan_records(self, fp, filesize):
+    # Returns the offset after the last complete record
+    while True:
+      offset = fp.tell()
+      data = fp.read(8)
+      if len(data) < 8:
+        return offset
+      rtype, = struct.unpack('Q', data)
+      if rtype == RECORD_COLUMNS:
+        data = fp.read(16)
+        if len(data) < 16:
+          return offset
+        first, count = struct.unpack('QQ', data)
+        data = fp.read(16*count)
+        if len(data) < 16*count:
+          return offset
+        assert first == len(self.columns)
+        self.add_columns(struct.unpack('%dQ' % (2*count), data))
+      elif rtype == RECORD_SNAPSHOT:
+        data = fp.read(24)
+        if len(data) < 24:
+          return offset
+        prefixid, ncolumns, size = struct.unpack('QQQ', data)
+        if offset + 32 + size > filesize:
+          return offset
+        fp.seek(size, os.SEEK_CUR)
+        self.add_snapshot(prefixid, offset + 32, ncolumns, size)
+      elif rtype == RECORD_INDEX:
+        return offset
+      else:
+        raise ValueError('Invalid record type %d in %s' % (rtype, self.columnarfile))
+
+  def read_columns(self, prefixid):
+    offset, ncolumns, size = self.offsets[prefixid]
+    with open(self.columnarfile, 'rb') as fp:
+      fp.seek(offset)
+      data = fp.read(size)
+    if self.compressed:
+      data = zlib.decompress(data)
+    return struct.unpack('%dq' % ncolumns, data)
+
+  def read_snapshot(self, prefix, metrics = None):
+    c = self.db.cursor()
+    c.execute('select prefixid from `prefixes` where prefixname = ?', (prefix,))
+    prefixids = list(c)
+    if not prefixids or prefixids[0][0] not in self.offsets:
+      raise ValueError('Invalid prefix %s' % prefix)
+    if metrics:
+      nameids = set([ nameid for nameid, (objectname, metricname) in self.names.items() if '%s.%s' % (objectname, metricname) in metrics ])
+    values = {}
+    for column, value in enumerate(self.read_columns(prefixids[0][0])):
+      nameid, core = self.columns[column]
+      # Skip default values, the sqlite format does not store them either
+      if value == 0 or (metrics and nameid not in nameids):
+        continue
+      if nameid not in values: values[nameid] = {}
+      values[nameid][core] = value
+    return values
+
+  def export_sqlite(self):
+    # Write all snapshot values into the `values` table, so tools that access the database directly keep working
+    c = self.db.cursor()
+    for prefixid in sorted(self.offsets.keys()):
+      c.execute('delete from `values` where prefixid = ?', (prefixid,))
+      rows = [ (prefixid, self.columns[column][0], self.columns[column][1], value)
+               for column, value in enumerate(self.read_columns(prefixid)) if value != 0 ]
+      c.executemany('insert into `values` (prefixid, nameid, core, value) values (?, ?, ?, ?)', rows)
+    self.db.commit()
+
+if __name__ == '__main__':
+  def usage():
+    print 'Usage:', sys.argv[0], '[-h (help)] [--export-sqlite] [-d <resultsdir (default: .)>]'
+
+  resultsdir = '.'
+  export_sqlite = False
+
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], "hd:", [ 'export-sqlite' ])
+  except getopt.GetoptError, e:
+    print e
+    usage()
+    sys.exit(1)
+  for o, a in opts:
+    if o == '-h':
+      usage()
+      sys.exit()
+    if o == '-d':
+      resultsdir = a
+    if o == '--export-sqlite':
+      export_sqlite = True
+  if args:
+    usage()
+    sys.exit(1)
+
+  stats = SniperStatsColumnar(os.path.join(resultsdir, 'sim.stats.sqlite3'), os.path.join(resultsdir, 'sim.stats.columnar'))
+  if export_sqlite:
+    stats.export_sqlite()
+    print 'Exported %d snapshots to %s' % (len(stats.offsets), os.path.join(resultsdir, 'sim.stats.sqlite3'))
+  else:
+    print stats.get_snapshots()
+    print stats.read_snapshot('roi-end')